@@ -17,7 +17,9 @@
 #define DBHANDLER_H
 
 #include <pqxx/pqxx>
+#include <set>
 #include <string>
+#include <vector>
 //#include "../HeaderFiles/Declarations.h"
 #include "../HeaderFiles/Functions.h"
 
@@ -41,6 +43,8 @@ namespace DB
 			virtual int connect(void);
 			virtual int disconnect(void);
 			virtual result querry(string p_sqlQuerry);
+			// prepares p_sqlQuerry under p_name on its first use and executes it with the arguments ($1, $2, ...)
+			virtual result executePrepared(string p_name, string p_sqlQuerry, const vector<string>& p_arguments);
 			virtual size_t sizeForQuerry(string p_sqlQuerry);
 			virtual void commit(void);
 			
@@ -61,6 +65,7 @@ namespace DB
 			string m_db_port;
 			shared_ptr<connection> m_connection;
 			work m_work;
+			set<string> m_preparedStatements;
 		private:
 			static DBHandler* m_instance;
 			DBHandler(DB::FUNCTIONS::DBConfigData l_dbconfig);
@@ -132,6 +132,39 @@ namespace DB
 			       return l_result;
 		       }
 		       
+		       pqxx::result DBHandler::executePrepared(string p_name, string p_sqlQuerry, const vector<string>& p_arguments)
+		       {
+			       result l_result;
+			       
+			       try
+			       {
+				       if( !m_connection->is_open() )
+				       {
+					       connect();
+				       }
+				       
+				       if( m_preparedStatements.count(p_name) == 0 )
+				       {
+					       m_connection->prepare(p_name, p_sqlQuerry);
+					       m_preparedStatements.insert(p_name);
+				       }
+				       
+				       prepare::invocation l_invocation = m_work.prepared(p_name);
+				       for(const string& l_argument : p_arguments)
+				       {
+					       l_invocation(l_argument);
+				       }
+				       l_result = l_invocation.exec();
+			       }
+			       catch(const exception &e)
+			       {
+				       cerr << e.what() << endl;
+				       return result();
+			       }
+			       
+			       return l_result;
+		       }
+		       
 		       size_t DBHandler::sizeForQuerry(string p_sqlQuerry)
 		       {
 			       return querry(p_sqlQuerry).size();
@@ -14,13 +14,15 @@
  */
 
 #include "JPetBarrelSlot.h"
+#include "../JPetParamBank/JPetParamBank.h"
 
 JPetBarrelSlot::JPetBarrelSlot():
   fId(-1),
   fIsActive(false),
   fName(""),
   fTheta(-1.f),
-  fInFrameID(-1)
+  fInFrameID(-1),
+  fLayerID(-1)
 {
   SetName("JPetBarrelSlot");
 }
@@ -31,9 +33,15 @@ JPetBarrelSlot::JPetBarrelSlot(int id, bool isActive, std::string name, float th
   fIsActive(isActive),
   fName(name),
   fTheta(theta),
-  fInFrameID(inFrameID)
+  fInFrameID(inFrameID),
+  fLayerID(-1)
 {
   SetName("JPetBarrelSlot");
 }
 
+const JPetLayer & JPetBarrelSlot::getLayer() const
+{
+  return JPetParamBank::resolve<JPetLayer>(fLayerID, fTRefLayer);
+}
+
 ClassImp(JPetBarrelSlot);
@@ -40,11 +40,12 @@ public:
   inline bool isActive() const { return fIsActive; }
   inline std::string getName() const { return fName; }
   inline int getInFrameID() const {return fInFrameID; }
-  inline const JPetLayer & getLayer() const { return static_cast<JPetLayer&>(*(fTRefLayer.GetObject())); }
+  const JPetLayer & getLayer() const;
   
   void setLayer(JPetLayer &p_layer)
   {
     fTRefLayer = &p_layer;
+    fLayerID = p_layer.getId();
   }
 
 private:
@@ -54,14 +55,16 @@ private:
   float fTheta;
   int fInFrameID;
   TRef fTRefLayer;
+  int fLayerID; ///< id of the referenced layer, resolved by JPetParamBank::resolve(), -1 if unset
   
 protected:
   void clearTRefLayer()
   {
     fTRefLayer = NULL;
+    fLayerID = -1;
   }
 
-  ClassDef(JPetBarrelSlot, 3);
+  ClassDef(JPetBarrelSlot, 4);
 };
 
 #endif
@@ -14,13 +14,22 @@
  */
 
 #include "./JPetBaseSignal.h"
+#include "../JPetParamBank/JPetParamBank.h"
 
 ClassImp(JPetBaseSignal);
 
 JPetBaseSignal::JPetBaseSignal() :
     TNamed("JPetBaseSignal", "Base Signal structure"), fPM(0), fBarrelSlot(0),
-    fTimeWindowIndex(0) {
+    fPMID(-1), fBarrelSlotID(-1), fTimeWindowIndex(0) {
 }
 
 JPetBaseSignal::~JPetBaseSignal() {
 }
+
+const JPetPM & JPetBaseSignal::getPM() const {
+  return JPetParamBank::resolve<JPetPM>(fPMID, fPM);
+}
+
+const JPetBarrelSlot & JPetBaseSignal::getBarrelSlot() const {
+  return JPetParamBank::resolve<JPetBarrelSlot>(fBarrelSlotID, fBarrelSlot);
+}
@@ -50,36 +50,37 @@ public:
 
   inline void setPM(const JPetPM & pm) {
     fPM = const_cast<JPetPM*>(&pm);
+    fPMID = pm.getID();
   }
 
   inline void setBarrelSlot(const JPetBarrelSlot & bs) {
     fBarrelSlot = const_cast<JPetBarrelSlot*>(&bs);
+    fBarrelSlotID = bs.getID();
   }
 
   /**
    * @brief Obtain a reference to the PhotoMultiplier parametric object related to this signal
    *
    */
-  inline const JPetPM & getPM() const {
-    return (JPetPM&) *fPM.GetObject();
-  }
+  const JPetPM & getPM() const;
 
   /**
    * @brief Obtain a reference to the BarrelSlot parametric object related to this signal
    *
    */
-  inline const JPetBarrelSlot & getBarrelSlot() const {
-    return (JPetBarrelSlot&) *fBarrelSlot.GetObject();
-  }
+  const JPetBarrelSlot & getBarrelSlot() const;
 
 private:
   // references to parametric objects
   TRef fPM; ///< Photomultiplier which recorded this signal
   TRef fBarrelSlot; ///< BarrelSlot containing the PM which recorded this signal
+  // ids of the referenced objects, looked up in the active JPetParamBank, -1 if unset or read from an older file
+  int fPMID;
+  int fBarrelSlotID;
 
   unsigned int fTimeWindowIndex; // index of original TSlot
 
-ClassDef(JPetBaseSignal, 1)
+ClassDef(JPetBaseSignal, 2)
   ;
 };
 #endif /*  !JPETBASESIGNAL_H */
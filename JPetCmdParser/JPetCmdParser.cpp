@@ -32,8 +32,22 @@ JPetCmdParser::JPetCmdParser(): fOptionsDescriptions("Allowed options")
   ("param,p", po::value<std::string>(), "xml file with TRB settings used by the unpacker program.")
   ("runId,i", po::value<int>(), "Run id.")
   ("progressBar,b", "Progress bar.")
-  ("localDB,l", po::value<std::string>(), "The file to use as the parameter database.")
-  ("localDBCreate,L", po::value<std::string>(), "File name to which the parameter database will be saved.");
+  ("localDB,l", po::value<std::string>(), "The file to use as the parameter database, json or a binary snapshot.")
+  ("localDBCreate,L", po::value<std::string>(), "File name to which the parameter database will be saved, as a binary snapshot if it ends with .bin.")
+  ("paramCache", po::value<std::string>(), "Directory in which the parameter banks read from a local file are kept between the runs of the program.")
+  ("unpackerThreads", po::value<int>(), "Number of threads used to unpack the hld file.")
+  ("unpackerIntermediateFiles", "Keep the intermediate .raw.root and .times.root files of the unpacker for debugging.")
+  ("readCacheSize", po::value<int>(), "Size of the read cache of the input file in MB, 0 disables it (default 30).")
+  ("readAsyncPrefetching", "Prefetch the input file in a background thread.")
+  ("taskThreads", po::value<int>(), "Number of threads processing the events of a file, used by the tasks which support it.")
+  ("fileThreads", po::value<int>(), "Number of input files processed at the same time (default 1).")
+  ("streamTasks", "Pass the output of every task directly to the next one, the tasks run at the same time in separate threads.")
+  ("persistentOutputs", po::value< std::vector<std::string> >()->multitoken(), "Output file types saved in the streaming mode besides the output of the last task, e.g. phys.sig hits.")
+  ("asyncWriter", "Fill the output tree in a separate I/O thread.")
+  ("compressionAlgorithm", po::value<int>(), "Compression algorithm of the output file: 0 - ROOT default, 1 - zlib, 2 - lzma, 3 - old zlib format.")
+  ("compressionLevel", po::value<int>(), "Compression level of the output file: 0 (no compression) - 9 (default 1).")
+  ("basketSize", po::value<int>(), "Basket size of the output tree in bytes (default 32000).")
+  ("autoSave", po::value<int>(), "Number of entries between the AutoSaves of the output tree (default 10000).");
 }
 
 JPetCmdParser::~JPetCmdParser()
@@ -119,6 +133,72 @@ bool JPetCmdParser::areCorrectOptions(const po::variables_map& variablesMap) con
     }
   }
 
+  if (isUnpackerThreadsSet(variablesMap)) {
+    if (getUnpackerThreads(variablesMap) < 1) {
+      ERROR("Wrong number of unpacker threads.");
+      std::cerr << "Wrong number of unpacker threads: " << getUnpackerThreads(variablesMap) << std::endl;
+      return false;
+    }
+  }
+
+  if (isReadCacheSizeSet(variablesMap)) {
+    if (getReadCacheSize(variablesMap) < 0) {
+      ERROR("Wrong size of the read cache.");
+      std::cerr << "Wrong size of the read cache: " << getReadCacheSize(variablesMap) << std::endl;
+      return false;
+    }
+  }
+
+  if (isTaskThreadsSet(variablesMap)) {
+    if (getTaskThreads(variablesMap) < 1) {
+      ERROR("Wrong number of task threads.");
+      std::cerr << "Wrong number of task threads: " << getTaskThreads(variablesMap) << std::endl;
+      return false;
+    }
+  }
+
+  if (isFileThreadsSet(variablesMap)) {
+    if (getFileThreads(variablesMap) < 1) {
+      ERROR("Wrong number of file threads.");
+      std::cerr << "Wrong number of file threads: " << getFileThreads(variablesMap) << std::endl;
+      return false;
+    }
+  }
+
+  if (isCompressionAlgorithmSet(variablesMap)) {
+    int algorithm = getCompressionAlgorithm(variablesMap);
+    if (algorithm < 0 || algorithm > 3) {
+      ERROR("Wrong compression algorithm.");
+      std::cerr << "Wrong compression algorithm: " << algorithm << std::endl;
+      return false;
+    }
+  }
+
+  if (isCompressionLevelSet(variablesMap)) {
+    int level = getCompressionLevel(variablesMap);
+    if (level < 0 || level > 9) {
+      ERROR("Wrong compression level.");
+      std::cerr << "Wrong compression level: " << level << std::endl;
+      return false;
+    }
+  }
+
+  if (isBasketSizeSet(variablesMap)) {
+    if (getBasketSize(variablesMap) <= 0) {
+      ERROR("Wrong basket size.");
+      std::cerr << "Wrong basket size: " << getBasketSize(variablesMap) << std::endl;
+      return false;
+    }
+  }
+
+  if (isAutoSaveSet(variablesMap)) {
+    if (getAutoSave(variablesMap) <= 0) {
+      ERROR("Wrong number of entries between the AutoSaves.");
+      std::cerr << "Wrong number of entries between the AutoSaves: " << getAutoSave(variablesMap) << std::endl;
+      return false;
+    }
+  }
+
   std::vector<std::string> fileNames(variablesMap["file"].as< std::vector<std::string> >());
   for (unsigned int i = 0; i < fileNames.size(); i++) {
     if ( ! JPetCommonTools::ifFileExisting(fileNames[i]) ) {
@@ -171,6 +251,52 @@ std::vector<JPetOptions> JPetCmdParser::generateOptions(const po::variables_map&
   if (isLocalDBCreateSet(optsMap)) {
     options["localDBCreate"] = getLocalDBCreateName(optsMap);
   }
+  if (isParamCacheSet(optsMap)) {
+    options["paramCache"] = getParamCache(optsMap);
+  }
+  if (isUnpackerThreadsSet(optsMap)) {
+    options["unpackerThreads"] = std::to_string(getUnpackerThreads(optsMap));
+  }
+  if (isUnpackerIntermediateFilesSet(optsMap)) {
+    options["unpackerIntermediateFiles"] = "true";
+  }
+  if (isReadCacheSizeSet(optsMap)) {
+    options["readCacheSize"] = std::to_string(getReadCacheSize(optsMap));
+  }
+  if (isReadAsyncPrefetchingSet(optsMap)) {
+    options["readAsyncPrefetching"] = "true";
+  }
+  if (isTaskThreadsSet(optsMap)) {
+    options["taskThreads"] = std::to_string(getTaskThreads(optsMap));
+  }
+  if (isFileThreadsSet(optsMap)) {
+    options["fileThreads"] = std::to_string(getFileThreads(optsMap));
+  }
+  if (isStreamTasksSet(optsMap)) {
+    options["streamTasks"] = "true";
+  }
+  if (isPersistentOutputsSet(optsMap)) {
+    std::string outputs;
+    for (const auto& output : getPersistentOutputs(optsMap)) {
+      outputs += (outputs.empty() ? "" : " ") + output;
+    }
+    options["persistentOutputs"] = outputs;
+  }
+  if (isAsyncWriterSet(optsMap)) {
+    options["asyncWriter"] = "true";
+  }
+  if (isCompressionAlgorithmSet(optsMap)) {
+    options["compressionAlgorithm"] = std::to_string(getCompressionAlgorithm(optsMap));
+  }
+  if (isCompressionLevelSet(optsMap)) {
+    options["compressionLevel"] = std::to_string(getCompressionLevel(optsMap));
+  }
+  if (isBasketSizeSet(optsMap)) {
+    options["basketSize"] = std::to_string(getBasketSize(optsMap));
+  }
+  if (isAutoSaveSet(optsMap)) {
+    options["autoSave"] = std::to_string(getAutoSave(optsMap));
+  }
   auto firstEvent  = getLowerEventBound(optsMap);
   auto lastEvent  = getHigherEventBound(optsMap);
   if (firstEvent >= 0) options.at("firstEvent") = std::to_string(firstEvent);
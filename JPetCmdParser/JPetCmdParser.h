@@ -101,6 +101,92 @@ public:
     return variablesMap["localDBCreate"].as<std::string>();
   }
 
+  static inline bool isParamCacheSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("paramCache") > 0;
+  }
+  static inline std::string getParamCache(const po::variables_map& variablesMap) {
+    return variablesMap["paramCache"].as<std::string>();
+  }
+
+  static inline bool isUnpackerThreadsSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("unpackerThreads") > 0;
+  }
+  static inline int getUnpackerThreads(const po::variables_map& variablesMap) {
+    return variablesMap["unpackerThreads"].as<int>();
+  }
+
+  static inline bool isUnpackerIntermediateFilesSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("unpackerIntermediateFiles") > 0;
+  }
+
+  static inline bool isReadCacheSizeSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("readCacheSize") > 0;
+  }
+  static inline int getReadCacheSize(const po::variables_map& variablesMap) {
+    return variablesMap["readCacheSize"].as<int>();
+  }
+
+  static inline bool isReadAsyncPrefetchingSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("readAsyncPrefetching") > 0;
+  }
+
+  static inline bool isTaskThreadsSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("taskThreads") > 0;
+  }
+  static inline int getTaskThreads(const po::variables_map& variablesMap) {
+    return variablesMap["taskThreads"].as<int>();
+  }
+
+  static inline bool isFileThreadsSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("fileThreads") > 0;
+  }
+  static inline int getFileThreads(const po::variables_map& variablesMap) {
+    return variablesMap["fileThreads"].as<int>();
+  }
+
+  static inline bool isStreamTasksSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("streamTasks") > 0;
+  }
+
+  static inline bool isPersistentOutputsSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("persistentOutputs") > 0;
+  }
+  static inline std::vector<std::string> getPersistentOutputs(const po::variables_map& variablesMap) {
+    return variablesMap["persistentOutputs"].as< std::vector<std::string> >();
+  }
+
+  static inline bool isAsyncWriterSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("asyncWriter") > 0;
+  }
+
+  static inline bool isCompressionAlgorithmSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("compressionAlgorithm") > 0;
+  }
+  static inline int getCompressionAlgorithm(const po::variables_map& variablesMap) {
+    return variablesMap["compressionAlgorithm"].as<int>();
+  }
+
+  static inline bool isCompressionLevelSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("compressionLevel") > 0;
+  }
+  static inline int getCompressionLevel(const po::variables_map& variablesMap) {
+    return variablesMap["compressionLevel"].as<int>();
+  }
+
+  static inline bool isBasketSizeSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("basketSize") > 0;
+  }
+  static inline int getBasketSize(const po::variables_map& variablesMap) {
+    return variablesMap["basketSize"].as<int>();
+  }
+
+  static inline bool isAutoSaveSet(const po::variables_map& variablesMap) {
+    return variablesMap.count("autoSave") > 0;
+  }
+  static inline int getAutoSave(const po::variables_map& variablesMap) {
+    return variablesMap["autoSave"].as<int>();
+  }
+
 protected:
   po::options_description fOptionsDescriptions;
 
@@ -186,6 +186,204 @@ BOOST_AUTO_TEST_CASE(localDBTest)
   BOOST_REQUIRE(JPetCmdParser::getLocalDBCreateName(variablesMap) == std::string("output.json"));
 }
 
+BOOST_AUTO_TEST_CASE(paramCacheTest)
+{
+  auto commandLine = "main.x -l input.json -i 8 --paramCache cache/params";
+  auto args_char = createArgs(commandLine);
+  auto argc = args_char.size();
+  auto argv = args_char.data();
+
+  po::options_description description("Allowed options");
+  description.add_options()
+  ("localDB,l", po::value<std::string>(), "The file to use as the parameter database.")
+  ("runId,i", po::value<int>(), "Run id.")
+  ("paramCache", po::value<std::string>(), "Directory of the cached parameter banks.")
+  ;
+
+  po::variables_map variablesMap;
+  po::store(po::parse_command_line(argc, argv, description), variablesMap);
+  po::notify(variablesMap);
+
+  BOOST_REQUIRE(JPetCmdParser::isParamCacheSet(variablesMap));
+  BOOST_REQUIRE(JPetCmdParser::getParamCache(variablesMap) == std::string("cache/params"));
+
+  JPetOptions options;
+  BOOST_REQUIRE(options.isParamCache() == false);
+  BOOST_REQUIRE(options.getParamCache() == std::string(""));
+}
+
+BOOST_AUTO_TEST_CASE(unpackerThreadsTest)
+{
+  auto commandLine = "main.x --unpackerThreads 4";
+  auto args_char = createArgs(commandLine);
+  auto argc = args_char.size();
+  auto argv = args_char.data();
+
+  po::options_description description("Allowed options");
+  description.add_options()
+  ("unpackerThreads", po::value<int>(), "Number of threads used to unpack the hld file.")
+  ;
+
+  po::variables_map variablesMap;
+  po::store(po::parse_command_line(argc, argv, description), variablesMap);
+  po::notify(variablesMap);
+
+  BOOST_REQUIRE(JPetCmdParser::isUnpackerThreadsSet(variablesMap) == true);
+  BOOST_REQUIRE(JPetCmdParser::getUnpackerThreads(variablesMap) == 4);
+
+  JPetOptions options;
+  BOOST_REQUIRE(options.getUnpackerThreads() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(taskThreadsTest)
+{
+  auto commandLine = "main.x --taskThreads 8";
+  auto args_char = createArgs(commandLine);
+  auto argc = args_char.size();
+  auto argv = args_char.data();
+
+  po::options_description description("Allowed options");
+  description.add_options()
+  ("taskThreads", po::value<int>(), "Number of threads processing the events of a file.")
+  ;
+
+  po::variables_map variablesMap;
+  po::store(po::parse_command_line(argc, argv, description), variablesMap);
+  po::notify(variablesMap);
+
+  BOOST_REQUIRE(JPetCmdParser::isTaskThreadsSet(variablesMap));
+  BOOST_REQUIRE_EQUAL(JPetCmdParser::getTaskThreads(variablesMap), 8);
+
+  JPetOptions options;
+  BOOST_REQUIRE_EQUAL(options.getTaskThreads(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(fileThreadsTest)
+{
+  auto commandLine = "main.x --fileThreads 16";
+  auto args_char = createArgs(commandLine);
+  auto argc = args_char.size();
+  auto argv = args_char.data();
+
+  po::options_description description("Allowed options");
+  description.add_options()
+  ("fileThreads", po::value<int>(), "Number of input files processed at the same time.")
+  ;
+
+  po::variables_map variablesMap;
+  po::store(po::parse_command_line(argc, argv, description), variablesMap);
+  po::notify(variablesMap);
+
+  BOOST_REQUIRE(JPetCmdParser::isFileThreadsSet(variablesMap));
+  BOOST_REQUIRE_EQUAL(JPetCmdParser::getFileThreads(variablesMap), 16);
+
+  JPetOptions options;
+  BOOST_REQUIRE_EQUAL(options.getFileThreads(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(streamTasksTest)
+{
+  auto commandLine = "main.x --streamTasks --persistentOutputs phys.sig hits";
+  auto args_char = createArgs(commandLine);
+  auto argc = args_char.size();
+  auto argv = args_char.data();
+
+  po::options_description description("Allowed options");
+  description.add_options()
+  ("streamTasks", "Pass the output of every task directly to the next one.")
+  ("persistentOutputs", po::value< std::vector<std::string> >()->multitoken(), "Output file types saved in the streaming mode.")
+  ;
+
+  po::variables_map variablesMap;
+  po::store(po::parse_command_line(argc, argv, description), variablesMap);
+  po::notify(variablesMap);
+
+  BOOST_REQUIRE(JPetCmdParser::isStreamTasksSet(variablesMap));
+  BOOST_REQUIRE(JPetCmdParser::isPersistentOutputsSet(variablesMap));
+  auto outputs = JPetCmdParser::getPersistentOutputs(variablesMap);
+  BOOST_REQUIRE_EQUAL(outputs.size(), 2u);
+  BOOST_REQUIRE_EQUAL(outputs[0], "phys.sig");
+  BOOST_REQUIRE_EQUAL(outputs[1], "hits");
+
+  JPetOptions::Options opts = JPetOptions::getDefaultOptions();
+  opts["streamTasks"] = "true";
+  opts["persistentOutputs"] = "phys.sig hits";
+  JPetOptions options(opts);
+  BOOST_REQUIRE(options.isStreamTasks());
+  BOOST_REQUIRE(options.isPersistentOutput("hits"));
+  BOOST_REQUIRE(!options.isPersistentOutput("reco.sig"));
+  BOOST_REQUIRE(!JPetOptions().isStreamTasks());
+}
+
+
+BOOST_AUTO_TEST_CASE(readCacheTest)
+{
+  auto commandLine = "main.x --readCacheSize 100 --readAsyncPrefetching";
+  auto args_char = createArgs(commandLine);
+  auto argc = args_char.size();
+  auto argv = args_char.data();
+
+  po::options_description description("Allowed options");
+  description.add_options()
+  ("readCacheSize", po::value<int>(), "Size of the read cache of the input file in MB.")
+  ("readAsyncPrefetching", "Prefetch the input file in a background thread.")
+  ;
+
+  po::variables_map variablesMap;
+  po::store(po::parse_command_line(argc, argv, description), variablesMap);
+  po::notify(variablesMap);
+
+  BOOST_REQUIRE(JPetCmdParser::isReadCacheSizeSet(variablesMap) == true);
+  BOOST_REQUIRE(JPetCmdParser::getReadCacheSize(variablesMap) == 100);
+  BOOST_REQUIRE(JPetCmdParser::isReadAsyncPrefetchingSet(variablesMap) == true);
+
+  JPetOptions options;
+  BOOST_REQUIRE(options.getReadCacheSize() == JPetOptions::kDefaultReadCacheSize);
+  BOOST_REQUIRE(!options.isReadAsyncPrefetching());
+
+  JPetOptions::Options opts = JPetOptions::getDefaultOptions();
+  opts["readCacheSize"] = "100";
+  opts["readAsyncPrefetching"] = "true";
+  JPetOptions optionsWithCache(opts);
+  BOOST_REQUIRE(optionsWithCache.getReadCacheSize() == 100ll * 1024 * 1024);
+  BOOST_REQUIRE(optionsWithCache.isReadAsyncPrefetching());
+}
+
+
+BOOST_AUTO_TEST_CASE(writerSettingsTest)
+{
+  auto commandLine = "main.x --asyncWriter --compressionAlgorithm 2 --compressionLevel 4 --basketSize 64000 --autoSave 500";
+  auto args_char = createArgs(commandLine);
+  auto argc = args_char.size();
+  auto argv = args_char.data();
+
+  po::options_description description("Allowed options");
+  description.add_options()
+  ("asyncWriter", "Fill the output tree in a separate I/O thread.")
+  ("compressionAlgorithm", po::value<int>(), "Compression algorithm of the output file.")
+  ("compressionLevel", po::value<int>(), "Compression level of the output file.")
+  ("basketSize", po::value<int>(), "Basket size of the output tree in bytes.")
+  ("autoSave", po::value<int>(), "Number of entries between the AutoSaves of the output tree.")
+  ;
+
+  po::variables_map variablesMap;
+  po::store(po::parse_command_line(argc, argv, description), variablesMap);
+  po::notify(variablesMap);
+
+  BOOST_REQUIRE(JPetCmdParser::isAsyncWriterSet(variablesMap));
+  BOOST_REQUIRE_EQUAL(JPetCmdParser::getCompressionAlgorithm(variablesMap), 2);
+  BOOST_REQUIRE_EQUAL(JPetCmdParser::getCompressionLevel(variablesMap), 4);
+  BOOST_REQUIRE_EQUAL(JPetCmdParser::getBasketSize(variablesMap), 64000);
+  BOOST_REQUIRE_EQUAL(JPetCmdParser::getAutoSave(variablesMap), 500);
+
+  JPetOptions options;
+  BOOST_REQUIRE(!options.isAsyncWriter());
+  BOOST_REQUIRE_EQUAL(options.getCompressionAlgorithm(), -1);
+  BOOST_REQUIRE_EQUAL(options.getCompressionLevel(), -1);
+  BOOST_REQUIRE_EQUAL(options.getBasketSize(), -1);
+  BOOST_REQUIRE_EQUAL(options.getAutoSave(), -1);
+}
+
 
 BOOST_AUTO_TEST_CASE(generateOptionsTest)
 {
@@ -15,9 +15,10 @@
 
 #include "./JPetDBParamGetter.h"
 #include <boost/lexical_cast.hpp>
-#include <TThread.h>
 #include "../DBHandler/HeaderFiles/DBHandler.h"
 #include <cstdint>
+#include <memory>
+#include <mutex>
 
 const std::map<ParamObjectType, std::map<std::string, std::string>> fieldTranslations{
   {ParamObjectType::kScintillator,
@@ -163,16 +164,39 @@ const std::map<ParamObjectType, std::map<ParamObjectType, std::string>> dbRelati
     },
 };
 
-std::map<int, std::map<ParamObjectType, ParamObjectsDescriptions>> JPetDBParamGetter::gBasicDataCache;
-std::map<int, std::map<ParamObjectType, std::map<ParamObjectType, ParamRelationalData>>> JPetDBParamGetter::gRelationalDataCache;
+namespace
+{
+/// The data of one run, loaded from the database once and shared by all the getters
+struct RunCache {
+  /// Held while the data of the run is loaded, so that the files of the same run
+  /// processed in parallel query the database only once. Other runs are not blocked.
+  std::mutex fMutex;
+  std::map<ParamObjectType, ParamObjectsDescriptions> fBasicData;
+  std::map<ParamObjectType, std::map<ParamObjectType, ParamRelationalData>> fRelationalData;
+};
+
+/// Guards gRunCaches only, it is released before the database is queried
+std::mutex gCacheMutex;
+std::map<int, std::shared_ptr<RunCache>> gRunCaches;
+/// The connection of DBHandler is shared, one query is sent at a time
+std::mutex gDBMutex;
+
+std::shared_ptr<RunCache> getRunCache(const int runId)
+{
+  std::lock_guard<std::mutex> lock(gCacheMutex);
+  auto & runCache = gRunCaches[runId];
+  if (!runCache) {
+    runCache = std::make_shared<RunCache>();
+  }
+  return runCache;
+}
+}
 
 void JPetDBParamGetter::clearParamCache()
 {
-  TThread::Lock();
+  std::lock_guard<std::mutex> lock(gCacheMutex);
   WARNING("JPetDBParamGetter cached data will be cleared");
-  JPetDBParamGetter::gBasicDataCache.clear();
-  JPetDBParamGetter::gRelationalDataCache.clear();
-  TThread::UnLock();
+  gRunCaches.clear();
 }
 
 ParamObjectsDescriptions JPetDBParamGetter::getAllBasicData(ParamObjectType type, const int runId)
@@ -181,11 +205,17 @@ ParamObjectsDescriptions JPetDBParamGetter::getAllBasicData(ParamObjectType type
     ERROR("Run number is less than 0!");
     return ParamObjectsDescriptions();
   }
-  auto & thisCache = gBasicDataCache[runId][type];
+  auto runCache = getRunCache(runId);
+  std::lock_guard<std::mutex> lock(runCache->fMutex);
+  return loadBasicData(runCache->fBasicData[type], type, runId);
+}
+
+/// Fills thisCache if it is empty, the lock of the run must be held
+const ParamObjectsDescriptions& JPetDBParamGetter::loadBasicData(ParamObjectsDescriptions & thisCache, ParamObjectType type, const int runId)
+{
   if (thisCache.size() == 0) {
-    TThread::Lock();
     std::string runIdS = boost::lexical_cast<std::string>(runId);
-    auto dbResult = getDataFromDB(dbFunctionName.at(type), runIdS);
+    auto dbResult = getDataFromDB(dbFunctionName.at(type), {runIdS});
     if (dbResult.size() == 0) {
       printErrorMessageDB(dbFunctionName.at(type), runId);
       return thisCache;
@@ -220,75 +250,90 @@ ParamObjectsDescriptions JPetDBParamGetter::getAllBasicData(ParamObjectType type
       }
       thisCache[boost::lexical_cast<int>(description["id"])] = description;
     }
-    TThread::UnLock();
   }
   return thisCache;
 }
 
+/**
+ * The relations of all the objects of type1 are loaded with one query: the database
+ * relation function is called for every id of the array passed as the first argument.
+ * The TOMB channels carry their relations in the basic data.
+ */
 ParamRelationalData JPetDBParamGetter::getAllRelationalData(ParamObjectType type1, ParamObjectType type2, const int runId)
 {
   if (runId < 0) {
     ERROR("Run number is less than 0!");
     return ParamRelationalData();
   }
-  auto & thisCache = gRelationalDataCache[runId][type1][type2];
+  auto runCache = getRunCache(runId);
+  std::lock_guard<std::mutex> lock(runCache->fMutex);
+  auto & thisCache = runCache->fRelationalData[type1][type2];
   if (thisCache.size() == 0) {
-    TThread::Lock();
-    std::string runIdS = boost::lexical_cast<std::string>(runId);
-    auto dbResult = getDataFromDB(dbFunctionName.at(type1), runIdS);
-    if (dbResult.size() == 0) {
-      printErrorMessageDB(dbFunctionName.at(type1), runId);
+    const auto & descriptions = loadBasicData(runCache->fBasicData[type1], type1, runId);
+    if (descriptions.size() == 0) {
       return thisCache;
     }
-    for (auto row : dbResult) {
-      ParamObjectDescription description;
-      for (auto & translation : fieldTranslations.at(type1)) {
-        description[translation.second] = row[translation.first].as<std::string>();
+    if (type1 == ParamObjectType::kTOMBChannel) {
+      std::string fieldName;
+      switch (type2) {
+        case ParamObjectType::kTRB:
+          fieldName = "trb_id";
+          break;
+        case ParamObjectType::kFEB:
+          fieldName = "konradboard_id";
+          break;
+        case ParamObjectType::kPM:
+          fieldName = "photomultiplier_id";
+          break;
+        default:
+          return thisCache;
       }
-      if (type1 == ParamObjectType::kTOMBChannel) {
-        description["channel"] = boost::lexical_cast<std::string>(JPetParamGetter::getTOMBChannelFromDescription(description["channel"]));
-        //The id field is needed for caching
-        description["id"] = description["channel"];
-        switch (type2) {
-          case ParamObjectType::kTRB:
-            thisCache[boost::lexical_cast<int>(description["id"])] = boost::lexical_cast<int>(description["trb_id"]);
-            break;
-          case ParamObjectType::kFEB:
-            thisCache[boost::lexical_cast<int>(description["id"])] = boost::lexical_cast<int>(description["konradboard_id"]);
-            break;
-          case ParamObjectType::kPM:
-            thisCache[boost::lexical_cast<int>(description["id"])] = boost::lexical_cast<int>(description["photomultiplier_id"]);
-            break;
-          default:
-            break;
-        }
-      } else {
-        auto dbRelationResult = getDataFromDB(dbRelationFunctionName.at(type1).at(type2), description["id"] + "," + runIdS);
-        for (auto relationRow : dbRelationResult) {
-          thisCache[boost::lexical_cast<int>(description["id"])] = relationRow[dbRelationFieldName.at(type1).at(type2)].as<int>();
-        }
+      for (const auto & description : descriptions) {
+        thisCache[description.first] = boost::lexical_cast<int>(description.second.at(fieldName));
+      }
+    } else {
+      std::string ids;
+      for (const auto & description : descriptions) {
+        ids += (ids.empty() ? "" : ",") + boost::lexical_cast<std::string>(description.first);
+      }
+      const std::string & sqlFunction = dbRelationFunctionName.at(type1).at(type2);
+      std::string sqlQuerry = "SELECT ids.id AS object_id, relation." + dbRelationFieldName.at(type1).at(type2)
+                              + " AS other_id FROM unnest($1::integer[]) AS ids(id), LATERAL "
+                              + sqlFunction + "(ids.id, $2) AS relation;";
+      pqxx::result dbRelationResult;
+      {
+        std::lock_guard<std::mutex> dbLock(gDBMutex);
+        DB::SERVICES::DBHandler& l_dbHandlerInstance = DB::SERVICES::DBHandler::getInstance();
+        dbRelationResult = l_dbHandlerInstance.executePrepared("relation_" + sqlFunction, sqlQuerry,
+                           {"{" + ids + "}", boost::lexical_cast<std::string>(runId)});
+      }
+      for (auto relationRow : dbRelationResult) {
+        thisCache[relationRow["object_id"].as<int>()] = relationRow["other_id"].as<int>();
       }
     }
-    TThread::UnLock();
   }
   return thisCache;
 }
 
-std::string JPetDBParamGetter::generateSelectQuery(const std::string& sqlFun, const std::string& arguments)
+std::string JPetDBParamGetter::generateSelectQuery(const std::string& sqlFun, int nArguments)
 {
   std::string sqlQuerry = "SELECT * FROM ";
   sqlQuerry += sqlFun;
-  sqlQuerry += "(" + arguments + ");";
+  sqlQuerry += "(";
+  for (int i = 1; i <= nArguments; i++) {
+    sqlQuerry += (i > 1 ? ",$" : "$") + boost::lexical_cast<std::string>(i);
+  }
+  sqlQuerry += ");";
   return sqlQuerry;
 }
 
-/// @brief method calls the remote PostgreSQL function sqlfunction with the id argument and returns results from database
-pqxx::result JPetDBParamGetter::getDataFromDB(const std::string& sqlfunction, const  std::string& arguments)
+/// @brief method calls the remote PostgreSQL function sqlfunction with the arguments and returns results from database
+pqxx::result JPetDBParamGetter::getDataFromDB(const std::string& sqlfunction, const std::vector<std::string>& arguments)
 {
-  //std::string l_run_id = boost::lexical_cast<std::string>(id);
-  std::string l_sqlQuerry = generateSelectQuery(sqlfunction, arguments);
+  std::string l_sqlQuerry = generateSelectQuery(sqlfunction, arguments.size());
+  std::lock_guard<std::mutex> lock(gDBMutex);
   DB::SERVICES::DBHandler& l_dbHandlerInstance = DB::SERVICES::DBHandler::getInstance();
-  return  l_dbHandlerInstance.querry(l_sqlQuerry);
+  return l_dbHandlerInstance.executePrepared(sqlfunction, l_sqlQuerry, arguments);
 }
 
 void JPetDBParamGetter::printErrorMessageDB(std::string sqlFunction, int p_run_id)
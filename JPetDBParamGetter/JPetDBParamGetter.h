@@ -17,6 +17,7 @@
 #define JPETDBPARAMGETTER_H
 
 #include "../JPetParamGetter/JPetParamGetter.h"
+#include <vector>
 #ifndef __CINT__
 #include <pqxx/pqxx>
 #else
@@ -38,11 +39,9 @@ private:
   JPetDBParamGetter(const JPetDBParamGetter &DBParamGetter);
   JPetDBParamGetter& operator=(const JPetDBParamGetter &DBParamGetter);
   
-  pqxx::result getDataFromDB(const std::string& sqlFunction, const std::string& args);
-  std::string generateSelectQuery(const std::string& sqlFunction, const std::string& args);
+  const ParamObjectsDescriptions& loadBasicData(ParamObjectsDescriptions & thisCache, ParamObjectType type, const int runId);
+  pqxx::result getDataFromDB(const std::string& sqlFunction, const std::vector<std::string>& args);
+  std::string generateSelectQuery(const std::string& sqlFunction, int nArguments);
   void printErrorMessageDB(std::string sqlFunction, int p_run_id);
-
-  static std::map<int, std::map<ParamObjectType, ParamObjectsDescriptions>> gBasicDataCache;
-  static std::map<int, std::map<ParamObjectType, std::map<ParamObjectType, ParamRelationalData>>> gRelationalDataCache;
 };
 #endif /*  !JPETDBPARAMGETTER_H */
@@ -4,6 +4,7 @@
 #include "../DBHandler/HeaderFiles/DBHandler.h"
 #include "../JPetDBParamGetter/JPetDBParamGetter.h"
 #include "../JPetParamManager/JPetParamManager.h"
+#include <TStopwatch.h>
 
 const char* gDefaultConfigFile = "../DBConfig/configDB.cfg";
 
@@ -91,4 +92,42 @@ BOOST_AUTO_TEST_CASE(run28Test)
   BOOST_REQUIRE(bank.getTOMBChannelsSize() > 0);
 }
 
+BOOST_AUTO_TEST_CASE(batchedRelationsTest)
+{
+  DB::SERVICES::DBHandler::createDBConnection(gDefaultConfigFile);
+  JPetDBParamGetter::clearParamCache();
+  JPetDBParamGetter paramGetter;
+  int run  = 28;
+  ParamRelationalData relations = paramGetter.getAllRelationalData(ParamObjectType::kPM, ParamObjectType::kFEB, run);
+  ParamObjectsDescriptions pms = paramGetter.getAllBasicData(ParamObjectType::kPM, run);
+  BOOST_REQUIRE(relations.size() > 0);
+
+  // the relations loaded at once are the same as the ones of the separate queries
+  DB::SERVICES::DBHandler& dbHandler = DB::SERVICES::DBHandler::getInstance();
+  for (auto & pm : pms) {
+    pqxx::result single = dbHandler.querry("SELECT * FROM getKonradBoardsForPhotoMultiplier("
+                                           + std::to_string(pm.first) + "," + std::to_string(run) + ");");
+    if (single.size() == 0) {
+      BOOST_REQUIRE(relations.count(pm.first) == 0);
+    } else {
+      BOOST_REQUIRE_EQUAL(relations[pm.first], single[single.size() - 1]["KonradBoard_id"].as<int>());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(paramBankBuildTimeTest)
+{
+  DB::SERVICES::DBHandler::createDBConnection(gDefaultConfigFile);
+  JPetDBParamGetter::clearParamCache();
+  JPetParamManager paramManager(new JPetDBParamGetter());
+  TStopwatch timer;
+  paramManager.fillParameterBank(28);
+  double fromDB = timer.RealTime();
+  timer.Start();
+  paramManager.fillParameterBank(28);
+  double fromCache = timer.RealTime();
+  BOOST_TEST_MESSAGE("Param bank of run 28 built in " << fromDB << " s from the database, " << fromCache << " s from the cache");
+  BOOST_REQUIRE(paramManager.getParamBank().getPMsSize() > 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+/**
+ *  @copyright Copyright 2016 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetEventQueue.cpp
+ */
+
+#include "JPetEventQueue.h"
+#include <TCondition.h>
+#include <TMutex.h>
+#include <TObject.h>
+#include <TThread.h>
+#include "../JPetLoggerInclude.h"
+
+JPetEventQueue::JPetEventQueue(unsigned int maxSize):
+  fMaxSize(maxSize > 0 ? maxSize : 1),
+  fClosed(false),
+  fNbOfPushed(0),
+  fNbOfDropped(0)
+{
+  TThread::Initialize();
+  fMutex = new TMutex();
+  fNotEmpty = new TCondition(fMutex);
+  fNotFull = new TCondition(fMutex);
+}
+
+JPetEventQueue::~JPetEventQueue()
+{
+  for (auto object : fObjects) {
+    delete object;
+  }
+  fObjects.clear();
+  delete fNotFull;
+  delete fNotEmpty;
+  delete fMutex;
+}
+
+void JPetEventQueue::push(TObject* object)
+{
+  fMutex->Lock();
+  while (!fClosed && fObjects.size() >= fMaxSize) {
+    fNotFull->Wait();
+  }
+  if (fClosed) {
+    const bool isFirstDropped = (fNbOfDropped++ == 0);
+    fMutex->UnLock();
+    if (isFirstDropped) {
+      WARNING("The event queue is closed, the objects pushed from now on are dropped");
+    }
+    delete object;
+    return;
+  }
+  fObjects.push_back(object);
+  fNbOfPushed++;
+  fNotEmpty->Signal();
+  fMutex->UnLock();
+}
+
+TObject* JPetEventQueue::pop()
+{
+  fMutex->Lock();
+  while (fObjects.empty() && !fClosed) {
+    fNotEmpty->Wait();
+  }
+  TObject* object = 0;
+  if (!fObjects.empty()) {
+    object = fObjects.front();
+    fObjects.pop_front();
+    fNotFull->Signal();
+  }
+  fMutex->UnLock();
+  return object;
+}
+
+void JPetEventQueue::close()
+{
+  fMutex->Lock();
+  fClosed = true;
+  fNotEmpty->Broadcast();
+  fNotFull->Broadcast();
+  fMutex->UnLock();
+}
+
+bool JPetEventQueue::isClosed() const
+{
+  fMutex->Lock();
+  bool closed = fClosed;
+  fMutex->UnLock();
+  return closed;
+}
+
+long long JPetEventQueue::getNbOfPushed() const
+{
+  fMutex->Lock();
+  long long pushed = fNbOfPushed;
+  fMutex->UnLock();
+  return pushed;
+}
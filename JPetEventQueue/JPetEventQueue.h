@@ -0,0 +1,75 @@
+/**
+ *  @copyright Copyright 2016 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetEventQueue.h
+ */
+
+#ifndef _JPET_EVENT_QUEUE_H_
+#define _JPET_EVENT_QUEUE_H_
+
+#include <deque>
+
+#ifndef __CINT__
+#include <boost/noncopyable.hpp>
+#else
+namespace boost;
+class boost::noncopyable;
+#endif /* __CINT __ */
+
+class TObject;
+class TCondition;
+class TMutex;
+
+/**
+ * @brief Bounded queue passing the output objects of one task to the next one.
+ *
+ * Used by the streaming mode of JPetTaskExecutor: the writer of a task pushes
+ * a copy of every written object and the JPetTaskIO of the next task pops
+ * them in the same order, each task running in its own thread. push() blocks
+ * while the queue is full, so a fast task cannot run ahead of a slow one by
+ * more than the maximal size. After close() pop() returns the remaining objects
+ * and then 0, and push() drops the objects, also the ones waiting for space,
+ * so the next task can close its input queue to stop the previous one.
+ * The queue owns the objects until they are popped.
+ */
+class JPetEventQueue : private boost::noncopyable
+{
+public:
+  static const unsigned int kDefaultMaxSize = 1000;
+
+  explicit JPetEventQueue(unsigned int maxSize = kDefaultMaxSize);
+  ~JPetEventQueue();
+
+  /// Takes the ownership of the object, waits while the queue is full and not closed
+  void push(TObject* object);
+  /// Waits for the next object, returns 0 when the queue is closed and empty. The caller owns the object.
+  TObject* pop();
+  /// Marks the end of the stream, wakes up the waiting pop() and push()
+  void close();
+
+  bool isClosed() const;
+  inline unsigned int getMaxSize() const { return fMaxSize; }
+  /// number of objects pushed since the queue was created
+  long long getNbOfPushed() const;
+
+private:
+  unsigned int fMaxSize;
+  std::deque<TObject*> fObjects;
+  bool fClosed;
+  long long fNbOfPushed;
+  long long fNbOfDropped;
+  TMutex* fMutex;
+  TCondition* fNotEmpty;
+  TCondition* fNotFull;
+};
+
+#endif /* _JPET_EVENT_QUEUE_H_ */
@@ -0,0 +1,97 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE JPetEventQueueTest
+#include <boost/test/unit_test.hpp>
+#include <TNamed.h>
+#include <TSystem.h>
+#include <TThread.h>
+#include "../JPetEventQueue/JPetEventQueue.h"
+
+BOOST_AUTO_TEST_SUITE(FirstSuite)
+
+BOOST_AUTO_TEST_CASE( popReturnsTheObjectsInOrder )
+{
+  JPetEventQueue queue(10);
+  BOOST_REQUIRE_EQUAL(queue.getMaxSize(), 10u);
+  for (int i = 0; i < 5; i++) {
+    queue.push(new TNamed(Form("obj%d", i), ""));
+  }
+  queue.close();
+  BOOST_REQUIRE(queue.isClosed());
+  BOOST_REQUIRE_EQUAL(queue.getNbOfPushed(), 5);
+  for (int i = 0; i < 5; i++) {
+    TObject* obj = queue.pop();
+    BOOST_REQUIRE(obj);
+    BOOST_REQUIRE_EQUAL(std::string(obj->GetName()), std::string(Form("obj%d", i)));
+    delete obj;
+  }
+  BOOST_REQUIRE(!queue.pop());
+}
+
+BOOST_AUTO_TEST_CASE( pushAfterCloseDropsTheObject )
+{
+  JPetEventQueue queue;
+  queue.close();
+  queue.push(new TNamed("obj", ""));
+  BOOST_REQUIRE_EQUAL(queue.getNbOfPushed(), 0);
+  BOOST_REQUIRE(!queue.pop());
+}
+
+namespace
+{
+const int kNumberOfObjects = 10000;
+
+void* pushOne(void* arg)
+{
+  static_cast<JPetEventQueue*>(arg)->push(new TNamed("blocked", ""));
+  return 0;
+}
+
+void* produce(void* arg)
+{
+  JPetEventQueue* queue = static_cast<JPetEventQueue*>(arg);
+  for (int i = 0; i < kNumberOfObjects; i++) {
+    queue->push(new TNamed(Form("obj%d", i), ""));
+  }
+  queue->close();
+  return 0;
+}
+}
+
+BOOST_AUTO_TEST_CASE( smallQueueBetweenTwoThreads )
+{
+  JPetEventQueue queue(3);
+  TThread producer("producer", produce, (void*) &queue);
+  producer.Run();
+  int nPopped = 0;
+  while (TObject* obj = queue.pop()) {
+    BOOST_REQUIRE_EQUAL(std::string(obj->GetName()), std::string(Form("obj%d", nPopped)));
+    delete obj;
+    nPopped++;
+  }
+  producer.Join();
+  BOOST_REQUIRE_EQUAL(nPopped, kNumberOfObjects);
+}
+
+BOOST_AUTO_TEST_CASE( closeWakesUpTheBlockedProducer )
+{
+  JPetEventQueue queue(2);
+  queue.push(new TNamed("obj0", ""));
+  queue.push(new TNamed("obj1", ""));
+  TThread producer("blockedProducer", pushOne, (void*) &queue);
+  producer.Run();
+  // the queue is full, nobody pops, so the producer waits until the queue is closed
+  gSystem->Sleep(100);
+  BOOST_REQUIRE_EQUAL(queue.getNbOfPushed(), 2);
+  queue.close();
+  producer.Join();
+  BOOST_REQUIRE_EQUAL(queue.getNbOfPushed(), 2);
+  for (int i = 0; i < 2; i++) {
+    TObject* obj = queue.pop();
+    BOOST_REQUIRE(obj);
+    BOOST_REQUIRE_EQUAL(std::string(obj->GetName()), std::string(Form("obj%d", i)));
+    delete obj;
+  }
+  BOOST_REQUIRE(!queue.pop());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -14,6 +14,7 @@
  */
 
 #include "JPetFEB.h"
+#include "../JPetParamBank/JPetParamBank.h"
 
 
 ClassImp(JPetFEB);
@@ -44,7 +45,8 @@ JPetFEB::JPetFEB() :
 				      m_version(0),
 				      m_userId(0),
 				      m_n_time_outputs_per_input(0),
-				      m_n_notime_outputs_per_input(0)
+				      m_n_notime_outputs_per_input(0),
+				      fTRBID(-1)
 {
   SetName("JPetFEB");
 }
@@ -56,7 +58,8 @@ JPetFEB::JPetFEB(int id) : m_id(id),
 			   m_version(0),
 			   m_userId(0),
 			   m_n_time_outputs_per_input(0),
-			   m_n_notime_outputs_per_input(0)
+			   m_n_notime_outputs_per_input(0),
+			   fTRBID(-1)
 {
   SetName("JPetFEB");
 }
@@ -76,7 +79,8 @@ JPetFEB::JPetFEB(int p_id,
 				      m_version(p_version),
 				      m_userId(p_userId),
 				      m_n_time_outputs_per_input(p_n_time_outputs_per_input),
-				      m_n_notime_outputs_per_input(p_n_notime_outputs_per_input) 
+				      m_n_notime_outputs_per_input(p_n_notime_outputs_per_input),
+				      fTRBID(-1)
 {
   SetName("JPetFEB");
 }
@@ -85,6 +89,11 @@ JPetFEB::~JPetFEB()
 {
 }
 
+const JPetTRB & JPetFEB::getTRB() const
+{
+  return JPetParamBank::resolve<JPetTRB>(fTRBID, fTRefTRBs);
+}
+
 int JPetFEB::getID() const
 {
   return m_id;
@@ -84,14 +84,12 @@ public:
   virtual int getNtimeOutsPerInput(void) const;
   virtual int getNnotimeOutsPerInput(void) const;
   
-  const JPetTRB & getTRB() const
-  { 
-    return (JPetTRB&)*fTRefTRBs.GetObject(); 
-  }
+  const JPetTRB & getTRB() const;
   
   void setTRB(JPetTRB &p_TRB)
   {
     fTRefTRBs = &p_TRB;
+    fTRBID = p_TRB.getID();
   }
 
   inline bool operator==(const JPetFEB& feb) { return getID() == feb.getID(); }
@@ -100,15 +98,17 @@ public:
 
 protected:
   TRef fTRefTRBs;
+  int fTRBID; ///< id of the referenced TRB, resolved by JPetParamBank::resolve(), -1 if unset
   
   void clearTRefTRBs()
   {
     fTRefTRBs = NULL;
+    fTRBID = -1;
   }
   
   
 private:
-  ClassDef(JPetFEB, 1);
+  ClassDef(JPetFEB, 2);
   
   friend class JPetParamManager;
 };
@@ -22,19 +22,34 @@ JPetHLDReader::JPetHLDReader():
   fBranch(0),
   fTree(0),
   fEvent(0),
+  fCompactEvent(0),
+  fEventW(0),
+  fEmptyEventW(0),
   fFile(NULL),
-  fCurrentEventNumber(-1)
+  fCurrentEventNumber(-1),
+  fLoadedEventNumber(-1),
+  fReadEntries(0),
+  fReadBytes(0)
 {
-  /* */
+  fEventW = new WrappedEvent(fEmptyEvent);
+  fEmptyEventW = new WrappedEvent(fEmptyEvent);
 }
 
 JPetHLDReader::JPetHLDReader (const char* filename):
   fBranch(0),
   fTree(0),
   fEvent(0),
+  fCompactEvent(0),
+  fEventW(0),
+  fEmptyEventW(0),
   fFile(NULL),
-  fCurrentEventNumber(-1)
+  fCurrentEventNumber(-1),
+  fLoadedEventNumber(-1),
+  fReadEntries(0),
+  fReadBytes(0)
 {
+  fEventW = new WrappedEvent(fEmptyEvent);
+  fEmptyEventW = new WrappedEvent(fEmptyEvent);
   if (!openFileAndLoadData(filename, "T")) {
     ERROR("error in opening file");
   }
@@ -43,26 +58,38 @@ JPetHLDReader::JPetHLDReader (const char* filename):
 JPetHLDReader::~JPetHLDReader ()
 {
   closeFile();
+  delete fEventW;
+  delete fEmptyEventW;
 }
 
 
 EventIII& JPetHLDReader::getCurrentEvent()
 {
-  if (loadCurrentEvent()) {
-    fEventW  = new  WrappedEvent(*fEvent);
-    return *fEventW;
-    //return *fEvent;
-  } else {
+  if (!loadCurrentEvent()) {
     ERROR("Could not read the current event");
-    if (fEvent) {
-      delete fEvent;
-    }
-    fEvent = new EventIII();
+    // fEventW shares the TDC channels with the event of the tree, so it must not be cleared
+    return *fEmptyEventW;
   }
-  fEventW  = new WrappedEvent(*fEvent);
   return *fEventW;
 }
 
+EventIII* JPetHLDReader::readEvent(long long n)
+{
+  fCurrentEventNumber = n;
+  if (loadCurrentEvent()) return fEventW;
+  return 0;
+}
+
+/**
+ * The wrapper is a shallow copy pointing to the TDC channels of fEvent,
+ * so no hits are copied here.
+ */
+void JPetHLDReader::updateWrappedEvent()
+{
+  EventIII& wrapped = *fEventW;
+  wrapped = (fEvent ? *fEvent : fEmptyEvent);
+}
+
 bool JPetHLDReader::nextEvent()
 {
   fCurrentEventNumber++;
@@ -89,14 +116,28 @@ bool JPetHLDReader::nthEvent(int n)
 
 void JPetHLDReader::closeFile ()
 {
+  fReadCache.detach();
+  // the event read by the tree is deleted together with the file,
+  // the one filled from the compact events belongs to the reader
+  EventIII* ownedEvent = fCompactEvent ? fEvent : 0;
+  fEvent = 0;
+  updateWrappedEvent();
+  delete ownedEvent;
   if (fFile != NULL) {
     if (fFile->IsOpen()) fFile->Close();
     delete fFile;
     fFile = NULL;
   }
+  if (fCompactEvent) {
+    delete fCompactEvent;
+    fCompactEvent = 0;
+  }
   fBranch = 0;
-  fEvent = 0;
   fTree = 0;
+  fCurrentEventNumber = -1;
+  fLoadedEventNumber = -1;
+  fReadEntries = 0;
+  fReadBytes = 0;
 }
 
 bool JPetHLDReader::loadData(const char* treename)
@@ -115,11 +156,19 @@ bool JPetHLDReader::loadData(const char* treename)
     return false;
   }
   fBranch = fTree->GetBranch("eventIII");
-  if (!fBranch) {
-    ERROR("in reading branch from tree");
-    return false;
+  if (fBranch) {
+    fBranch->SetAddress(&fEvent);
+  } else {
+    fBranch = fTree->GetBranch("compactEvent");
+    if (!fBranch) {
+      ERROR("in reading branch from tree");
+      return false;
+    }
+    fCompactEvent = new CompactEvent();
+    fEvent = new EventIII();
+    fBranch->SetAddress(&fCompactEvent);
   }
-  fBranch->SetAddress(&fEvent);
+  fReadCache.attach(fFile, fTree);
   firstEvent();
   return true;
 }
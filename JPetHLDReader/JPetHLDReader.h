@@ -25,7 +25,9 @@
 #include "../JPetLoggerInclude.h"
 
 #include "../JPetUnpacker/Unpacker2/EventIII.h"
+#include "../JPetUnpacker/Unpacker2/CompactEvent.h"
 #include "../JPetReaderInterface/JPetReaderInterface.h"
+#include "../JPetReadCache/JPetReadCache.h"
 
 /**
  * @brief A class wraps Event to be able to return it as TNamed pointer
@@ -43,6 +45,8 @@ class WrappedEvent :public EventIII,  public TNamed
  * @brief A class responsible for reading any data from an unpacked HLD file.
  *
  * This if a special case of JPetReader adapted for reading the ROOT files produced by the JPetUnpacker of HLD files. It should be used in the first JPetAnalysisModule whose processing is not preceded by any other module. In all subsequent modules, JPetReader should be used instead.
+ * Both the EventIII branch ("eventIII") and the compact time line branch ("compactEvent") are supported.
+ * In the latter case the hits are built from the time lines and returned as EventIII.
  */
 class JPetHLDReader : public JPetReaderInterface 
 {
@@ -57,9 +61,19 @@ public:
   virtual bool firstEvent();
   virtual bool lastEvent();
   virtual bool nthEvent(int n);
+  virtual EventIII* readEvent(long long n);
   virtual long long getCurrentEventNumber() const {
     return fCurrentEventNumber;
   }
+  virtual long long getNbOfReadEntries() const {
+    return fReadEntries;
+  }
+  virtual long long getNbOfReadBytes() const {
+    return fReadBytes;
+  }
+  virtual JPetReadCache& getReadCache() {
+    return fReadCache;
+  }
   virtual long long getNbOfAllEvents() const {
     return fTree ? fTree->GetEntries() : 0;
   } 
@@ -83,13 +97,28 @@ public:
 protected:
   virtual bool openFile(const char* filename);
   virtual bool loadData(const char* treename = "T");
+  /// Reads the current entry, unless it is the one already loaded, and points fEventW at it.
   bool loadCurrentEvent() {
     if (fTree) {
+      if (fCurrentEventNumber == fLoadedEventNumber) return true;
+      fLoadedEventNumber = -1;
+      fReadCache.startRead();
       int entryCode = fTree->GetEntry(fCurrentEventNumber);
-      return isCorrectTreeEntryCode(entryCode);
+      fReadCache.stopRead();
+      fReadEntries++;
+      if (!isCorrectTreeEntryCode(entryCode)) return false;
+      fReadBytes += entryCode;
+      if (fCompactEvent) {
+        fEvent->Clear();
+        fCompactEvent->FillEventIII(fEvent);
+      }
+      updateWrappedEvent();
+      fLoadedEventNumber = fCurrentEventNumber;
+      return true;
     } 
     return false;
   }
+  void updateWrappedEvent();
   
   inline bool isCorrectTreeEntryCode (int entryCode) const  ///see TTree GetEntry method
   {
@@ -101,9 +130,16 @@ protected:
   TBranch* fBranch;
   TTree* fTree;
   EventIII* fEvent;
-  WrappedEvent* fEventW;
+  CompactEvent* fCompactEvent; ///< set only if the file contains the compact branch, fEvent is then owned by the reader
+  WrappedEvent* fEventW; ///< reused for every event, shares the hits with fEvent
+  EventIII fEmptyEvent; ///< returned when no event is loaded
+  WrappedEvent* fEmptyEventW; ///< returned by getCurrentEvent() if the event cannot be read, shares the hits with fEmptyEvent only
   TFile* fFile;
   long long fCurrentEventNumber;
+  long long fLoadedEventNumber;
+  long long fReadEntries;
+  long long fReadBytes;
+  JPetReadCache fReadCache;
 
 private:
   JPetHLDReader(const JPetHLDReader&);
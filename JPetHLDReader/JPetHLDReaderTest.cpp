@@ -90,4 +90,45 @@ BOOST_AUTO_TEST_CASE (good_file_closeFile)
   BOOST_REQUIRE_EQUAL(reader.getNbOfAllEvents(), 0);
 }
 
+BOOST_AUTO_TEST_CASE (readEventReusesTheEvent)
+{
+  JPetHLDReader reader("unitTestData/JPetHLDReaderTest/small_hld.root");
+  BOOST_REQUIRE(reader.isOpen());
+  const long long nEvents = reader.getNbOfAllEvents();
+  EventIII* first = reader.readEvent(0);
+  BOOST_REQUIRE(first);
+  for (long long i = 0; i < nEvents; i++) {
+    EventIII* event = reader.readEvent(i);
+    BOOST_REQUIRE(event == first);
+    BOOST_REQUIRE(event == &reader.getCurrentEvent());
+  }
+  BOOST_REQUIRE_EQUAL(reader.getNbOfReadEntries(), nEvents);
+  BOOST_REQUIRE(reader.getNbOfReadBytes() > 0);
+  BOOST_TEST_MESSAGE("GetEntry calls per event: " << reader.getNbOfReadEntries() / double(nEvents)
+                     << ", bytes read per event: " << reader.getNbOfReadBytes() / double(nEvents));
+  BOOST_REQUIRE(!reader.readEvent(nEvents));
+}
+
+BOOST_AUTO_TEST_CASE (readErrorKeepsTheLoadedHits)
+{
+  gErrorIgnoreLevel = 6000; /// we turn off the ROOT error messages
+  JPetHLDReader reader("unitTestData/JPetHLDReaderTest/small_hld.root");
+  BOOST_REQUIRE(reader.isOpen());
+  const long long nEvents = reader.getNbOfAllEvents();
+  long long withHits = -1;
+  for (long long i = 0; i < nEvents && withHits < 0; i++) {
+    if (reader.readEvent(i)->GetTDCChannelsArray()->GetEntriesFast() > 0) withHits = i;
+  }
+  BOOST_REQUIRE(withHits >= 0);
+  EventIII* event = reader.readEvent(withHits);
+  const int nChannels = event->GetTDCChannelsArray()->GetEntriesFast();
+
+  BOOST_REQUIRE(!reader.nthEvent(nEvents));
+  EventIII& empty = reader.getCurrentEvent();
+  BOOST_REQUIRE(&empty != event);
+  BOOST_REQUIRE_EQUAL(empty.GetTDCChannelsArray()->GetEntriesFast(), 0);
+  /// the channels shared with the event of the tree are not cleared
+  BOOST_REQUIRE_EQUAL(event->GetTDCChannelsArray()->GetEntriesFast(), nChannels);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
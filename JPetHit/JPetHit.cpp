@@ -15,6 +15,7 @@
 
 #include "./JPetHit.h"
 #include "../JPetLoggerInclude.h"
+#include "../JPetParamBank/JPetParamBank.h"
 
 #include "TString.h"
 
@@ -23,7 +24,7 @@ ClassImp(JPetHit);
 JPetHit::JPetHit() :
     TNamed("JPetHit","Hit Structure"), fEnergy(0.0f), fQualityOfEnergy(0.0f), fTime(0.0f),
     fQualityOfTime(0.0f),
-    fBarrelSlot(NULL), fScintillator(NULL) { 
+    fBarrelSlot(NULL), fScintillator(NULL), fBarrelSlotID(-1), fScintillatorID(-1) { 
   fIsSignalAset = false;
   fIsSignalBset = false;
 }
@@ -31,7 +32,8 @@ JPetHit::JPetHit() :
 JPetHit::JPetHit(float e, float qe, float t, float qt, TVector3& pos, JPetPhysSignal& siga, JPetPhysSignal& sigb,
                   JPetBarrelSlot& bslot, JPetScin& scin) : 
     TNamed("JPetHit","Hit Structure") ,fEnergy(e), fQualityOfEnergy(qe), fTime(t),
-    fQualityOfTime(qt), fPos(pos), fSignalA(siga), fSignalB(sigb), fBarrelSlot(&bslot), fScintillator(&scin) {
+    fQualityOfTime(qt), fPos(pos), fSignalA(siga), fSignalB(sigb), fBarrelSlot(&bslot), fScintillator(&scin),
+    fBarrelSlotID(bslot.getID()), fScintillatorID(scin.getID()) {
 
   fIsSignalAset = true ;
   fIsSignalBset = true ;
@@ -59,8 +61,8 @@ const JPetPhysSignal& JPetHit::getSignal(Signal pos) const {
 }
 const JPetPhysSignal& JPetHit::getSignalA() const {return fSignalA;}
 const JPetPhysSignal& JPetHit::getSignalB() const {return fSignalB;}
-const JPetScin& JPetHit::getScintillator() const {return (JPetScin&)*fScintillator.GetObject();}
-const JPetBarrelSlot& JPetHit::getBarrelSlot() const {return (JPetBarrelSlot&)*fBarrelSlot.GetObject();}
+const JPetScin& JPetHit::getScintillator() const {return JPetParamBank::resolve<JPetScin>(fScintillatorID, fScintillator);}
+const JPetBarrelSlot& JPetHit::getBarrelSlot() const {return JPetParamBank::resolve<JPetBarrelSlot>(fBarrelSlotID, fBarrelSlot);}
 const bool JPetHit::isSignalASet() const{return fIsSignalAset;}
 const bool JPetHit::isSignalBSet() const{return fIsSignalBset;}
 
@@ -77,8 +79,8 @@ void JPetHit::setPosX(float x) {fPos.SetX(x);}
 void JPetHit::setPosY(float y) {fPos.SetY(y);}
 void JPetHit::setPosZ(float z) {fPos.SetZ(z);}
 void JPetHit::setPos (float x,float y,float z) {fPos.SetXYZ(x,y,z);}
-void JPetHit::setBarrelSlot(JPetBarrelSlot& bs) {fBarrelSlot = &bs;}
-void JPetHit::setScintillator(JPetScin& sc) {fScintillator = &sc;}
+void JPetHit::setBarrelSlot(JPetBarrelSlot& bs) {fBarrelSlot = &bs; fBarrelSlotID = bs.getID();}
+void JPetHit::setScintillator(JPetScin& sc) {fScintillator = &sc; fScintillatorID = sc.getID();}
 void JPetHit::setScinID (const int scinID) {fScinID = scinID;}
 
 
@@ -102,9 +104,14 @@ const bool JPetHit::checkConsistency() const{
     return false;
   }
 
-  if( getSignalA().getTimeWindowIndex() != getSignalB().getTimeWindowIndex() ){
+  const unsigned int window_a = getSignalA().getTimeWindowIndex();
+  const unsigned int window_b = getSignalB().getTimeWindowIndex();
+  if( window_a + 1 == window_b || window_b + 1 == window_a ){
+    DEBUG( Form("Signals added to Hit come from neighbouring time windows: %d and %d." ,
+		window_a, window_b) );
+  } else if( window_a != window_b ){
     ERROR( Form("Signals added to Hit come from different time windows: %d and %d." ,
-		getSignalA().getTimeWindowIndex(), getSignalB().getTimeWindowIndex()) );
+		window_a, window_b) );
   }
   
   return true;
@@ -130,5 +137,8 @@ void JPetHit::setSignalB(JPetPhysSignal & p_sig) {
 }
 
 unsigned int JPetHit::getTimeWindowIndex() const{
+  if( fIsSignalBset && getSignalB().getTimeWindowIndex() < getSignalA().getTimeWindowIndex() ){
+    return getSignalB().getTimeWindowIndex();
+  }
   return getSignalA().getTimeWindowIndex();
 }
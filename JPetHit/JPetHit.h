@@ -97,9 +97,10 @@ class JPetHit : public TNamed {
   void setSignals(JPetPhysSignal & p_sigA, JPetPhysSignal & p_sigB);
   void setSignalA(JPetPhysSignal & p_sig);
   void setSignalB(JPetPhysSignal & p_sig);
+  /// The earlier of the time windows of the signals, the time of the hit is counted from its beginning
   unsigned int getTimeWindowIndex()const;
   
-  ClassDef(JPetHit,1);
+  ClassDef(JPetHit,2);
   /** @brief Checks whether information contained in both Signal objects
    *  set in this Hit object is consistent and logs an error message if
    *  it is not.
@@ -115,8 +116,11 @@ class JPetHit : public TNamed {
    *  - if both signals belong to the same time window
    * 
    *  If all the above conditions are met, this method only returns 'true'.
-   *  If any of these conditions is violated, 'false' is returned and
-   *  an appropriate message is written to the log file.
+   *  If any of the first two conditions is violated, 'false' is returned and
+   *  an appropriate message is written to the log file. Signals from different
+   *  time windows are only reported: the neighbouring windows of continuous
+   *  data can be matched on purpose (see SDAMatchHits), so they are logged as
+   *  DEBUG, the other ones as ERROR.
    *
    *  @return true if both signals are consistently from the same barrel slot.
    */
@@ -141,6 +145,9 @@ class JPetHit : public TNamed {
   // references to parametric objects
   TRef fBarrelSlot; ///< BarrelSlot in which the hit was recorded
   TRef fScintillator; ///< Scintillator strip which was hit
+  // ids of the referenced objects, looked up in the active JPetParamBank, -1 if unset or read from an older file
+  int fBarrelSlotID;
+  int fScintillatorID;
 
 };
   
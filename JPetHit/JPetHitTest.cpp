@@ -56,6 +56,20 @@ BOOST_AUTO_TEST_CASE(consistency_check_test)
   BOOST_REQUIRE_EQUAL( hit1.checkConsistency(), false );
 }
 
+BOOST_AUTO_TEST_CASE(time_window_index_test)
+{
+  JPetPhysSignal signalA;
+  JPetPhysSignal signalB;
+  signalA.setTimeWindowIndex(4);
+  signalB.setTimeWindowIndex(3);
+  JPetHit hit;
+  hit.setSignalA(signalA);
+  BOOST_REQUIRE_EQUAL( hit.getTimeWindowIndex(), 4u );
+  // the signals of the neighbouring windows give a hit in the earlier one
+  hit.setSignalB(signalB);
+  BOOST_REQUIRE_EQUAL( hit.getTimeWindowIndex(), 3u );
+}
+
 BOOST_AUTO_TEST_CASE(set_get_scalars_test){
   JPetHit hit;
   float time = 0.1;
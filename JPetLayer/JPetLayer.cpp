@@ -14,6 +14,7 @@
  */
 
 #include "JPetLayer.h"
+#include "../JPetParamBank/JPetParamBank.h"
 
 
 JPetLayer::JPetLayer() : 
@@ -21,7 +22,8 @@ JPetLayer::JPetLayer() :
   fIsActive(false),
   fName(std::string("")),
   fRadius(-1.f),
-  fTRefFrame(NULL)
+  fTRefFrame(NULL),
+  fFrameID(-1)
 {
   SetName("JPetLayer");
 }
@@ -31,11 +33,17 @@ JPetLayer::JPetLayer(int id, bool isActive, std::string name, float radius) :
   fIsActive(isActive),
   fName(name),
   fRadius(radius),
-  fTRefFrame(NULL)
+  fTRefFrame(NULL),
+  fFrameID(-1)
 {
   SetName("JPetLayer");
 }
 
+const JPetFrame& JPetLayer::getFrame() const
+{
+  return JPetParamBank::resolve<JPetFrame>(fFrameID, fTRefFrame);
+}
+
 bool JPetLayer::operator==(const JPetLayer& layer) const {
   if( getId() == layer.getId() ){
     // assure consistency
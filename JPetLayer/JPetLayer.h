@@ -34,6 +34,7 @@ protected:
   std::string fName;
   float fRadius;
   TRef fTRefFrame;
+  int fFrameID; ///< id of the referenced frame, resolved by JPetParamBank::resolve(), -1 if unset
 
 public:
   JPetLayer();
@@ -46,17 +47,18 @@ public:
   inline bool getIsActive() const { return fIsActive; }
   inline std::string getName() const { return fName; }
   inline float getRadius() const { return fRadius; }
-  inline const JPetFrame& getFrame() const { return static_cast<JPetFrame&>(*(fTRefFrame.GetObject())); }
-  inline void setFrame(JPetFrame &frame) { fTRefFrame = &frame; }
+  const JPetFrame& getFrame() const;
+  inline void setFrame(JPetFrame &frame) { fTRefFrame = &frame; fFrameID = frame.getId(); }
 
 protected:
   void clearTRefFrame()
   {
     fTRefFrame = NULL;
+    fFrameID = -1;
   }
   
 private:
-  ClassDef(JPetLayer, 3);
+  ClassDef(JPetLayer, 4);
 };
 
 #endif // JPET_LAYER_H
@@ -14,7 +14,14 @@
  */
 
 #include <ctime>
-#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include "./JPetLogger.h"
 #include "../JPetLoggerInclude.h"
 
@@ -25,65 +32,289 @@ bool JPetLogger::fIsLogFile = false;
 bool JPetLogger::fIsLogFile = true;
 #endif
 
+std::atomic<int> JPetLogger::fLevel(JPetLogger::kDebug);
+
 const std::string JPetLogger::fFileName = JPetLogger::generateFilename();
 
-void JPetLogger::dateAndTime() {
-  std::ofstream log(fFileName.c_str(), std::ios_base::app);
-  std::streambuf* originalCoutBuffer = 0; 
-  // we redirect std::cout to a file 
-  if (fIsLogFile) {
-    originalCoutBuffer = std::cout.rdbuf();
-    std::cout.rdbuf(log.rdbuf());
+namespace {
+
+struct LogEntry {
+  std::atomic<LogEntry*> fNext;
+  std::string fText;
+  bool fCounted; ///< subject to the limit of repeated messages
+  int fMaxRepeats; ///< if not negative, the entry changes the limit of repeated messages instead
+};
+
+/// Multiple producers, single consumer queue (D. Vyukov's intrusive list):
+/// push() never blocks, pop() is called only by the writing thread.
+class LogQueue {
+ public:
+  LogQueue(): fHead(&fStub), fTail(&fStub) {
+    fStub.fNext.store(0);
   }
 
-  if (std::cout.fail()) {
-    std::cerr << "Unable to open log file!" << std::endl;
-    return;
+  void push(LogEntry* entry) {
+    entry->fNext.store(0, std::memory_order_relaxed);
+    LogEntry* previous = fHead.exchange(entry, std::memory_order_acq_rel);
+    previous->fNext.store(entry, std::memory_order_release);
   }
-  time_t t = time(0);   /// current time
-  struct tm * now = localtime(&t);
-  std::cout << (now->tm_year + 1900) << '-'
-  << (now->tm_mon + 1) << '-'
-  <<  now->tm_mday << " "
-  <<  now->tm_hour << ":"
-  <<  now->tm_min << ":"
-  <<  now->tm_sec << std::endl;
-  if (fIsLogFile) {
-    std::cout.rdbuf(originalCoutBuffer);  // back to original stream
+
+  /// Returns 0 if the queue is empty or the next entry is still being pushed
+  LogEntry* pop() {
+    LogEntry* tail = fTail;
+    LogEntry* next = tail->fNext.load(std::memory_order_acquire);
+    if (tail == &fStub) {
+      if (!next) return 0;
+      fTail = next;
+      tail = next;
+      next = next->fNext.load(std::memory_order_acquire);
+    }
+    if (next) {
+      fTail = next;
+      return tail;
+    }
+    if (tail != fHead.load(std::memory_order_acquire)) return 0;
+    push(&fStub);
+    next = tail->fNext.load(std::memory_order_acquire);
+    if (next) {
+      fTail = next;
+      return tail;
+    }
+    return 0;
+  }
+
+ private:
+  std::atomic<LogEntry*> fHead;
+  LogEntry* fTail;
+  LogEntry fStub;
+};
+
+/// Owns the log file and the thread writing the queued messages to it
+class LogWriter {
+ public:
+  LogWriter(const std::string& fileName, bool toFile):
+    fPushed(0), fWritten(0), fStop(false), fMaxRepeats(kDefaultMaxRepeats) {
+    if (toFile) {
+      fFile.open(fileName.c_str(), std::ios_base::app);
+      if (!fFile) std::cerr << "Unable to open log file!" << std::endl;
+    }
+    fOutput = toFile ? static_cast<std::ostream*>(&fFile) : &std::cout;
+    fThread = std::thread(&LogWriter::run, this);
+  }
+
+  ~LogWriter() {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+    }
+    fWakeUp.notify_one();
+    fThread.join();
+  }
+
+  void push(std::string&& text, bool counted, bool wait) {
+    LogEntry* entry = new LogEntry;
+    entry->fText = std::move(text);
+    entry->fCounted = counted;
+    entry->fMaxRepeats = -1;
+    enqueue(entry, wait);
+  }
+
+  /// The limit is changed by the writing thread, in order with the messages
+  void setMaxRepeats(int maxRepeats) {
+    LogEntry* entry = new LogEntry;
+    entry->fCounted = false;
+    entry->fMaxRepeats = maxRepeats > 0 ? maxRepeats : 0;
+    enqueue(entry, false);
+  }
+
+  void flush() {
+    fWakeUp.notify_one();
+    waitFor(fPushed.load());
+  }
+
+ private:
+  static const int kDefaultMaxRepeats = 100;
+  static const size_t kMaxTrackedMessages = 10000;
+
+  void enqueue(LogEntry* entry, bool wait) {
+    fQueue.push(entry);
+    const long long pushed = ++fPushed;
+    fWakeUp.notify_one();
+    if (wait) waitFor(pushed);
+  }
+
+  void waitFor(long long pushed) {
+    std::unique_lock<std::mutex> lock(fMutex);
+    fWrittenCondition.wait(lock, [this, pushed] { return fWritten.load() >= pushed; });
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> lock(fMutex);
+    while (true) {
+      lock.unlock();
+      const bool wroteAny = writeQueued();
+      lock.lock();
+      if (wroteAny) {
+        fWrittenCondition.notify_all();
+        continue;
+      }
+      if (fStop && fWritten.load() == fPushed.load()) break;
+      // a notification may be missed while writing, so the queue is checked periodically anyway
+      fWakeUp.wait_for(lock, std::chrono::milliseconds(20));
+    }
+    lock.unlock();
+    writeSuppressed();
+    fOutput->flush();
+    fWrittenCondition.notify_all();
+  }
+
+  bool writeQueued() {
+    bool wroteAny = false;
+    while (LogEntry* entry = fQueue.pop()) {
+      if (entry->fMaxRepeats >= 0) {
+        writeSuppressed();
+        fMaxRepeats = entry->fMaxRepeats;
+      } else if (!entry->fCounted || isBelowRepeatLimit(entry->fText)) {
+        *fOutput << entry->fText;
+      }
+      delete entry;
+      ++fWritten;
+      wroteAny = true;
+    }
+    if (wroteAny) fOutput->flush();
+    return wroteAny;
+  }
+
+  /// Counts the message and tells if it should still be written
+  bool isBelowRepeatLimit(const std::string& text) {
+    if (fMaxRepeats <= 0) return true;
+    if (fRepeats.size() >= kMaxTrackedMessages) {
+      writeSuppressed();
+    }
+    const long long count = ++fRepeats[text];
+    if (count == fMaxRepeats + 1) {
+      *fOutput << "Info JPetLogger(): the following message was repeated " << fMaxRepeats
+               << " times, the next ones are not written:\n" << text;
+    }
+    return count <= fMaxRepeats;
   }
+
+  void writeSuppressed() {
+    for (const auto& repeated : fRepeats) {
+      if (fMaxRepeats > 0 && repeated.second > fMaxRepeats) {
+        *fOutput << "Info JPetLogger(): " << repeated.second - fMaxRepeats
+                 << " more times:\n" << repeated.first;
+      }
+    }
+    fRepeats.clear();
+  }
+
+  LogQueue fQueue;
+  std::atomic<long long> fPushed;
+  std::atomic<long long> fWritten;
+  bool fStop;
+  int fMaxRepeats; ///< used only by the writing thread
+  std::unordered_map<std::string, long long> fRepeats;
+  std::ofstream fFile;
+  std::ostream* fOutput;
+  std::mutex fMutex;
+  std::condition_variable fWakeUp;
+  std::condition_variable fWrittenCondition;
+  std::thread fThread;
+};
+
+enum WriterState {kNotCreated, kAlive, kDestroyed};
+// the messages of destructors running after the writer is destroyed at exit are written directly
+std::atomic<int> gWriterState(kNotCreated);
+std::mutex gDirectWriteMutex;
+
+/// Keeps the state up to date, the writer is destroyed with the other static objects at exit
+struct StatefulLogWriter: public LogWriter {
+  StatefulLogWriter(const std::string& fileName, bool toFile): LogWriter(fileName, toFile) {
+    gWriterState = kAlive;
+  }
+  ~StatefulLogWriter() {
+    gWriterState = kDestroyed;
+  }
+};
+
+LogWriter& getWriter(const std::string& fileName, bool toFile) {
+  static StatefulLogWriter writer(fileName, toFile);
+  return writer;
 }
 
+void writeDirectly(const std::string& fileName, bool toFile, const std::string& text) {
+  std::lock_guard<std::mutex> lock(gDirectWriteMutex);
+  if (toFile) {
+    std::ofstream log(fileName.c_str(), std::ios_base::app);
+    log << text;
+  } else {
+    std::cout << text << std::flush;
+  }
+}
 
-void JPetLogger::logMessage(const char* func, const char* msg, MessageType type) {
-  std::ofstream log(fFileName.c_str(), std::ios_base::app);
-  std::streambuf* originalCoutBuffer = 0; 
-  // we redirect std::cout to a file 
-  if (fIsLogFile) {
-    originalCoutBuffer = std::cout.rdbuf();
-    std::cout.rdbuf(log.rdbuf());
+}
+
+void JPetLogger::setLevel(MessageType level) {
+  fLevel = level;
+}
+
+void JPetLogger::setMaxRepeats(int maxRepeats) {
+  if (gWriterState != kDestroyed) {
+    getWriter(fFileName, fIsLogFile).setMaxRepeats(maxRepeats);
   }
-  if (std::cout.fail()) {
-    std::cerr << "Unable to open log file!" << std::endl;
-    return;
+}
+
+const std::string& JPetLogger::getLogFileName() {
+  return fFileName;
+}
+
+void JPetLogger::flush() {
+  if (gWriterState == kAlive) {
+    getWriter(fFileName, fIsLogFile).flush();
+  }
+}
+
+void JPetLogger::dateAndTime() {
+  time_t t = time(0);   /// current time
+  struct tm now;
+  localtime_r(&t, &now);
+  std::ostringstream text;
+  text << (now.tm_year + 1900) << '-'
+  << (now.tm_mon + 1) << '-'
+  <<  now.tm_mday << " "
+  <<  now.tm_hour << ":"
+  <<  now.tm_min << ":"
+  <<  now.tm_sec << '\n';
+  if (gWriterState == kDestroyed) {
+    writeDirectly(fFileName, fIsLogFile, text.str());
+  } else {
+    getWriter(fFileName, fIsLogFile).push(text.str(), false, false);
   }
+}
+
+
+void JPetLogger::logMessage(const char* func, const char* msg, MessageType type) {
+  std::string text;
   switch (type) {
     case kInfo:
-      std::cout << "Info ";
+      text = "Info ";
       break;
     case kWarning:
-      std::cout << "Warning ";
+      text = "Warning ";
       break;
     case kError:
-      std::cout << "Error ";
+      text = "Error ";
       break;
     case kDebug:
-      std::cout << "Debug ";
+      text = "Debug ";
       break;
   }
-  std::cout << func << "():"
-  << msg
-  << std::endl;
-  if (fIsLogFile) {
-    std::cout.rdbuf(originalCoutBuffer);  // back to original stream
+  text.append(func).append("():").append(msg).append(1, '\n');
+  if (gWriterState == kDestroyed) {
+    writeDirectly(fFileName, fIsLogFile, text);
+  } else {
+    // the errors are not limited and are written before returning, e.g. before an exit() that follows
+    getWriter(fFileName, fIsLogFile).push(std::move(text), type != kError, type == kError);
   }
 }
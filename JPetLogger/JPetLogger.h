@@ -13,7 +13,9 @@
  *  @file JPetLogger.h
  *  @brief Simple logger class. Don't use directly. Macros from JPetLoggerInclude.h should be used instead. 
  *  JPetLogger class implements a simple logging functionality.
- *  For every message the logfile stream is opened, the message is written and the stream is closed again. This assures that no messages are lost in case of errrors.
+ *  The messages are put in a lock-free queue and written by a background thread to the log file, which stays open.
+ *  Errors are written before the logging call returns, so that they are not lost if the program crashes afterwards.
+ *  The remaining messages are written when the program exits or when flush() is called.
  */
 
 #ifndef JPETLOGGER_H
@@ -24,6 +26,7 @@
 #include <string>
 
 #ifndef __CINT__
+#include <atomic>
 #include <boost/uuid/uuid.hpp>            // uuid class
 #include <boost/uuid/uuid_generators.hpp> // generators
 #include <boost/uuid/uuid_io.hpp>         // streaming operators etc.
@@ -31,7 +34,26 @@
 
 class JPetLogger {
  public:
+  enum MessageType {kDebug, kInfo, kWarning, kError};
+
   static void dateAndTime();
+
+  /// Messages less important than level are dropped at runtime, before their text is formatted.
+  /// The levels switched off in JPetLoggerInclude.h are not compiled at all.
+  /// It can be changed while other threads are logging.
+  static void setLevel(MessageType level);
+  #ifndef __CINT__
+  inline static bool isEnabled(MessageType type) {
+    return type >= fLevel.load(std::memory_order_relaxed);
+  }
+  #endif
+  /// After maxRepeats identical messages the next ones are only counted, 0 means no limit.
+  /// The numbers of the messages not written so far are written when the limit is changed and at exit.
+  static void setMaxRepeats(int maxRepeats);
+  /// Blocks until all the messages logged so far are written
+  static void flush();
+  static const std::string& getLogFileName();
+
   inline static void warning(const char* func, const char* msg) {
     logMessage(func, msg, kWarning);
   }
@@ -58,8 +80,6 @@ class JPetLogger {
     logMessage(func, msg.c_str(), kDebug);
   }
  private:
-  enum MessageType {kInfo, kWarning, kError, kDebug};
-
   JPetLogger();
   JPetLogger(const JPetLogger&);
   JPetLogger& operator=(const JPetLogger&);
@@ -74,6 +94,9 @@ class JPetLogger {
 
   static const std::string fFileName;
   static bool fIsLogFile;
+  #ifndef __CINT__
+  static std::atomic<int> fLevel;
+  #endif
 };
 
 #endif /*  !JPETLOGGER_H */
@@ -0,0 +1,116 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE JPetLoggerTest
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../JPetLoggerInclude.h"
+
+namespace
+{
+/// Counts the lines of the log file equal to line
+int countLines(const std::string& line)
+{
+  std::ifstream log(JPetLogger::getLogFileName().c_str());
+  int count = 0;
+  std::string current;
+  while (std::getline(log, current)) {
+    if (current == line) count++;
+  }
+  return count;
+}
+
+int gEvaluations = 0;
+
+std::string evaluated(const std::string& text)
+{
+  gEvaluations++;
+  return text;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(FirstSuite)
+
+BOOST_AUTO_TEST_CASE( messagesOfAllThreadsAreWritten )
+{
+  const int kNumberOfThreads = 4;
+  const int kMessagesPerThread = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumberOfThreads; t++) {
+    threads.push_back(std::thread([t] {
+      for (int i = 0; i < kMessagesPerThread; i++) {
+        INFO("thread " + std::to_string(t) + " message " + std::to_string(i));
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  JPetLogger::flush();
+
+  std::ifstream log(JPetLogger::getLogFileName().c_str());
+  std::vector<std::vector<bool> > found(kNumberOfThreads, std::vector<bool>(kMessagesPerThread, false));
+  std::vector<int> last(kNumberOfThreads, -1);
+  std::string line;
+  while (std::getline(log, line)) {
+    int t = 0;
+    int i = 0;
+    if (std::sscanf(line.c_str(), "Info operator()():thread %d message %d", &t, &i) == 2) {
+      found[t][i] = true;
+      // the messages of one thread keep their order
+      BOOST_REQUIRE(i > last[t]);
+      last[t] = i;
+    }
+  }
+  for (int t = 0; t < kNumberOfThreads; t++) {
+    for (int i = 0; i < kMessagesPerThread; i++) {
+      BOOST_REQUIRE_MESSAGE(found[t][i], "message " << i << " of thread " << t << " is missing");
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( repeatedMessagesAreLimited )
+{
+  const int kMaxRepeats = 5;
+  const int kRepeats = 20;
+  JPetLogger::setMaxRepeats(kMaxRepeats);
+  for (int i = 0; i < kRepeats; i++) {
+    WARNING("the same warning");
+  }
+  ERROR("the same error");
+  ERROR("the same error");
+  // changing the limit writes how many times the message was not written
+  JPetLogger::setMaxRepeats(0);
+  JPetLogger::flush();
+
+  // __func__ of a test case is test_method, the message also follows the note about the limit and the summary
+  BOOST_REQUIRE_EQUAL(countLines("Warning test_method():the same warning"), kMaxRepeats + 2);
+  BOOST_REQUIRE_EQUAL(countLines("Info JPetLogger(): the following message was repeated "
+                                 + std::to_string(kMaxRepeats) + " times, the next ones are not written:"), 1);
+  BOOST_REQUIRE_EQUAL(countLines("Info JPetLogger(): " + std::to_string(kRepeats - kMaxRepeats) + " more times:"), 1);
+  // the errors are never limited
+  BOOST_REQUIRE_EQUAL(countLines("Error test_method():the same error"), 2);
+}
+
+BOOST_AUTO_TEST_CASE( filteredMessagesAreNotFormatted )
+{
+  gEvaluations = 0;
+  JPetLogger::setLevel(JPetLogger::kWarning);
+  BOOST_REQUIRE(!JPetLogger::isEnabled(JPetLogger::kInfo));
+  BOOST_REQUIRE(JPetLogger::isEnabled(JPetLogger::kError));
+  INFO(evaluated("filtered info"));
+  BOOST_REQUIRE_EQUAL(gEvaluations, 0);
+  WARNING(evaluated("written warning"));
+  BOOST_REQUIRE_EQUAL(gEvaluations, 1);
+  JPetLogger::setLevel(JPetLogger::kDebug);
+  JPetLogger::flush();
+
+  BOOST_REQUIRE_EQUAL(countLines("Info test_method():filtered info"), 0);
+  BOOST_REQUIRE_EQUAL(countLines("Warning test_method():written warning"), 1);
+  boost::filesystem::remove(JPetLogger::getLogFileName());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
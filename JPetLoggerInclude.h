@@ -16,6 +16,8 @@
  *  Levels can be switched on/off separately, by assign the value different than 1.
  *  The messages can be redirected to the screen if the SCREEN_OUTPUT is 1.
  *  Also the whole JPetLogger can be switched off/on by setting the JPETLOGGER_ON flag to 1.
+ *  The levels compiled in can be additionally filtered at runtime with JPetLogger::setLevel(),
+ *  the message is then not even formatted.
  */
 #ifndef JPETLOGGER_INCLUDE_H
 #define JPETLOGGER_INCLUDE_H
@@ -34,22 +36,22 @@
   #include "./JPetLogger/JPetLogger.h"
   #define DATE_AND_TIME()   JPetLogger::dateAndTime()
   #if JPET_LOGGER_LEVEL_INFO == 1
-    #define INFO(X)   JPetLogger::info(__func__, X)
+    #define INFO(X) do { if (JPetLogger::isEnabled(JPetLogger::kInfo)) JPetLogger::info(__func__, X); } while (0)
   #else
     #define INFO(X)
   #endif
   #if JPET_LOGGER_LEVEL_WARNING == 1
-    #define WARNING(X) JPetLogger::warning(__func__, X)
+    #define WARNING(X) do { if (JPetLogger::isEnabled(JPetLogger::kWarning)) JPetLogger::warning(__func__, X); } while (0)
   #else
     #define WARNING(X)
   #endif
   #if JPET_LOGGER_LEVEL_ERROR == 1
-    #define ERROR(X)   JPetLogger::error(__func__, X)
+    #define ERROR(X) do { if (JPetLogger::isEnabled(JPetLogger::kError)) JPetLogger::error(__func__, X); } while (0)
   #else
     #define ERROR(X)
   #endif
   #if JPET_LOGGER_LEVEL_DEBUG == 1
-    #define DEBUG(X)   JPetLogger::debug(__func__, X)
+    #define DEBUG(X) do { if (JPetLogger::isEnabled(JPetLogger::kDebug)) JPetLogger::debug(__func__, X); } while (0)
   #else
     #define DEBUG(X)
   #endif
@@ -15,6 +15,7 @@
 
 #include "./JPetManager.h"
 
+#include <atomic>
 #include <cassert>
 #include <ctime>
 #include <string>
@@ -23,8 +24,10 @@
 #include "../JPetScopeLoader/JPetScopeLoader.h"
 #include "../JPetCommonTools/JPetCommonTools.h"
 #include "../JPetCmdParser/JPetCmdParser.h"
+#include "../JPetReadCache/JPetReadCache.h"
 
 #include <TDSet.h>
+#include <TStopwatch.h>
 #include <TThread.h>
 
 
@@ -36,36 +39,90 @@ JPetManager& JPetManager::getManager()
   return instance;
 }
 
+namespace
+{
+/// The input files shared by the threads of JPetManager::run
+struct FileQueue {
+  TaskGeneratorChain* fTaskGeneratorChain;
+  const std::vector<JPetOptions>* fOptions;
+  std::atomic<size_t> fNextFile;
+  std::atomic<bool> fFailed;
+  std::vector<int> fSucceeded;
+  std::vector<double> fWallTimes;
+};
+
+/// Takes the next file from the queue until it is empty or some file has failed.
+void* runFileWorker(void* arg)
+{
+  FileQueue* queue = static_cast<FileQueue*>(arg);
+  const size_t nFiles = queue->fOptions->size();
+  for (size_t i = queue->fNextFile++; i < nFiles && !queue->fFailed; i = queue->fNextFile++) {
+    TStopwatch timer;
+    timer.Start();
+    JPetTaskExecutor executor(queue->fTaskGeneratorChain, i, queue->fOptions->at(i));
+    queue->fSucceeded[i] = executor.process();
+    timer.Stop();
+    queue->fWallTimes[i] = timer.RealTime();
+    if (!queue->fSucceeded[i]) {
+      ERROR(std::string("While running process of ") + queue->fOptions->at(i).getInputFile());
+      queue->fFailed = true;
+    } else {
+      INFO(Form("Processed %s in %.1f s", queue->fOptions->at(i).getInputFile(), queue->fWallTimes[i]));
+    }
+  }
+  return 0;
+}
+}
+
+/**
+ * The input files are processed by a pool of fileThreads threads, every file
+ * with its own JPetTaskExecutor and param manager. No new file is started
+ * once processing of some file has failed.
+ */
 bool JPetManager::run()
 {
   INFO( "======== Starting processing all tasks: " + JPetCommonTools::getTimeString() + " ========\n" );
-  std::vector<JPetTaskExecutor*> executors;
-  std::vector<TThread*> threads;
-  auto i = 0;
-  for (auto opt : fOptions) {
-    JPetTaskExecutor* executor = new JPetTaskExecutor(fTaskGeneratorChain, i, opt);
-    executors.push_back(executor);
-    if(!executor->process()) {
-      ERROR("While running process");
-      return false;
+  FileQueue queue;
+  queue.fTaskGeneratorChain = fTaskGeneratorChain;
+  queue.fOptions = &fOptions;
+  queue.fNextFile = 0;
+  queue.fFailed = false;
+  queue.fSucceeded.assign(fOptions.size(), 0);
+  queue.fWallTimes.assign(fOptions.size(), 0.);
+
+  JPetReadCache::setAsyncPrefetching(!fOptions.empty() && fOptions.front().isReadAsyncPrefetching());
+  int nThreads = fOptions.empty() ? 1 : fOptions.front().getFileThreads();
+  if (nThreads > (int)fOptions.size()) nThreads = fOptions.size();
+  TStopwatch timer;
+  timer.Start();
+  if (nThreads > 1) {
+    INFO(Form("Processing %d files with %d threads", (int)fOptions.size(), nThreads));
+    TThread::Initialize();
+    std::vector<TThread*> threads;
+    for (int t = 0; t < nThreads; t++) {
+      TThread* thread = new TThread(Form("JPetManager%d", t), runFileWorker, (void*) &queue);
+      thread->Run();
+      threads.push_back(thread);
     }
-    //auto thr = executor->run();
-    //if (thr) {
-      //threads.push_back(thr);
-    //} else {
-      //ERROR("thread pointer is null");
-    //}
-    i++;
-  }
-  //for (auto thread : threads) {
-    //assert(thread);
-    //thread->Join();
-  //}
-  for (auto& executor : executors) {
-    if (executor) {
-      delete executor;
-      executor = 0;
+    for (auto thread : threads) {
+      assert(thread);
+      thread->Join();
+      delete thread;
     }
+  } else {
+    runFileWorker(&queue);
+  }
+  timer.Stop();
+
+  int nProcessed = 0;
+  for (auto succeeded : queue.fSucceeded) {
+    if (succeeded) nProcessed++;
+  }
+  if (nProcessed > 0 && timer.RealTime() > 0) {
+    INFO(Form("Processed %d files in %.1f s: %.1f files/hour", nProcessed, timer.RealTime(), nProcessed * 3600. / timer.RealTime()));
+  }
+  if (queue.fFailed) {
+    return false;
   }
 
   INFO( "======== Finished processing all tasks: " + JPetCommonTools::getTimeString() + " ========\n" );
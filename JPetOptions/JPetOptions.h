@@ -18,6 +18,8 @@
 
 #include <string>
 #include <map>
+#include <sstream>
+#include <vector>
 #include "../JPetCommonTools/JPetCommonTools.h"
 
 class JPetOptions
@@ -30,6 +32,8 @@ public:
   typedef std::map<std::string, std::string> Options;
   typedef std::vector<std::string> InputFileNames;
 
+  static const long long kDefaultReadCacheSize = 30 * 1024 * 1024; ///< [bytes]
+
   JPetOptions();
   explicit JPetOptions(const Options& opts);
 
@@ -83,6 +87,98 @@ public:
     }
     return result;
   }
+  inline bool isParamCache() const {
+    return fOptions.count("paramCache") > 0;
+  }
+  inline std::string getParamCache() const {
+    std::string result("");
+    if (isParamCache()) {
+      result = fOptions.at("paramCache");
+    }
+    return result;
+  }
+  inline int getUnpackerThreads() const {
+    int result = 1;
+    if (fOptions.count("unpackerThreads") > 0) {
+      result = std::stoi(fOptions.at("unpackerThreads"));
+    }
+    return result;
+  }
+  inline bool isUnpackerIntermediateFiles() const {
+    return fOptions.count("unpackerIntermediateFiles") > 0;
+  }
+  /// size of the TTreeCache of the input file in bytes, 0 means no cache
+  inline long long getReadCacheSize() const {
+    long long result = kDefaultReadCacheSize;
+    if (fOptions.count("readCacheSize") > 0) {
+      result = std::stoll(fOptions.at("readCacheSize")) * 1024 * 1024;
+    }
+    return result;
+  }
+  inline bool isReadAsyncPrefetching() const {
+    return fOptions.count("readAsyncPrefetching") > 0;
+  }
+  /// number of threads processing the events of one file by the tasks supporting it
+  inline int getTaskThreads() const {
+    int result = 1;
+    if (fOptions.count("taskThreads") > 0) {
+      result = std::stoi(fOptions.at("taskThreads"));
+    }
+    return result;
+  }
+  inline bool isStreamTasks() const {
+    return fOptions.count("streamTasks") > 0;
+  }
+  /// in the streaming mode only the outputs of these types and the one of the last task are saved
+  inline bool isPersistentOutput(const std::string& fileType) const {
+    if (fOptions.count("persistentOutputs") == 0) return false;
+    std::istringstream outputs(fOptions.at("persistentOutputs"));
+    std::string output;
+    while (outputs >> output) {
+      if (output == fileType) return true;
+    }
+    return false;
+  }
+  /// number of input files processed at the same time by JPetManager
+  inline int getFileThreads() const {
+    int result = 1;
+    if (fOptions.count("fileThreads") > 0) {
+      result = std::stoi(fOptions.at("fileThreads"));
+    }
+    return result;
+  }
+  inline bool isAsyncWriter() const {
+    return fOptions.count("asyncWriter") > 0;
+  }
+  /// the output settings below are -1 if not set by the user
+  inline int getCompressionAlgorithm() const {
+    int result = -1;
+    if (fOptions.count("compressionAlgorithm") > 0) {
+      result = std::stoi(fOptions.at("compressionAlgorithm"));
+    }
+    return result;
+  }
+  inline int getCompressionLevel() const {
+    int result = -1;
+    if (fOptions.count("compressionLevel") > 0) {
+      result = std::stoi(fOptions.at("compressionLevel"));
+    }
+    return result;
+  }
+  inline int getBasketSize() const {
+    int result = -1;
+    if (fOptions.count("basketSize") > 0) {
+      result = std::stoi(fOptions.at("basketSize"));
+    }
+    return result;
+  }
+  inline int getAutoSave() const {
+    int result = -1;
+    if (fOptions.count("autoSave") > 0) {
+      result = std::stoi(fOptions.at("autoSave"));
+    }
+    return result;
+  }
 
   FileType getInputFileType() const;
   FileType getOutputFileType() const;
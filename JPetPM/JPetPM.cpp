@@ -15,13 +15,17 @@
 
 #include "JPetPM.h"
 #include <cassert>
+#include "../JPetParamBank/JPetParamBank.h"
 
 JPetPM::JPetPM():
   fSide(SideA),
   fID(0),
   fHVset(0),
   fHVopt(0),
-  fHVgain(std::make_pair(0.0, 0.0))
+  fHVgain(std::make_pair(0.0, 0.0)),
+  fFEBID(-1),
+  fScinID(-1),
+  fBarrelSlotID(-1)
 {
   SetName("JPetPM");
 }
@@ -30,7 +34,10 @@ JPetPM::JPetPM(int id) : fSide(SideA),
 			 fID(id),
 			 fHVset(0),
 			 fHVopt(0),
-			 fHVgain(std::make_pair(0.0, 0.0))
+			 fHVgain(std::make_pair(0.0, 0.0)),
+			 fFEBID(-1),
+			 fScinID(-1),
+			 fBarrelSlotID(-1)
 {
   SetName("JPetPM");
 }
@@ -44,7 +51,10 @@ JPetPM::JPetPM(Side side,
   fID(id),
   fHVset(HVset),
   fHVopt(HVopt),
-  fHVgain(HVgainNumber)
+  fHVgain(HVgainNumber),
+  fFEBID(-1),
+  fScinID(-1),
+  fBarrelSlotID(-1)
 {
   SetName("JPetPM");
 }
@@ -53,6 +63,21 @@ JPetPM::~JPetPM()
 {
 }
 
+const JPetFEB& JPetPM::getFEB() const
+{
+  return JPetParamBank::resolve<JPetFEB>(fFEBID, fTRefFEB);
+}
+
+JPetScin& JPetPM::getScin() const
+{
+  return JPetParamBank::resolve<JPetScin>(fScinID, fTRefScin);
+}
+
+JPetBarrelSlot& JPetPM::getBarrelSlot() const
+{
+  return JPetParamBank::resolve<JPetBarrelSlot>(fBarrelSlotID, fTRefBarrelSlot);
+}
+
 bool JPetPM::operator==(const JPetPM& pm) const {
   if( getID() == pm.getID() ){
     assert(getSide()==pm.getSide());
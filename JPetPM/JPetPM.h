@@ -56,14 +56,14 @@ class JPetPM: public TNamed
   inline void setHVgain(float g1, float g2) { fHVgain.first = g1; fHVgain.second = g2; }
   inline void setHVgain(const std::pair<float,float>& gain) { fHVgain = gain; }
 
-  void setFEB(JPetFEB &p_FEB) { fTRefFEB = &p_FEB; }
-  const JPetFEB& getFEB() const { return (JPetFEB&)*(fTRefFEB.GetObject()); }
+  void setFEB(JPetFEB &p_FEB) { fTRefFEB = &p_FEB; fFEBID = p_FEB.getID(); }
+  const JPetFEB& getFEB() const;
   
-  void setScin(JPetScin &p_scin) { fTRefScin = &p_scin; }
-  JPetScin & getScin() const { return (JPetScin&)*(fTRefScin.GetObject()); }
+  void setScin(JPetScin &p_scin) { fTRefScin = &p_scin; fScinID = p_scin.getID(); }
+  JPetScin & getScin() const;
 
-  void setBarrelSlot(JPetBarrelSlot &p_barrelSlot){ fTRefBarrelSlot = &p_barrelSlot; }
-  JPetBarrelSlot& getBarrelSlot() const { return (JPetBarrelSlot&)*(fTRefBarrelSlot.GetObject()); }	
+  void setBarrelSlot(JPetBarrelSlot &p_barrelSlot){ fTRefBarrelSlot = &p_barrelSlot; fBarrelSlotID = p_barrelSlot.getID(); }
+  JPetBarrelSlot& getBarrelSlot() const;
   
   bool operator==(const JPetPM& pm) const;
   bool operator!=(const JPetPM& pm) const;
@@ -96,16 +96,20 @@ class JPetPM: public TNamed
   int fHVopt;
   std::pair<float, float> fHVgain;
 
-  ClassDef(JPetPM, 4);
+  ClassDef(JPetPM, 5);
   
 protected:
   TRef fTRefFEB;
   TRef fTRefScin;
   TRef fTRefBarrelSlot;
+  // ids of the referenced objects, resolved by JPetParamBank::resolve(), -1 if unset
+  int fFEBID;
+  int fScinID;
+  int fBarrelSlotID;
 
-  void clearTRefFEBs() { fTRefFEB = NULL; }
-  void clearTRefScin() { fTRefScin = NULL; }
-  void clearTRefBarrelSlot() { fTRefBarrelSlot = NULL; }
+  void clearTRefFEBs() { fTRefFEB = NULL; fFEBID = -1; }
+  void clearTRefScin() { fTRefScin = NULL; fScinID = -1; }
+  void clearTRefBarrelSlot() { fTRefBarrelSlot = NULL; fBarrelSlotID = -1; }
   
   /*std::vector<TRef> fTRefKBs;
   
@@ -17,6 +17,21 @@
 
 ClassImp (JPetParamBank);
 
+namespace
+{
+thread_local const JPetParamBank* gActiveBank = 0;
+}
+
+void JPetParamBank::setActive(const JPetParamBank* bank)
+{
+  gActiveBank = bank;
+}
+
+const JPetParamBank* JPetParamBank::getActive()
+{
+  return gActiveBank;
+}
+
 JPetParamBank::JPetParamBank():fDummy(false){}
 JPetParamBank::JPetParamBank(const bool d):fDummy(d){}
 const bool JPetParamBank::isDummy()const{return fDummy;}
@@ -30,10 +45,27 @@ JPetParamBank::JPetParamBank(const JPetParamBank& paramBank):fDummy(false){
   copyMapValues(fLayers, paramBank.fLayers);
   copyMapValues(fFrames, paramBank.fFrames);
   copyMapValues(fTOMBChannels, paramBank.fTOMBChannels);
+  buildIndex();
 }
 
 JPetParamBank::~JPetParamBank()
 {
+  if (gActiveBank == this) {
+    gActiveBank = 0;
+  }
+}
+
+void JPetParamBank::buildIndex()
+{
+  buildIndex(fScintillatorsIndex, fScintillators);
+  buildIndex(fPMsIndex, fPMs);
+  buildIndex(fPMCalibsIndex, fPMCalibs);
+  buildIndex(fFEBsIndex, fFEBs);
+  buildIndex(fTRBsIndex, fTRBs);
+  buildIndex(fBarrelSlotsIndex, fBarrelSlots);
+  buildIndex(fLayersIndex, fLayers);
+  buildIndex(fFramesIndex, fFrames);
+  buildIndex(fTOMBChannelsIndex, fTOMBChannels);
 }
 
 void JPetParamBank::clear()
@@ -47,6 +79,7 @@ void JPetParamBank::clear()
   fLayers.clear();
   fFrames.clear();
   fTOMBChannels.clear();
+  buildIndex();
 }
 
 
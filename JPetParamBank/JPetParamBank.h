@@ -29,7 +29,9 @@
 #include "../JPetParamGetter/JPetParamConstants.h"
 #include "../JPetLoggerInclude.h"
 #include <map>
+#include <vector>
 #include <cassert>
+#include <TRef.h>
 
 class JPetParamBank: public TObject
 {
@@ -44,127 +46,182 @@ class JPetParamBank: public TObject
 
   int getSize(ParamObjectType type) const;
 
+  /**
+   * @brief The bank resolving the references of the data objects in the current thread.
+   *
+   * The data classes (JPetSigCh, JPetHit, ...) and the parametric ones keep the id of
+   * every referenced parametric object next to its TRef. With an active bank the id is
+   * looked up in the flat index of the bank, otherwise, and for the objects read from
+   * the files written before the ids, the TRef is used. JPetParamManager activates the
+   * bank it loads, JPetTaskIO the bank of the task before processing the events.
+   */
+  static void setActive(const JPetParamBank* bank);
+  static const JPetParamBank* getActive();
+
+  /// Rebuilds the flat index, needed after the bank is read from a file
+  void buildIndex();
+
+  /// The object with the given id (channel for JPetTOMBChannel), 0 if there is none
+  template <class T>
+  T* find(int id) const;
+
+  /// The object referenced by id, or by the TRef if the id is unset or not in the active bank
+  template <class T>
+  static T& resolve(int id, const TRef& ref)
+  {
+    const JPetParamBank* bank = getActive();
+    T* object = (bank && id >= 0) ? bank->find<T>(id) : 0;
+    return object ? *object : static_cast<T&>(*ref.GetObject());
+  }
+
   // Scintillators
-  inline void addScintillator(JPetScin scintillator) {
-    fScintillators[scintillator.getID()] = new JPetScin(scintillator);
+  inline JPetScin& addScintillator(const JPetScin& scintillator) {
+    JPetScin* object = new JPetScin(scintillator);
+    fScintillators[scintillator.getID()] = object;
+    addToIndex(fScintillatorsIndex, scintillator.getID(), object);
+    return *object;
   }
   inline const std::map<int, JPetScin*>& getScintillators() const {
     return fScintillators;
   }
   inline JPetScin& getScintillator(int i) const {
-    return *(fScintillators.at(i));
+    return at(fScintillatorsIndex, fScintillators, i);
   }
   inline int getScintillatorsSize() const {
     return fScintillators.size();
   }
 
   // PMs
-  inline void addPM(JPetPM pm) {
-    fPMs[pm.getID()] = new JPetPM(pm);
+  inline JPetPM& addPM(const JPetPM& pm) {
+    JPetPM* object = new JPetPM(pm);
+    fPMs[pm.getID()] = object;
+    addToIndex(fPMsIndex, pm.getID(), object);
+    return *object;
   }
   inline const std::map<int, JPetPM*>& getPMs() const {
     return fPMs;
   }
   inline JPetPM& getPM(int id) const {
-    return *(fPMs.at(id));
+    return at(fPMsIndex, fPMs, id);
   }
   int getPMsSize() const {
     return fPMs.size();
   }
 
   // PMCalibs
-  inline void addPMCalib(JPetPMCalib pmCalib) {
-    fPMCalibs[pmCalib.GetId()] = new JPetPMCalib(pmCalib);
+  inline JPetPMCalib& addPMCalib(const JPetPMCalib& pmCalib) {
+    JPetPMCalib* object = new JPetPMCalib(pmCalib);
+    fPMCalibs[pmCalib.GetId()] = object;
+    addToIndex(fPMCalibsIndex, pmCalib.GetId(), object);
+    return *object;
   }
   inline const std::map<int, JPetPMCalib*>& getPMCalibs() const {
     return fPMCalibs;
   }
   inline JPetPMCalib& getPMCalib(int i) const {
-    return *(fPMCalibs.at(i));
+    return at(fPMCalibsIndex, fPMCalibs, i);
   }
   int getPMCalibsSize() const {
     return fPMCalibs.size();
   }
 
   // FEBs
-  inline void addFEB(JPetFEB feb) {
-    fFEBs[feb.getID()] = new JPetFEB(feb);
+  inline JPetFEB& addFEB(const JPetFEB& feb) {
+    JPetFEB* object = new JPetFEB(feb);
+    fFEBs[feb.getID()] = object;
+    addToIndex(fFEBsIndex, feb.getID(), object);
+    return *object;
   }
   inline const std::map<int, JPetFEB*>& getFEBs() const {
     return fFEBs;
   }
   inline JPetFEB& getFEB(int i) const {
-    return *(fFEBs.at(i));
+    return at(fFEBsIndex, fFEBs, i);
   }
   inline int getFEBsSize() const {
     return fFEBs.size();
   }
 
   // TRBs
-  inline void addTRB(JPetTRB trb) {
-    fTRBs[trb.getID()] = new JPetTRB(trb);
+  inline JPetTRB& addTRB(const JPetTRB& trb) {
+    JPetTRB* object = new JPetTRB(trb);
+    fTRBs[trb.getID()] = object;
+    addToIndex(fTRBsIndex, trb.getID(), object);
+    return *object;
   }
   inline const std::map<int, JPetTRB*>& getTRBs() const {
     return fTRBs;
   }
   inline JPetTRB& getTRB(int i) const {
-    return *(fTRBs.at(i));
+    return at(fTRBsIndex, fTRBs, i);
   }
   inline int getTRBsSize() const {
     return fTRBs.size();
   }
 
   // Barrel Slot
-  inline void addBarrelSlot(JPetBarrelSlot slot) {
-    fBarrelSlots[slot.getID()] = new JPetBarrelSlot(slot);
+  inline JPetBarrelSlot& addBarrelSlot(const JPetBarrelSlot& slot) {
+    JPetBarrelSlot* object = new JPetBarrelSlot(slot);
+    fBarrelSlots[slot.getID()] = object;
+    addToIndex(fBarrelSlotsIndex, slot.getID(), object);
+    return *object;
   }
   inline const std::map<int, JPetBarrelSlot*>& getBarrelSlots() const {
     return fBarrelSlots;
   }
   inline JPetBarrelSlot& getBarrelSlot(int i) const {
-    return *(fBarrelSlots.at(i));
+    return at(fBarrelSlotsIndex, fBarrelSlots, i);
   }
   inline int getBarrelSlotsSize() const {
     return fBarrelSlots.size();
   }
 
   // Layer
-  inline void addLayer(JPetLayer layer) {
-    fLayers[layer.getId()] = new JPetLayer(layer);
+  inline JPetLayer& addLayer(const JPetLayer& layer) {
+    JPetLayer* object = new JPetLayer(layer);
+    fLayers[layer.getId()] = object;
+    addToIndex(fLayersIndex, layer.getId(), object);
+    return *object;
   }
   inline const std::map<int, JPetLayer*>& getLayers() const {
     return fLayers;
   }
   inline JPetLayer& getLayer(int i) const {
-    return *(fLayers.at(i));
+    return at(fLayersIndex, fLayers, i);
   }
   inline int getLayersSize() const {
     return fLayers.size();
   }
 
   // Frame
-  inline void addFrame(JPetFrame frame) {
-    fFrames[frame.getId()] = new JPetFrame(frame);
+  inline JPetFrame& addFrame(const JPetFrame& frame) {
+    JPetFrame* object = new JPetFrame(frame);
+    fFrames[frame.getId()] = object;
+    addToIndex(fFramesIndex, frame.getId(), object);
+    return *object;
   }
   inline const std::map<int, JPetFrame*>& getFrames() const {
     return fFrames;
   }
   inline JPetFrame& getFrame(int i) const {
-    return *(fFrames.at(i));
+    return at(fFramesIndex, fFrames, i);
   }
   inline int getFramesSize() const {
     return fFrames.size();
   }
 
   // TOMB Channels
-  inline void addTOMBChannel(JPetTOMBChannel tombchannel) {
-    fTOMBChannels[tombchannel.getChannel()] = new JPetTOMBChannel(tombchannel);
+  inline JPetTOMBChannel& addTOMBChannel(const JPetTOMBChannel& tombchannel) {
+    JPetTOMBChannel* object = new JPetTOMBChannel(tombchannel);
+    fTOMBChannels[tombchannel.getChannel()] = object;
+    addToIndex(fTOMBChannelsIndex, tombchannel.getChannel(), object);
+    return *object;
   }
   inline const std::map<int, JPetTOMBChannel*>& getTOMBChannels() const {
     return fTOMBChannels;
   }
   inline JPetTOMBChannel& getTOMBChannel(int i) const {
-    return *(fTOMBChannels.at(i));
+    return at(fTOMBChannelsIndex, fTOMBChannels, i);
   }
   inline int getTOMBChannelsSize() const {
     return fTOMBChannels.size();
@@ -182,6 +239,18 @@ class JPetParamBank: public TObject
   std::map<int, JPetLayer*> fLayers;
   std::map<int, JPetFrame*> fFrames;
   std::map<int, JPetTOMBChannel*> fTOMBChannels;
+
+  // id -> object tables for the getters and find(), the maps stay the persistent storage
+  // (the layout of the files) and define the order of iteration
+  std::vector<JPetScin*> fScintillatorsIndex; //!
+  std::vector<JPetPM*> fPMsIndex; //!
+  std::vector<JPetPMCalib*> fPMCalibsIndex; //!
+  std::vector<JPetFEB*> fFEBsIndex; //!
+  std::vector<JPetTRB*> fTRBsIndex; //!
+  std::vector<JPetBarrelSlot*> fBarrelSlotsIndex; //!
+  std::vector<JPetLayer*> fLayersIndex; //!
+  std::vector<JPetFrame*> fFramesIndex; //!
+  std::vector<JPetTOMBChannel*> fTOMBChannelsIndex; //!
   ClassDef (JPetParamBank, 3);
 
   template <typename T>
@@ -191,6 +260,54 @@ class JPetParamBank: public TObject
           target[c.first] = new T(*c.second);
       }
   }
+
+  /// ids above this limit are looked up in the maps only
+  static const int kMaxIndexedID = 1 << 16;
+
+  template <typename T>
+  static void addToIndex(std::vector<T*>& index, int id, T* object)
+  {
+    if (id < 0 || id >= kMaxIndexedID) return;
+    if (id >= (int)index.size()) index.resize(id + 1, 0);
+    index[id] = object;
+  }
+
+  template <typename T>
+  static void buildIndex(std::vector<T*>& index, const std::map<int, T*>& objects)
+  {
+    index.clear();
+    for (auto & c : objects) {
+      addToIndex(index, c.first, c.second);
+    }
+  }
+
+  /// Like std::map::at, throws std::out_of_range if there is no object with the id
+  template <typename T>
+  static T& at(const std::vector<T*>& index, const std::map<int, T*>& objects, int id)
+  {
+    if (id >= 0 && id < (int)index.size() && index[id]) return *index[id];
+    return *objects.at(id);
+  }
+
+  template <typename T>
+  static T* findInIndex(const std::vector<T*>& index, const std::map<int, T*>& objects, int id)
+  {
+    if (id >= 0 && id < (int)index.size() && index[id]) return index[id];
+    auto it = objects.find(id);
+    return it != objects.end() ? it->second : 0;
+  }
 };
 
+#ifndef __CINT__
+template <> inline JPetScin* JPetParamBank::find<JPetScin>(int id) const { return findInIndex(fScintillatorsIndex, fScintillators, id); }
+template <> inline JPetPM* JPetParamBank::find<JPetPM>(int id) const { return findInIndex(fPMsIndex, fPMs, id); }
+template <> inline JPetPMCalib* JPetParamBank::find<JPetPMCalib>(int id) const { return findInIndex(fPMCalibsIndex, fPMCalibs, id); }
+template <> inline JPetFEB* JPetParamBank::find<JPetFEB>(int id) const { return findInIndex(fFEBsIndex, fFEBs, id); }
+template <> inline JPetTRB* JPetParamBank::find<JPetTRB>(int id) const { return findInIndex(fTRBsIndex, fTRBs, id); }
+template <> inline JPetBarrelSlot* JPetParamBank::find<JPetBarrelSlot>(int id) const { return findInIndex(fBarrelSlotsIndex, fBarrelSlots, id); }
+template <> inline JPetLayer* JPetParamBank::find<JPetLayer>(int id) const { return findInIndex(fLayersIndex, fLayers, id); }
+template <> inline JPetFrame* JPetParamBank::find<JPetFrame>(int id) const { return findInIndex(fFramesIndex, fFrames, id); }
+template <> inline JPetTOMBChannel* JPetParamBank::find<JPetTOMBChannel>(int id) const { return findInIndex(fTOMBChannelsIndex, fTOMBChannels, id); }
+#endif /* __CINT__ */
+
 #endif /*  !JPETPARAMBANK_H */
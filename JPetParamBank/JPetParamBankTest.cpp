@@ -4,7 +4,11 @@
 #include <TFile.h>
 
 #include "../JPetParamBank/JPetParamBank.h"
+#include "../JPetPhysSignal/JPetPhysSignal.h"
+#include "../JPetHit/JPetHit.h"
 #include <boost/lexical_cast.hpp>
+#include <chrono>
+#include <map>
 #include <boost/regex.hpp>
 
 BOOST_AUTO_TEST_SUITE(JPetParamBankTestSuite)
@@ -308,5 +312,175 @@ BOOST_AUTO_TEST_CASE( saving_reading_file )
 }
 
 
+BOOST_AUTO_TEST_CASE(findTest)
+{
+  JPetParamBank bank;
+  JPetScin scint(111, 8.f, 2.f, 4.f, 8.f);
+  JPetBarrelSlot barrelSlot(1, true, "barrelSlotTest", 35.f, 6);
+  JPetBarrelSlot farSlot(100000, true, "notIndexed", 35.f, 6);
+  bank.addScintillator(scint);
+  bank.addBarrelSlot(barrelSlot);
+  bank.addBarrelSlot(farSlot);
+
+  BOOST_REQUIRE(bank.find<JPetScin>(111) == &bank.getScintillator(111));
+  BOOST_REQUIRE(bank.find<JPetBarrelSlot>(1) == &bank.getBarrelSlot(1));
+  BOOST_REQUIRE(bank.find<JPetBarrelSlot>(100000) == &bank.getBarrelSlot(100000));
+  BOOST_REQUIRE(bank.find<JPetScin>(112) == 0);
+  BOOST_REQUIRE(bank.find<JPetPM>(1) == 0);
+
+  JPetParamBank copy(bank);
+  BOOST_REQUIRE(copy.find<JPetScin>(111) == &copy.getScintillator(111));
+
+  bank.clear();
+  BOOST_REQUIRE(bank.find<JPetScin>(111) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(resolveTest)
+{
+  JPetParamBank bank;
+  JPetBarrelSlot barrelSlot(1, true, "barrelSlotTest", 35.f, 6);
+  JPetPM pm(JPetPM::SideB, 222, 32, 64, std::make_pair(16.f, 32.f));
+  bank.addBarrelSlot(barrelSlot);
+  bank.addPM(pm);
+
+  JPetPhysSignal signal;
+  signal.setPM(pm);
+  signal.setBarrelSlot(barrelSlot);
+
+  // without an active bank the TRefs are used
+  JPetParamBank::setActive(0);
+  BOOST_REQUIRE(&signal.getPM() == &pm);
+  BOOST_REQUIRE(&signal.getBarrelSlot() == &barrelSlot);
+
+  JPetParamBank::setActive(&bank);
+  BOOST_REQUIRE(JPetParamBank::getActive() == &bank);
+  BOOST_REQUIRE(&signal.getPM() == &bank.getPM(222));
+  BOOST_REQUIRE(&signal.getBarrelSlot() == &bank.getBarrelSlot(1));
+
+  // an object missing in the active bank is still found through its TRef
+  JPetScin scint(111, 8.f, 2.f, 4.f, 8.f);
+  JPetHit hit;
+  hit.setScintillator(scint);
+  BOOST_REQUIRE(&hit.getScintillator() == &scint);
+
+  JPetParamBank::setActive(0);
+}
+
+namespace
+{
+/// Groups the signals of a time window by barrel slot and side, as the hit matching does
+std::map<int, std::pair<int, int> > groupBySlot(const std::vector<JPetPhysSignal>& signals)
+{
+  std::map<int, std::pair<int, int> > slots;
+  for (const auto& signal : signals) {
+    auto& counts = slots[signal.getBarrelSlot().getID()];
+    if (signal.getPM().getSide() == JPetPM::SideA) {
+      counts.first++;
+    } else {
+      counts.second++;
+    }
+  }
+  return slots;
+}
+
+const int kNbOfSlots = 192;
+
+/// Slots 1 ... kNbOfSlots, each with the PMs 2 * slot - 1 (side A) and 2 * slot (side B)
+void fillFullBarrel(JPetParamBank& bank)
+{
+  for (int slot = 1; slot <= kNbOfSlots; slot++) {
+    bank.addBarrelSlot(JPetBarrelSlot(slot, true, "slot", 0.f, slot));
+    bank.addPM(JPetPM(JPetPM::SideA, 2 * slot - 1, 0, 0, std::make_pair(0.f, 0.f)));
+    bank.addPM(JPetPM(JPetPM::SideB, 2 * slot, 0, 0, std::make_pair(0.f, 0.f)));
+  }
+}
+}
+
+BOOST_AUTO_TEST_CASE(fullBarrelMatchingTimeTest)
+{
+  const int kNbOfSignals = 20000;
+  const int kNbOfWindows = 20;
+
+  JPetParamBank bank;
+  fillFullBarrel(bank);
+
+  std::vector<JPetPhysSignal> signals(kNbOfSignals);
+  for (int i = 0; i < kNbOfSignals; i++) {
+    const int pmID = i % (2 * kNbOfSlots) + 1;
+    signals[i].setPM(bank.getPM(pmID));
+    signals[i].setBarrelSlot(bank.getBarrelSlot((pmID + 1) / 2));
+  }
+
+  std::map<int, std::pair<int, int> > byRef;
+  std::map<int, std::pair<int, int> > byID;
+  JPetParamBank::setActive(0);
+  auto start = std::chrono::steady_clock::now();
+  for (int w = 0; w < kNbOfWindows; w++) {
+    byRef = groupBySlot(signals);
+  }
+  auto refTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  JPetParamBank::setActive(&bank);
+  start = std::chrono::steady_clock::now();
+  for (int w = 0; w < kNbOfWindows; w++) {
+    byID = groupBySlot(signals);
+  }
+  auto idTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  JPetParamBank::setActive(0);
+
+  BOOST_TEST_MESSAGE("Grouping " << kNbOfWindows << " windows of " << kNbOfSignals << " signals: "
+                     << refTime << " ms through TRef, " << idTime << " ms through the param bank");
+  BOOST_REQUIRE(byRef == byID);
+  BOOST_REQUIRE(byID.size() == kNbOfSlots);
+  BOOST_REQUIRE(byID[1].first + byID[1].second > 0);
+}
+
+BOOST_AUTO_TEST_CASE(lookupTest)
+{
+  JPetParamBank bank;
+  JPetBarrelSlot barrelSlot(1, true, "barrelSlotTest", 35.f, 6);
+  JPetBarrelSlot farSlot(100000, true, "notIndexed", 35.f, 6);
+  JPetBarrelSlot& added = bank.addBarrelSlot(barrelSlot);
+  bank.addBarrelSlot(farSlot);
+
+  BOOST_REQUIRE(&added == bank.getBarrelSlots().at(1));
+  BOOST_REQUIRE(&bank.getBarrelSlot(1) == &added);
+  BOOST_REQUIRE(&bank.getBarrelSlot(100000) == bank.getBarrelSlots().at(100000));
+  BOOST_CHECK_THROW(bank.getBarrelSlot(2), std::out_of_range);
+  BOOST_CHECK_THROW(bank.getBarrelSlot(-1), std::out_of_range);
+  BOOST_CHECK_THROW(bank.getPM(1), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(perHitLookupTimeTest)
+{
+  const int kNbOfLookups = 1000000;
+
+  JPetParamBank bank;
+  fillFullBarrel(bank);
+
+  // a hit needs its slot and the PMs of both sides
+  long byMap = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kNbOfLookups; i++) {
+    const int slot = i % kNbOfSlots + 1;
+    byMap += bank.getBarrelSlots().at(slot)->getID();
+    byMap += bank.getPMs().at(2 * slot - 1)->getID() + bank.getPMs().at(2 * slot)->getID();
+  }
+  auto mapTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  long byIndex = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kNbOfLookups; i++) {
+    const int slot = i % kNbOfSlots + 1;
+    byIndex += bank.getBarrelSlot(slot).getID();
+    byIndex += bank.getPM(2 * slot - 1).getID() + bank.getPM(2 * slot).getID();
+  }
+  auto indexTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  BOOST_TEST_MESSAGE("Looking up " << kNbOfLookups << " hits: " << mapTime << " ms through the maps, "
+                     << indexTime << " ms through the id index");
+  BOOST_REQUIRE(byMap == byIndex);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -26,6 +26,7 @@
 typedef std::map<std::string, std::string> ParamObjectDescription;
 typedef std::map<int, ParamObjectDescription> ParamObjectsDescriptions;
 typedef std::map<int, int> ParamRelationalData;
+typedef std::map<ParamObjectType, ParamObjectsDescriptions> ParamRunDescriptions;
 
 /**
  * @brief An interface classes can implement to return JPetParamBank objects.
@@ -35,6 +36,9 @@ class JPetParamGetter
 public:
   virtual ParamObjectsDescriptions getAllBasicData(ParamObjectType type, const int runId) = 0;
   virtual ParamRelationalData getAllRelationalData(ParamObjectType type1, ParamObjectType type2, const int runId) = 0;
+  /// Identifies the contents of the parameter source, used as the key of the param bank cache.
+  /// An empty key means the source cannot be identified and the banks are not cached.
+  virtual std::string getSourceKey() { return ""; }
 
   virtual ~JPetParamGetter() {};
 
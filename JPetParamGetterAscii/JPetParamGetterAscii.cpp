@@ -15,87 +15,175 @@
 
 #include "./JPetParamGetterAscii.h"
 #include "./JPetParamAsciiConstants.h"
+#include "./JPetParamSnapshot.h"
 #include "../JPetParamBank/JPetParamBank.h"
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <boost/crc.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
+namespace
+{
+/// One parameter file read by the getters, either json or a binary snapshot
+struct ParamFile {
+  std::time_t fModified;
+  boost::property_tree::ptree fTree;
+  JPetParamSnapshot fSnapshot;
+  std::map<int, ParamRunDescriptions> fRuns; ///< runs prepared so far
+  std::set<int> fMissingRuns;
+};
+
+std::mutex gCacheMutex;
+std::map<std::string, std::unique_ptr<ParamFile> > gParamFiles;
+
+/// Must be called with gCacheMutex locked, returns 0 if the file does not exist
+ParamFile* getParamFile(const std::string& filename)
+{
+  if (!boost::filesystem::exists(filename)) {
+    gParamFiles.erase(filename);
+    return 0;
+  }
+  std::time_t modified = boost::filesystem::last_write_time(filename);
+  auto cached = gParamFiles.find(filename);
+  if (cached != gParamFiles.end() && cached->second->fModified == modified) {
+    return cached->second.get();
+  }
+  std::unique_ptr<ParamFile> file(new ParamFile());
+  file->fModified = modified;
+  if (JPetParamSnapshot::isSnapshot(filename)) {
+    file->fSnapshot.open(filename);
+  } else {
+    boost::property_tree::read_json(filename, file->fTree);
+  }
+  ParamFile* result = file.get();
+  gParamFiles[filename] = std::move(file);
+  return result;
+}
+
+/// Must be called with gCacheMutex locked, returns 0 if there is no such run in the file
+const ParamRunDescriptions* getRun(ParamFile& file, const int runId)
+{
+  auto prepared = file.fRuns.find(runId);
+  if (prepared != file.fRuns.end()) {
+    return &prepared->second;
+  }
+  if (file.fMissingRuns.count(runId)) {
+    return 0;
+  }
+  if (file.fSnapshot.isOpen()) {
+    ParamRunDescriptions run;
+    if (file.fSnapshot.readRun(runId, run)) {
+      return &(file.fRuns[runId] = run);
+    }
+  } else if (auto possibleRunContents = file.fTree.get_child_optional(boost::lexical_cast<std::string>(runId))) {
+    return &(file.fRuns[runId] = JPetParamGetterAscii::toRunDescriptions(*possibleRunContents));
+  }
+  file.fMissingRuns.insert(runId);
+  return 0;
+}
+}
+
 ParamObjectsDescriptions JPetParamGetterAscii::getAllBasicData(ParamObjectType type, const int runId)
 {
-  std::string runNumberS = boost::lexical_cast<std::string>(runId);
-  std::string objectsName = objectsNames.at(type);
   ParamObjectsDescriptions result;
-  if (boost::filesystem::exists(filename)) {
-    boost::property_tree::ptree dataFromFile;
-    boost::property_tree::read_json(filename, dataFromFile);
-    if (auto possibleRunContents = dataFromFile.get_child_optional(runNumberS)) {
-      auto runContents = *possibleRunContents;
-      if (auto possibleInfos = runContents.get_child_optional(objectsName)) {
-        auto infos = * possibleInfos;
-        for (auto infoRaw : infos) {
-          auto info = infoRaw.second;
-          ParamObjectDescription description = toDescription(info);
-          int id;
-          if (type == kTOMBChannel) {
-            id = boost::lexical_cast<int>(description["channel"]);
-          } else {
-            id = boost::lexical_cast<int>(description["id"]);
-          }
-          result[id] = description;
-        }
-      }  else {
-        ERROR(std::string("No ")+objectsName+" in the specified run.");
-      }
-    } else {
-      ERROR(std::string("No run with such id:") + runNumberS);
-    }
-  } else {
-    ERROR(std::string("Input file does not exist:") + filename);
+  std::lock_guard<std::mutex> lock(gCacheMutex);
+  if (auto descriptions = getDescriptions(type, runId)) {
+    result = *descriptions;
   }
   return result;
 }
 
 ParamRelationalData JPetParamGetterAscii::getAllRelationalData(ParamObjectType type1, ParamObjectType type2, const int runId)
 {
-  std::string runNumberS = boost::lexical_cast<std::string>(runId);
-  std::string objectsName = objectsNames.at(type1);
   std::string fieldName = objectsNames.at(type2)+"_id";
   ParamRelationalData result;
-  if (boost::filesystem::exists(filename)) {
-    boost::property_tree::ptree dataFromFile;
-    boost::property_tree::read_json(filename, dataFromFile);
-    if (auto possibleRunContents = dataFromFile.get_child_optional(runNumberS)) {
-      auto runContents = *possibleRunContents;
-      if (auto possibleInfos = runContents.get_child_optional(objectsName)) {
-        auto infos = * possibleInfos;
-        for (auto infoRaw : infos) {
-          auto info = infoRaw.second;
-          ParamObjectDescription description = toDescription(info);
-          int id;
-          if (type1 == kTOMBChannel) {
-            id = boost::lexical_cast<int>(description["channel"]);
-          } else {
-            id = boost::lexical_cast<int>(description["id"]);
-          }
-          int otherId = boost::lexical_cast<int>(description[fieldName]);
-          result[id] = otherId;
+  std::lock_guard<std::mutex> lock(gCacheMutex);
+  if (auto descriptions = getDescriptions(type1, runId)) {
+    for (const auto & description : *descriptions) {
+      auto field = description.second.find(fieldName);
+      int otherId = boost::lexical_cast<int>(field != description.second.end() ? field->second : std::string());
+      result[description.first] = otherId;
+    }
+  }
+  return result;
+}
+
+std::string JPetParamGetterAscii::getSourceKey()
+{
+  std::ifstream file(filename.c_str(), std::ios::binary);
+  if (!file) {
+    return "";
+  }
+  std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  boost::crc_32_type crc;
+  crc.process_bytes(contents.data(), contents.size());
+  std::ostringstream key;
+  key << "ascii_" << std::hex << crc.checksum() << "_" << contents.size();
+  return key.str();
+}
+
+/**
+ * Must be called with gCacheMutex locked.
+ * Returns 0 and logs the reason if the objects of the type are not available.
+ */
+const ParamObjectsDescriptions* JPetParamGetterAscii::getDescriptions(ParamObjectType type, const int runId)
+{
+  ParamFile* file = getParamFile(filename);
+  if (!file) {
+    ERROR(std::string("Input file does not exist:") + filename);
+    return 0;
+  }
+  const ParamRunDescriptions* run = getRun(*file, runId);
+  if (!run) {
+    ERROR(std::string("No run with such id:") + boost::lexical_cast<std::string>(runId));
+    return 0;
+  }
+  auto objects = run->find(type);
+  if (objects == run->end()) {
+    ERROR(std::string("No ")+objectsNames.at(type)+" in the specified run.");
+    return 0;
+  }
+  return &objects->second;
+}
+
+ParamRunDescriptions JPetParamGetterAscii::toRunDescriptions(const boost::property_tree::ptree & runContents)
+{
+  ParamRunDescriptions result;
+  for (const auto & objectsName : objectsNames) {
+    if (auto possibleInfos = runContents.get_child_optional(objectsName.second)) {
+      ParamObjectsDescriptions & descriptions = result[objectsName.first];
+      for (const auto & infoRaw : *possibleInfos) {
+        ParamObjectDescription description = toDescription(infoRaw.second);
+        int id;
+        if (objectsName.first == kTOMBChannel) {
+          id = boost::lexical_cast<int>(description["channel"]);
+        } else {
+          id = boost::lexical_cast<int>(description["id"]);
         }
-      }  else {
-        ERROR(std::string("No ")+objectsName+" in the specified run.");
+        descriptions[id] = description;
       }
-    } else {
-      ERROR(std::string("No run with such id:") + runNumberS);
     }
-  } else {
-    ERROR(std::string("Input file does not exist:") + filename);
   }
   return result;
 }
 
-ParamObjectDescription JPetParamGetterAscii::toDescription(boost::property_tree::ptree & info)
+void JPetParamGetterAscii::clearCache(const std::string & filename)
+{
+  std::lock_guard<std::mutex> lock(gCacheMutex);
+  gParamFiles.erase(filename);
+}
+
+ParamObjectDescription JPetParamGetterAscii::toDescription(const boost::property_tree::ptree & info)
 {
   ParamObjectDescription description;
-  for (auto value : info) {
+  for (const auto & value : info) {
     std::string val = value.second.get_value<std::string>();
     // Ugly hack since boost::lexical_cast does not understand booleans properly.
     if (val == "true") {
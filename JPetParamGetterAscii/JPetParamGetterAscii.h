@@ -21,6 +21,12 @@
 #include <boost/property_tree/ptree.hpp>
 #include "../JPetParamGetter/JPetParamGetter.h"
 
+/**
+ * @brief Reads the parameters from a local json file or from its binary snapshot (see JPetParamSnapshot).
+ *
+ * A file is parsed once per program and shared by all the getters reading it,
+ * the descriptions of a run are prepared on its first request.
+ */
 class JPetParamGetterAscii : public JPetParamGetter
 {
   public:
@@ -28,12 +34,20 @@ class JPetParamGetterAscii : public JPetParamGetter
     ~JPetParamGetterAscii() {}
     ParamObjectsDescriptions getAllBasicData(ParamObjectType type, const int runId);
     ParamRelationalData getAllRelationalData(ParamObjectType type1, ParamObjectType type2, const int runId);
+    /// The checksum of the contents of the file
+    std::string getSourceKey();
+
+    /// The descriptions of all the objects of one run of a json file
+    static ParamRunDescriptions toRunDescriptions(const boost::property_tree::ptree & runContents);
+    /// Forgets the parsed contents of the file, to be called when it is rewritten
+    static void clearCache(const std::string & filename);
 
   private:
     JPetParamGetterAscii(const JPetParamGetterAscii &paramGetterAscii);
     JPetParamGetterAscii& operator=(const JPetParamGetterAscii &paramGetterAscii);
 
-    ParamObjectDescription toDescription(boost::property_tree::ptree & info);
+    static ParamObjectDescription toDescription(const boost::property_tree::ptree & info);
+    const ParamObjectsDescriptions* getDescriptions(ParamObjectType type, const int runId);
 
     std::string filename;
 
@@ -4,6 +4,7 @@
 
 #include "../JPetParamGetterAscii/JPetParamGetterAscii.h"
 #include "../JPetParamGetterAscii/JPetParamSaverAscii.h"
+#include "../JPetParamGetterAscii/JPetParamSnapshot.h"
 #include "../JPetParamManager/JPetParamManager.h"
 #include <boost/filesystem.hpp>
 
@@ -146,4 +147,81 @@ BOOST_AUTO_TEST_CASE( minimal_example_write )
   boost::filesystem::remove(writtenFileName);
 }
 
+BOOST_AUTO_TEST_CASE( snapshot_conversion )
+{
+  std::string snapshotFileName(dataDir+"DB1.bin");
+  JPetParamSaverAscii saver;
+  BOOST_REQUIRE(saver.convertToSnapshot(dataDir+"DB1.json", snapshotFileName));
+  BOOST_REQUIRE(JPetParamSnapshot::isSnapshot(snapshotFileName));
+  BOOST_REQUIRE(!JPetParamSnapshot::isSnapshot(dataDir+"DB1.json"));
+
+  JPetParamGetterAscii jsonGetter(dataDir+"DB1.json");
+  JPetParamGetterAscii snapshotGetter(snapshotFileName);
+  for (int type = 0; type < ParamObjectType::SIZE; type++) {
+    BOOST_REQUIRE(jsonGetter.getAllBasicData(ParamObjectType(type), 1) == snapshotGetter.getAllBasicData(ParamObjectType(type), 1));
+  }
+  BOOST_REQUIRE(jsonGetter.getAllRelationalData(ParamObjectType::kPM, ParamObjectType::kBarrelSlot, 1)
+                == snapshotGetter.getAllRelationalData(ParamObjectType::kPM, ParamObjectType::kBarrelSlot, 1));
+  BOOST_REQUIRE_EQUAL(snapshotGetter.getAllBasicData(ParamObjectType::kPM, 2).size(), 0);
+
+  boost::filesystem::remove(snapshotFileName);
+}
+
+BOOST_AUTO_TEST_CASE( snapshot_write )
+{
+  JPetParamManager paramManager(new JPetParamGetterAscii(dataDir+"DB1.json"));
+  paramManager.fillParameterBank(1);
+  const JPetParamBank & paramBank = paramManager.getParamBank();
+  std::string writtenFileName(dataDir+"writtenDB1.bin");
+  JPetParamSaverAscii saver;
+  saver.saveParamBankSnapshot(paramBank, 1, writtenFileName);
+  saver.saveParamBankSnapshot(paramBank, 2, writtenFileName);
+
+  JPetParamSnapshot snapshot;
+  BOOST_REQUIRE(snapshot.open(writtenFileName));
+  BOOST_REQUIRE(snapshot.hasRun(1));
+  BOOST_REQUIRE(snapshot.hasRun(2));
+  BOOST_REQUIRE(!snapshot.hasRun(3));
+
+  // the file is replaced, not truncated, so the mapped one can still be read
+  saver.saveParamBankSnapshot(paramBank, 3, writtenFileName);
+  ParamRunDescriptions mappedRun;
+  BOOST_REQUIRE(snapshot.readRun(1, mappedRun));
+  BOOST_REQUIRE(!mappedRun.empty());
+  snapshot.close();
+  BOOST_REQUIRE(snapshot.open(writtenFileName));
+  BOOST_REQUIRE(snapshot.hasRun(3));
+  snapshot.close();
+
+  JPetParamManager reparamManager(new JPetParamGetterAscii(writtenFileName));
+  reparamManager.fillParameterBank(2);
+  const JPetParamBank & reparamBank = reparamManager.getParamBank();
+  BOOST_REQUIRE(paramBank.getScintillatorsSize() == reparamBank.getScintillatorsSize());
+  BOOST_REQUIRE(paramBank.getBarrelSlotsSize() == reparamBank.getBarrelSlotsSize());
+  BOOST_REQUIRE(paramBank.getPMsSize() == reparamBank.getPMsSize());
+  BOOST_REQUIRE(paramBank.getFEBsSize() == reparamBank.getFEBsSize());
+  BOOST_REQUIRE(paramBank.getTOMBChannelsSize() == reparamBank.getTOMBChannelsSize());
+  BOOST_REQUIRE(paramBank.getTRBsSize() == reparamBank.getTRBsSize());
+  BOOST_REQUIRE(reparamBank.getPM(1).getScin() == reparamBank.getScintillator(1));
+  BOOST_REQUIRE(reparamBank.getTOMBChannel(1).getPM() == reparamBank.getPM(1));
+
+  boost::filesystem::remove(writtenFileName);
+}
+
+BOOST_AUTO_TEST_CASE( rewritten_file_is_read_again )
+{
+  std::string writtenFileName(dataDir+"rewrittenDB1.json");
+  JPetParamManager paramManager(new JPetParamGetterAscii(dataDir+"DB1.json"));
+  paramManager.fillParameterBank(1);
+  JPetParamSaverAscii saver;
+  saver.saveParamBank(paramManager.getParamBank(), 1, writtenFileName);
+
+  JPetParamGetterAscii getter(writtenFileName);
+  BOOST_REQUIRE_EQUAL(getter.getAllBasicData(ParamObjectType::kPM, 3).size(), 0);
+  saver.saveParamBank(paramManager.getParamBank(), 3, writtenFileName);
+  BOOST_REQUIRE_EQUAL(getter.getAllBasicData(ParamObjectType::kPM, 3).size(), 1);
+
+  boost::filesystem::remove(writtenFileName);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,8 @@
 
 #include "./JPetParamSaverAscii.h"
 #include "./JPetParamAsciiConstants.h"
+#include "./JPetParamGetterAscii.h"
+#include "./JPetParamSnapshot.h"
 #include "../JPetParamBank/JPetParamBank.h"
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
@@ -27,6 +29,44 @@ void JPetParamSaverAscii::saveParamBank(const JPetParamBank & bank, const int ru
   auto fileTree = getTreeFromFile(filename);
   addToTree(fileTree, bank, runNumberS);
   write_json(filename, fileTree);
+  JPetParamGetterAscii::clearCache(filename);
+}
+
+void JPetParamSaverAscii::saveParamBankSnapshot(const JPetParamBank & bank, const int runNumber, const std::string & filename)
+{
+  std::map<int, ParamRunDescriptions> runs;
+  JPetParamSnapshot snapshot;
+  if (JPetParamSnapshot::isSnapshot(filename) && snapshot.open(filename)) {
+    for (auto runId : snapshot.getRunIds()) {
+      snapshot.readRun(runId, runs[runId]);
+    }
+    snapshot.close();
+  }
+  if (runs.count(runNumber) != 0) {
+    WARNING("Overwriting parameters in run number " + boost::lexical_cast<std::string>(runNumber) + ". I hope you wanted to do that.");
+  }
+  boost::property_tree::ptree tree;
+  std::string runNumberS = boost::lexical_cast<std::string>(runNumber);
+  addToTree(tree, bank, runNumberS);
+  runs[runNumber] = JPetParamGetterAscii::toRunDescriptions(tree.get_child(runNumberS));
+  JPetParamSnapshot::write(filename, runs);
+  JPetParamGetterAscii::clearCache(filename);
+}
+
+bool JPetParamSaverAscii::convertToSnapshot(const std::string & jsonFilename, const std::string & snapshotFilename)
+{
+  if (!boost::filesystem::exists(jsonFilename)) {
+    ERROR(std::string("Input file does not exist:") + jsonFilename);
+    return false;
+  }
+  auto fileTree = getTreeFromFile(jsonFilename);
+  std::map<int, ParamRunDescriptions> runs;
+  for (const auto & run : fileTree) {
+    runs[boost::lexical_cast<int>(run.first)] = JPetParamGetterAscii::toRunDescriptions(run.second);
+  }
+  bool written = JPetParamSnapshot::write(snapshotFilename, runs);
+  JPetParamGetterAscii::clearCache(snapshotFilename);
+  return written;
 }
 
 boost::property_tree::ptree JPetParamSaverAscii::getTreeFromFile(const std::string & filename)
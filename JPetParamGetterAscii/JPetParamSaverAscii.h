@@ -26,6 +26,10 @@ class JPetParamSaverAscii
   public:
     JPetParamSaverAscii() {}
     void saveParamBank(const JPetParamBank & bank, const int runNumber, const std::string & filename);
+    /// Writes the bank as one run of a binary snapshot (see JPetParamSnapshot), the other runs of the file are kept
+    void saveParamBankSnapshot(const JPetParamBank & bank, const int runNumber, const std::string & filename);
+    /// Writes all the runs of a json parameter file into a binary snapshot
+    bool convertToSnapshot(const std::string & jsonFilename, const std::string & snapshotFilename);
 
   private:
     JPetParamSaverAscii(const JPetParamSaverAscii &paramSaver);
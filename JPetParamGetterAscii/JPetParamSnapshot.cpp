@@ -0,0 +1,238 @@
+/**
+ *  @copyright Copyright 2016 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetParamSnapshot.cpp
+ */
+
+#include "./JPetParamSnapshot.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char JPetParamSnapshot::kMagic[8] = {'J', 'P', 'e', 't', 'P', 'a', 'r', '1'};
+const char* const JPetParamSnapshot::kFileExtension = ".bin";
+
+namespace
+{
+const size_t kHeaderSize = sizeof(JPetParamSnapshot::kMagic) + 2 * sizeof(uint32_t);
+const size_t kRunEntrySize = 2 * sizeof(uint32_t) + ParamObjectType::SIZE * sizeof(uint64_t);
+
+template <class T>
+void append(std::string& buffer, T value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendString(std::string& buffer, const std::string& value)
+{
+  append(buffer, uint32_t(value.size()));
+  buffer.append(value);
+}
+
+template <class T>
+void put(std::string& buffer, size_t offset, T value)
+{
+  std::memcpy(&buffer[offset], &value, sizeof(value));
+}
+}
+
+JPetParamSnapshot::JPetParamSnapshot():
+  fFile(-1),
+  fData(0),
+  fSize(0)
+{
+}
+
+JPetParamSnapshot::~JPetParamSnapshot()
+{
+  close();
+}
+
+bool JPetParamSnapshot::isSnapshot(const std::string& filename)
+{
+  std::ifstream file(filename.c_str(), std::ios::binary);
+  char magic[sizeof(kMagic)];
+  return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool JPetParamSnapshot::write(const std::string& filename, const std::map<int, ParamRunDescriptions>& runs)
+{
+  std::string buffer(kMagic, sizeof(kMagic));
+  append(buffer, uint32_t(runs.size()));
+  append(buffer, uint32_t(0));
+  size_t table = buffer.size();
+  buffer.resize(table + runs.size() * kRunEntrySize, '\0');
+  for (const auto& run : runs) {
+    put(buffer, table, int32_t(run.first));
+    for (const auto& objects : run.second) {
+      put(buffer, table + 2 * sizeof(uint32_t) + objects.first * sizeof(uint64_t), uint64_t(buffer.size()));
+      append(buffer, uint32_t(objects.second.size()));
+      for (const auto& object : objects.second) {
+        append(buffer, int32_t(object.first));
+        append(buffer, uint32_t(object.second.size()));
+        for (const auto& field : object.second) {
+          appendString(buffer, field.first);
+          appendString(buffer, field.second);
+        }
+      }
+    }
+    table += kRunEntrySize;
+  }
+  // the file may still be mapped by a reader, it is replaced by a rename instead of being truncated
+  std::ostringstream temporaryFile;
+  temporaryFile << filename << "." << getpid() << "_" << std::hex
+                << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+  {
+    std::ofstream file(temporaryFile.str().c_str(), std::ios::binary | std::ios::trunc);
+    if (!file.write(buffer.data(), buffer.size()) || !file.flush()) {
+      ERROR("Could not write the parameter snapshot " + temporaryFile.str());
+      file.close();
+      std::remove(temporaryFile.str().c_str());
+      return false;
+    }
+  }
+  if (std::rename(temporaryFile.str().c_str(), filename.c_str()) != 0) {
+    ERROR("Could not move the parameter snapshot to " + filename);
+    std::remove(temporaryFile.str().c_str());
+    return false;
+  }
+  return true;
+}
+
+bool JPetParamSnapshot::open(const std::string& filename)
+{
+  close();
+  fFile = ::open(filename.c_str(), O_RDONLY);
+  if (fFile < 0) {
+    ERROR("Could not open the parameter snapshot " + filename);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fFile, &st) != 0 || size_t(st.st_size) < kHeaderSize) {
+    ERROR("Corrupted parameter snapshot " + filename);
+    close();
+    return false;
+  }
+  void* data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fFile, 0);
+  if (data == MAP_FAILED) {
+    ERROR("Could not map the parameter snapshot " + filename);
+    close();
+    return false;
+  }
+  fData = static_cast<const char*>(data);
+  fSize = st.st_size;
+
+  size_t offset = sizeof(kMagic);
+  unsigned int nRuns = 0;
+  if (std::memcmp(fData, kMagic, sizeof(kMagic)) != 0 || !readUInt32(offset, nRuns)
+      || kHeaderSize + size_t(nRuns) * kRunEntrySize > fSize) {
+    ERROR("Corrupted parameter snapshot " + filename);
+    close();
+    return false;
+  }
+  for (size_t i = 0; i < nRuns; i++) {
+    size_t entry = kHeaderSize + i * kRunEntrySize;
+    int32_t runId;
+    std::memcpy(&runId, fData + entry, sizeof(runId));
+    fRuns[runId] = entry;
+  }
+  return true;
+}
+
+void JPetParamSnapshot::close()
+{
+  if (fData) {
+    munmap(const_cast<char*>(fData), fSize);
+    fData = 0;
+  }
+  if (fFile >= 0) {
+    ::close(fFile);
+    fFile = -1;
+  }
+  fSize = 0;
+  fRuns.clear();
+}
+
+std::vector<int> JPetParamSnapshot::getRunIds() const
+{
+  std::vector<int> ids;
+  for (const auto& run : fRuns) {
+    ids.push_back(run.first);
+  }
+  return ids;
+}
+
+bool JPetParamSnapshot::readRun(int runId, ParamRunDescriptions& run) const
+{
+  auto entry = fRuns.find(runId);
+  if (entry == fRuns.end()) {
+    return false;
+  }
+  run.clear();
+  for (int type = 0; type < ParamObjectType::SIZE; type++) {
+    uint64_t offset;
+    std::memcpy(&offset, fData + entry->second + 2 * sizeof(uint32_t) + type * sizeof(uint64_t), sizeof(offset));
+    if (offset == 0) continue;
+    if (!readSection(offset, run[ParamObjectType(type)])) {
+      ERROR("Corrupted parameter snapshot, run " + std::to_string(runId));
+      run.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool JPetParamSnapshot::readSection(size_t offset, ParamObjectsDescriptions& descriptions) const
+{
+  unsigned int nObjects = 0;
+  if (!readUInt32(offset, nObjects)) return false;
+  for (unsigned int i = 0; i < nObjects; i++) {
+    unsigned int id = 0;
+    unsigned int nFields = 0;
+    if (!readUInt32(offset, id) || !readUInt32(offset, nFields)) return false;
+    ParamObjectDescription& description = descriptions[int(id)];
+    for (unsigned int j = 0; j < nFields; j++) {
+      std::string key;
+      std::string value;
+      if (!readString(offset, key) || !readString(offset, value)) return false;
+      description[key] = value;
+    }
+  }
+  return true;
+}
+
+bool JPetParamSnapshot::readUInt32(size_t& offset, unsigned int& value) const
+{
+  uint32_t raw;
+  if (offset + sizeof(raw) > fSize) return false;
+  std::memcpy(&raw, fData + offset, sizeof(raw));
+  offset += sizeof(raw);
+  value = raw;
+  return true;
+}
+
+bool JPetParamSnapshot::readString(size_t& offset, std::string& value) const
+{
+  unsigned int length = 0;
+  if (!readUInt32(offset, length) || offset + length > fSize) return false;
+  value.assign(fData + offset, length);
+  offset += length;
+  return true;
+}
@@ -0,0 +1,69 @@
+/**
+ *  @copyright Copyright 2016 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetParamSnapshot.h
+ */
+
+#ifndef JPETPARAMSNAPSHOT_H
+#define JPETPARAMSNAPSHOT_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include "../JPetParamGetter/JPetParamGetter.h"
+
+/**
+ * @brief Binary snapshot of the parameter descriptions of several runs.
+ *
+ * The snapshot holds the same descriptions as the json parameter file, so
+ * JPetParamGetterAscii can read either of them. The file is mapped into
+ * memory and only the requested run is decoded. Layout (native byte order):
+ *   header:    magic[8], uint32 number of runs, uint32 reserved
+ *   run table: per run int32 run id, uint32 reserved, uint64 offset of the section of every ParamObjectType (0 if absent)
+ *   section:   uint32 number of objects, per object int32 id, uint32 number of fields,
+ *              per field uint32 length + key, uint32 length + value
+ */
+class JPetParamSnapshot : private boost::noncopyable
+{
+public:
+  static const char kMagic[8];
+  /// Extension of the --localDBCreate file for which a snapshot is written instead of json
+  static const char* const kFileExtension;
+
+  static bool isSnapshot(const std::string& filename);
+  static bool write(const std::string& filename, const std::map<int, ParamRunDescriptions>& runs);
+
+  JPetParamSnapshot();
+  ~JPetParamSnapshot();
+
+  bool open(const std::string& filename);
+  void close();
+  bool isOpen() const { return fData != 0; }
+  std::vector<int> getRunIds() const;
+  bool hasRun(int runId) const { return fRuns.count(runId) != 0; }
+  /// Decodes all the object types of one run, false if there is no such run or the file is corrupted
+  bool readRun(int runId, ParamRunDescriptions& run) const;
+
+private:
+  bool readSection(size_t offset, ParamObjectsDescriptions& descriptions) const;
+  bool readUInt32(size_t& offset, unsigned int& value) const;
+  bool readString(size_t& offset, std::string& value) const;
+
+  int fFile;
+  const char* fData;
+  size_t fSize;
+  std::unordered_map<int, size_t> fRuns; ///< run id -> offset of its entry in the run table
+};
+
+#endif /*  !JPETPARAMSNAPSHOT_H */
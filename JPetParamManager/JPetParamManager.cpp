@@ -16,6 +16,12 @@
 #include "JPetParamManager.h"
 
 #include <TFile.h>
+#include <TStopwatch.h>
+#include <TSystem.h>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <boost/filesystem.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
 JPetParamManager::~JPetParamManager()
@@ -137,10 +143,20 @@ JPetTOMBChannelFactory & JPetParamManager::getTOMBChannelFactory(const int runId
 
 void JPetParamManager::fillParameterBank(const int run)
 {
+  TStopwatch timer;
   if (fBank) {
     delete fBank;
     fBank = 0;
   }
+  std::string cacheFile = getCacheFileName(run);
+  if (!cacheFile.empty() && boost::filesystem::exists(cacheFile)) {
+    if (readParametersFromFile(cacheFile)) {
+      INFO(Form("Parameter bank of run %d read from the cache %s in %.3f s", run, cacheFile.c_str(), timer.RealTime()));
+      return;
+    }
+    WARNING("Could not read the cached parameter bank " + cacheFile + ", it will be created again");
+    timer.Start();
+  }
   fBank = new JPetParamBank();
   for (auto & trbp : getTRBs(run)) {
     auto & trb = *trbp.second;
@@ -148,8 +164,7 @@ void JPetParamManager::fillParameterBank(const int run)
   }
   for (auto & febp : getFEBs(run)) {
     auto & feb = *febp.second;
-    fBank->addFEB(feb);
-    fBank->getFEB(feb.getID()).setTRB(fBank->getTRB(feb.getTRB().getID()));
+    fBank->addFEB(feb).setTRB(fBank->getTRB(feb.getTRB().getID()));
   }
   for (auto & framep : getFrames(run)) {
     auto & frame = *framep.second;
@@ -157,32 +172,76 @@ void JPetParamManager::fillParameterBank(const int run)
   }
   for (auto & layerp : getLayers(run)) {
     auto & layer = *layerp.second;
-    fBank->addLayer(layer);
-    fBank->getLayer(layer.getId()).setFrame(fBank->getFrame(layer.getFrame().getId()));
+    fBank->addLayer(layer).setFrame(fBank->getFrame(layer.getFrame().getId()));
   }
   for (auto & barrelSlotp : getBarrelSlots(run)) {
     auto & barrelSlot = *barrelSlotp.second;
-    fBank->addBarrelSlot(barrelSlot);
-    fBank->getBarrelSlot(barrelSlot.getID()).setLayer(fBank->getLayer(barrelSlot.getLayer().getId()));
+    fBank->addBarrelSlot(barrelSlot).setLayer(fBank->getLayer(barrelSlot.getLayer().getId()));
   }
   for (auto & scinp : getScins(run)) {
     auto & scin = *scinp.second;
-    fBank->addScintillator(scin);
-    fBank->getScintillator(scin.getID()).setBarrelSlot(fBank->getBarrelSlot(scin.getBarrelSlot().getID()));
+    fBank->addScintillator(scin).setBarrelSlot(fBank->getBarrelSlot(scin.getBarrelSlot().getID()));
   }
   for (auto & pmp : getPMs(run)) {
     auto & pm = *pmp.second;
-    fBank->addPM(pm);
-    fBank->getPM(pm.getID()).setFEB(fBank->getFEB(pm.getFEB().getID()));
-    fBank->getPM(pm.getID()).setScin(fBank->getScintillator(pm.getScin().getID()));
-    fBank->getPM(pm.getID()).setBarrelSlot(fBank->getBarrelSlot(pm.getBarrelSlot().getID()));
+    auto & bankPM = fBank->addPM(pm);
+    bankPM.setFEB(fBank->getFEB(pm.getFEB().getID()));
+    bankPM.setScin(fBank->getScintillator(pm.getScin().getID()));
+    bankPM.setBarrelSlot(fBank->getBarrelSlot(pm.getBarrelSlot().getID()));
   }
   for (auto & tombChannelp : getTOMBChannels(run)) {
     auto & tombChannel = *tombChannelp.second;
-    fBank->addTOMBChannel(tombChannel);
-    fBank->getTOMBChannel(tombChannel.getChannel()).setFEB(fBank->getFEB(tombChannel.getFEB().getID()));
-    fBank->getTOMBChannel(tombChannel.getChannel()).setTRB(fBank->getTRB(tombChannel.getTRB().getID()));
-    fBank->getTOMBChannel(tombChannel.getChannel()).setPM(fBank->getPM(tombChannel.getPM().getID()));
+    auto & bankChannel = fBank->addTOMBChannel(tombChannel);
+    bankChannel.setFEB(fBank->getFEB(tombChannel.getFEB().getID()));
+    bankChannel.setTRB(fBank->getTRB(tombChannel.getTRB().getID()));
+    bankChannel.setPM(fBank->getPM(tombChannel.getPM().getID()));
+  }
+  JPetParamBank::setActive(fBank);
+  INFO(Form("Parameter bank of run %d filled in %.3f s (%d PMs, %d TOMB channels)",
+            run, timer.RealTime(), fBank->getPMsSize(), fBank->getTOMBChannelsSize()));
+  if (!cacheFile.empty()) {
+    timer.Start();
+    saveParameterBankToCache(cacheFile);
+    INFO(Form("Parameter bank of run %d was not in the cache, saved to %s in %.3f s", run, cacheFile.c_str(), timer.RealTime()));
+  }
+}
+
+/// Empty if the cache is disabled or the source of the parameters cannot be identified
+std::string JPetParamManager::getCacheFileName(const int run)
+{
+  if (fCacheDirectory.empty()) {
+    return "";
+  }
+  std::string sourceKey = fParamGetter->getSourceKey();
+  if (sourceKey.empty()) {
+    return "";
+  }
+  return (boost::filesystem::path(fCacheDirectory) / ("paramBank_run" + std::to_string(run) + "_" + sourceKey + ".root")).string();
+}
+
+/**
+ * The bank is written to a temporary file which is then renamed, so that the
+ * processes and threads reading the cache at the same time never see a partial file.
+ */
+void JPetParamManager::saveParameterBankToCache(const std::string& cacheFile)
+{
+  boost::system::error_code error;
+  boost::filesystem::create_directories(fCacheDirectory, error);
+  std::string temporaryFile = cacheFile + Form(".%d_%zx.tmp", gSystem->GetPid(),
+                                               std::hash<std::thread::id>()(std::this_thread::get_id()));
+  {
+    TFile file(temporaryFile.c_str(), "RECREATE");
+    if (!file.IsOpen()) {
+      WARNING("Could not write the parameter bank to the cache " + temporaryFile);
+      return;
+    }
+    file.cd();
+    file.WriteObject(fBank, "ParamBank");
+    file.Close();
+  }
+  if (std::rename(temporaryFile.c_str(), cacheFile.c_str()) != 0) {
+    WARNING("Could not move the parameter bank to the cache " + cacheFile);
+    std::remove(temporaryFile.c_str());
   }
 }
 
@@ -196,6 +255,8 @@ bool JPetParamManager::readParametersFromFile(JPetReader * reader)
   fBank = static_cast<JPetParamBank*>(reader->getObjectFromFile("ParamBank"));
 
   if (!fBank) return false;
+  fBank->buildIndex();
+  JPetParamBank::setActive(fBank);
   return true;
 }
 
@@ -220,6 +281,8 @@ bool JPetParamManager::readParametersFromFile(std::string filename)
   fBank = static_cast<JPetParamBank*>(file.Get("ParamBank"));
 
   if (!fBank) return false;
+  fBank->buildIndex();
+  JPetParamBank::setActive(fBank);
   return true;
 }
 
@@ -239,6 +302,7 @@ bool JPetParamManager::getParametersFromScopeConfig(const std::string& scopeConf
   }
   fBank = fScopeParamGetter.generateParamBank(scopeConfFile);
   if (!fBank) return false;
+  JPetParamBank::setActive(fBank);
   return true;
 }
 
@@ -59,6 +59,11 @@ class JPetParamManager
 
     void fillParameterBank(const int run);
 
+    /// Directory in which fillParameterBank() keeps the banks, keyed by the run and the source of the parameters.
+    /// An empty name (default) disables the cache.
+    inline void setCacheDirectory(const std::string& directory) { fCacheDirectory = directory; }
+    inline const std::string& getCacheDirectory() const { return fCacheDirectory; }
+
     bool readParametersFromFile(JPetReader * reader);
     bool saveParametersToFile(JPetWriter * writer);
 
@@ -80,6 +85,10 @@ class JPetParamManager
     JPetParamGetter* fParamGetter;
     JPetParamBank* fBank;
     bool fIsNullObject;
+    std::string fCacheDirectory;
+
+    std::string getCacheFileName(const int run);
+    void saveParameterBankToCache(const std::string& cacheFile);
 
     std::map<int, JPetTRBFactory> fTRBFactories;
     std::map<int, JPetFEBFactory> fFEBFactories;
@@ -74,6 +74,33 @@ BOOST_AUTO_TEST_CASE(writeAndReadDataFromFileByFileNameTest)
   boost::filesystem::remove(testDatafile);
 }
 
+BOOST_AUTO_TEST_CASE(paramBankCacheTest)
+{
+  JPetDBParamGetter::clearParamCache();
+  JPetScopeParamGetter::clearParamCache();
+  std::string cacheDir = dataDir+"paramCache";
+  boost::filesystem::remove_all(cacheDir);
+
+  JPetParamManager first(new JPetParamGetterAscii(dataFileName));
+  first.setCacheDirectory(cacheDir);
+  first.fillParameterBank(1);
+  checkContainersSize(first.getParamBank());
+  BOOST_REQUIRE(boost::filesystem::exists(cacheDir));
+  BOOST_REQUIRE_EQUAL(std::distance(boost::filesystem::directory_iterator(cacheDir), boost::filesystem::directory_iterator()), 1);
+
+  // the second manager reads the bank from the cache
+  JPetParamManager second(new JPetParamGetterAscii(dataFileName));
+  second.setCacheDirectory(cacheDir);
+  second.fillParameterBank(1);
+  checkContainersSize(second.getParamBank());
+  for (auto & pm : second.getParamBank().getPMs()) {
+    BOOST_REQUIRE(&pm.second->getScin() == &second.getParamBank().getScintillator(pm.second->getScin().getID()));
+  }
+  BOOST_REQUIRE_EQUAL(std::distance(boost::filesystem::directory_iterator(cacheDir), boost::filesystem::directory_iterator()), 1);
+
+  boost::filesystem::remove_all(cacheDir);
+}
+
 BOOST_AUTO_TEST_CASE(some_Test_that_had_no_name)
 {
   JPetDBParamGetter::clearParamCache();
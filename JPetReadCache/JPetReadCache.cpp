@@ -0,0 +1,95 @@
+/**
+ *  @copyright Copyright 2016 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetReadCache.cpp
+ */
+
+#include "JPetReadCache.h"
+#include <TEnv.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <TTreeCache.h>
+#include <TH1F.h>
+#include "../JPetOptions/JPetOptions.h"
+#include "../JPetStatistics/JPetStatistics.h"
+#include "../JPetLoggerInclude.h"
+
+JPetReadCache::JPetReadCache():
+  fCacheSize(JPetOptions::kDefaultReadCacheSize),
+  fLearnEntries(kDefaultLearnEntries),
+  fFile(0),
+  fTree(0)
+{
+  fBlockedTimer.Reset();
+}
+
+void JPetReadCache::setAsyncPrefetching(bool async)
+{
+  gEnv->SetValue("TFile.AsyncPrefetching", async ? 1 : 0);
+}
+
+void JPetReadCache::attach(TFile* file, TTree* tree)
+{
+  fFile = file;
+  fTree = tree;
+  fBlockedTimer.Reset();
+  if (!fTree || fCacheSize <= 0) return;
+  fTree->SetCacheSize(fCacheSize);
+  fTree->SetCacheLearnEntries(fLearnEntries);
+  DEBUG(Form("TTreeCache of %lld bytes, learning phase of %d entries", fCacheSize, fLearnEntries));
+}
+
+void JPetReadCache::detach()
+{
+  fFile = 0;
+  fTree = 0;
+}
+
+double JPetReadCache::getCacheHitRatio() const
+{
+  if (!fFile || !fTree) return 0;
+  TTreeCache* cache = dynamic_cast<TTreeCache*>(fFile->GetCacheRead(fTree));
+  if (!cache) return 0;
+  return cache->GetEfficiency();
+}
+
+long long JPetReadCache::getReadCalls() const
+{
+  return fFile ? fFile->GetReadCalls() : 0;
+}
+
+double JPetReadCache::getMegabytesRead() const
+{
+  return fFile ? fFile->GetBytesRead() / (1024. * 1024.) : 0;
+}
+
+double JPetReadCache::getBlockedTime() const
+{
+  return fBlockedTimer.RealTime();
+}
+
+void JPetReadCache::fillStatistics(JPetStatistics& stats) const
+{
+  const double values[] = { getCacheHitRatio(), double(getReadCalls()), getMegabytesRead(), getBlockedTime() };
+  const char* names[] = { "IO cache hit ratio", "IO read calls", "IO MB read", "IO blocked time [s]" };
+  const int kNValues = 4;
+
+  TH1F* hist = new TH1F("read_statistics", "Reading of the input file", kNValues, 0, kNValues);
+  for (int i = 0; i < kNValues; i++) {
+    stats.getCounter(names[i]) = values[i];
+    hist->GetXaxis()->SetBinLabel(i + 1, names[i]);
+    hist->SetBinContent(i + 1, values[i]);
+  }
+  stats.createHistogram(hist);
+  INFO(Form("Input file read: cache hit ratio %.3f, %lld read calls, %.2f MB, %.2f s blocked on I/O",
+            values[0], getReadCalls(), values[2], values[3]));
+}
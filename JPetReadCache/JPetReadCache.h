@@ -0,0 +1,77 @@
+/**
+ *  @copyright Copyright 2016 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetReadCache.h
+ *  @brief Read cache settings and I/O counters of the input file of a reader
+ */
+
+#ifndef _JPET_READ_CACHE_H_
+#define _JPET_READ_CACHE_H_
+
+#include <TStopwatch.h>
+
+class TFile;
+class TTree;
+class JPetStatistics;
+
+/**
+ * @brief Sets up the TTreeCache of the input tree and measures the reading.
+ *
+ * The cache collects the baskets of many entries into a few large reads.
+ * During the first learn entries it records the branches which are actually
+ * read and afterwards prefetches only those. With the asynchronous
+ * prefetching the next cache block is read by a ROOT background thread
+ * while the current one is processed.
+ * Used by JPetReader and JPetHLDReader: attach() once the tree is loaded and
+ * detach() before it is closed.
+ */
+class JPetReadCache
+{
+public:
+  static const int kDefaultLearnEntries = 10;
+
+  JPetReadCache();
+
+  /// 0 disables the cache
+  inline void setCacheSize(long long bytes) { fCacheSize = bytes; }
+  inline long long getCacheSize() const { return fCacheSize; }
+  inline void setLearnEntries(int entries) { fLearnEntries = entries; }
+  inline int getLearnEntries() const { return fLearnEntries; }
+
+  /// The asynchronous prefetching is a process-wide ROOT setting read when a TFile is created,
+  /// so it is set once at startup, before any file is opened by the file threads
+  static void setAsyncPrefetching(bool async);
+
+  void attach(TFile* file, TTree* tree);
+  void detach();
+
+  /// The time between startRead() and stopRead() is counted as blocked on I/O
+  inline void startRead() { fBlockedTimer.Start(kFALSE); }
+  inline void stopRead() { fBlockedTimer.Stop(); }
+
+  double getCacheHitRatio() const;
+  long long getReadCalls() const;
+  double getMegabytesRead() const;
+  double getBlockedTime() const;
+
+  /// Stores the counters of the current file as counters and as the "read_statistics" histogram
+  void fillStatistics(JPetStatistics& stats) const;
+
+private:
+  long long fCacheSize;
+  int fLearnEntries;
+  TFile* fFile;
+  TTree* fTree;
+  mutable TStopwatch fBlockedTimer;
+};
+
+#endif
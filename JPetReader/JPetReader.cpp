@@ -23,7 +23,10 @@ JPetReader::JPetReader() :
   fEvent(0),
   fTree(0),
   fFile(0),
-  fCurrentEventNumber(-1)
+  fCurrentEventNumber(-1),
+  fLoadedEventNumber(-1),
+  fReadEntries(0),
+  fReadBytes(0)
 {/**/}
 
 JPetReader::JPetReader(const char* p_filename) :
@@ -31,7 +34,10 @@ JPetReader::JPetReader(const char* p_filename) :
   fEvent(0),
   fTree(0),
   fFile(0),
-  fCurrentEventNumber(-1)
+  fCurrentEventNumber(-1),
+  fLoadedEventNumber(-1),
+  fReadEntries(0),
+  fReadBytes(0)
 {
   if (!openFileAndLoadData(p_filename, "tree")) {
     ERROR("error in opening file");
@@ -56,10 +62,18 @@ JPetReader::MyEvent& JPetReader::getCurrentEvent()
       delete fEvent;
     }
     fEvent = new TNamed("Empty event", "Empty event");
+    fLoadedEventNumber = -1;
   }
   return *fEvent;
 }
 
+JPetReader::MyEvent* JPetReader::readEvent(long long n)
+{
+  fCurrentEventNumber = n;
+  if (loadCurrentEvent()) return fEvent;
+  return 0;
+}
+
 bool JPetReader::JPetReader::nextEvent()
 {
   fCurrentEventNumber++;
@@ -86,12 +100,16 @@ bool JPetReader::nthEvent(int n)
 
 void JPetReader::closeFile ()
 {
+  fReadCache.detach();
   if (fFile) delete fFile;
   fFile = 0;
   fBranch = 0;
   fEvent = 0;
   fTree = 0;
   fCurrentEventNumber = -1;
+  fLoadedEventNumber = -1;
+  fReadEntries = 0;
+  fReadBytes = 0;
 }
 
 
@@ -128,6 +146,8 @@ bool JPetReader::loadData(const char* treename)
     return false;
   }
   fBranch->SetAddress(&fEvent);
+  fLoadedEventNumber = -1;
+  fReadCache.attach(fFile, fTree);
   firstEvent();
   return true;
 }
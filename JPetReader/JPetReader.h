@@ -36,6 +36,7 @@ class boost::noncopyable;
 */
 #include "../JPetTreeHeader/JPetTreeHeader.h"
 #include "../JPetReaderInterface/JPetReaderInterface.h"
+#include "../JPetReadCache/JPetReadCache.h"
 
 #include "../JPetLoggerInclude.h"
 
@@ -56,9 +57,19 @@ public:
   virtual bool firstEvent();
   virtual bool lastEvent();
   virtual bool nthEvent(int n);
+  virtual JPetReaderInterface::MyEvent* readEvent(long long n);
   virtual long long getCurrentEventNumber() const {
     return fCurrentEventNumber;
   }
+  virtual long long getNbOfReadEntries() const {
+    return fReadEntries;
+  }
+  virtual long long getNbOfReadBytes() const {
+    return fReadBytes;
+  }
+  virtual JPetReadCache& getReadCache() {
+    return fReadCache;
+  }
   virtual long long getNbOfAllEvents() const {
     return fTree ? fTree->GetEntries() : 0;
   }
@@ -84,10 +95,19 @@ public:
 protected:
   virtual bool openFile(const char* filename);
   virtual bool loadData(const char* treename = "tree");
+  /// Reads the current entry, unless it is the one already loaded into fEvent.
   bool loadCurrentEvent() {
     if (fTree) {
+      if (fCurrentEventNumber == fLoadedEventNumber) return true;
+      fLoadedEventNumber = -1;
+      fReadCache.startRead();
       int entryCode = fTree->GetEntry(fCurrentEventNumber);
-      return isCorrectTreeEntryCode(entryCode);
+      fReadCache.stopRead();
+      fReadEntries++;
+      if (!isCorrectTreeEntryCode(entryCode)) return false;
+      fReadBytes += entryCode;
+      fLoadedEventNumber = fCurrentEventNumber;
+      return true;
     } 
     return false;
   }
@@ -104,6 +124,10 @@ protected:
   TTree* fTree;
   TFile* fFile;
   long long fCurrentEventNumber;
+  long long fLoadedEventNumber;
+  long long fReadEntries;
+  long long fReadBytes;
+  JPetReadCache fReadCache;
 };
 
 #endif	// JPETREADER_H
@@ -9,6 +9,7 @@
 
 #include "../JPetReader/JPetReader.h"
 #include "../JPetWriter/JPetWriter.h"
+#include "../JPetStatistics/JPetStatistics.h"
 
 // method list
   //JPetReader(void); //maybe remove this one
@@ -127,4 +128,53 @@ BOOST_AUTO_TEST_CASE (good_file_closeFile)
   BOOST_REQUIRE(!reader.getObjectFromFile("testObj"));
 }
 
+BOOST_AUTO_TEST_CASE (readEventReadsEveryEntryOnce)
+{
+  JPetReader reader("unitTestData/JPetReaderTest/small.root");
+  BOOST_REQUIRE(reader.isOpen());
+  // the first entry is loaded when the file is opened
+  BOOST_REQUIRE_EQUAL(reader.getNbOfReadEntries(), 1);
+  const long long nEvents = reader.getNbOfAllEvents();
+  for (long long i = 0; i < nEvents; i++) {
+    JPetReader::MyEvent* event = reader.readEvent(i);
+    BOOST_REQUIRE(event);
+    BOOST_REQUIRE(event == &reader.getCurrentEvent());
+    BOOST_REQUIRE(std::string(event->GetName()) == std::string("JPetTSlot"));
+    BOOST_REQUIRE_EQUAL(reader.getCurrentEventNumber(), i);
+  }
+  BOOST_REQUIRE_EQUAL(reader.getNbOfReadEntries(), nEvents);
+  BOOST_REQUIRE(reader.getNbOfReadBytes() > 0);
+  BOOST_TEST_MESSAGE("GetEntry calls per event: " << reader.getNbOfReadEntries() / double(nEvents)
+                     << ", bytes read per event: " << reader.getNbOfReadBytes() / double(nEvents));
+  BOOST_REQUIRE(!reader.readEvent(nEvents));
+
+  // the old getCurrentEvent()/nextEvent() loop does not read the entries twice either
+  reader.closeFile();
+  BOOST_REQUIRE(reader.openFileAndLoadData("unitTestData/JPetReaderTest/small.root", "tree"));
+  for (long long i = 0; i < nEvents; i++) {
+    reader.getCurrentEvent();
+    reader.nextEvent();
+  }
+  BOOST_REQUIRE_EQUAL(reader.getNbOfReadEntries(), nEvents + 1);
+}
+
+BOOST_AUTO_TEST_CASE (readCacheStatistics)
+{
+  JPetReader reader;
+  reader.getReadCache().setCacheSize(1024 * 1024);
+  reader.getReadCache().setLearnEntries(2);
+  BOOST_REQUIRE(reader.openFileAndLoadData("unitTestData/JPetReaderTest/small.root", "tree"));
+  for (long long i = 0; i < reader.getNbOfAllEvents(); i++) {
+    BOOST_REQUIRE(reader.readEvent(i));
+  }
+  BOOST_REQUIRE(reader.getReadCache().getReadCalls() > 0);
+  BOOST_REQUIRE(reader.getReadCache().getMegabytesRead() > 0);
+  BOOST_REQUIRE(reader.getReadCache().getBlockedTime() >= 0);
+
+  JPetStatistics stats;
+  reader.getReadCache().fillStatistics(stats);
+  BOOST_REQUIRE_EQUAL(stats.getCounter("IO read calls"), reader.getReadCache().getReadCalls());
+  BOOST_REQUIRE_EQUAL(stats.getHisto1D("read_statistics").GetNbinsX(), 4);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,8 @@
 
 #include <TNamed.h> // for Event typedef
 
+class JPetReadCache;
+
 class JPetReaderInterface {
  public:
   typedef TObject MyEvent; 
@@ -27,9 +29,17 @@ class JPetReaderInterface {
   virtual bool firstEvent()=0;
   virtual bool lastEvent()=0;
   virtual bool nthEvent(int n)=0;
+  /// Cursor-style access: moves to the n-th entry, reads it unless it is already loaded
+  /// and returns the event object, which is reused between the calls. Returns 0 if the entry cannot be read.
+  virtual MyEvent* readEvent(long long n)=0;
   virtual long long getCurrentEventNumber() const =0;
   virtual long long getNbOfAllEvents() const =0; 
   virtual TObject* getObjectFromFile(const char* name)=0;
+  /// I/O counters: number of TTree::GetEntry calls and bytes returned by them since the file was opened
+  virtual long long getNbOfReadEntries() const =0;
+  virtual long long getNbOfReadBytes() const =0;
+  /// Read cache settings, to be set before the file is opened, and the I/O statistics of the file
+  virtual JPetReadCache& getReadCache()=0;
   
   virtual bool openFileAndLoadData(const char* filename, const char* treename)=0;
   virtual void closeFile()=0; 
@@ -15,6 +15,7 @@
 
 #include "JPetScin.h"
 #include <cassert>
+#include "../JPetParamBank/JPetParamBank.h"
 
 
 ClassImp(JPetScin);
@@ -22,7 +23,8 @@ ClassImp(JPetScin);
 JPetScin::JPetScin():
 fID(0),
 fAttenLen(0.0),
-fScinSize(0., 0., 0.)
+fScinSize(0., 0., 0.),
+fBarrelSlotID(-1)
 {
   /* */
   SetName("JPetScin");
@@ -30,7 +32,8 @@ fScinSize(0., 0., 0.)
 
 JPetScin::JPetScin(int id) : fID(id),
                  fAttenLen(0.0),
-                 fScinSize(0., 0., 0.)
+                 fScinSize(0., 0., 0.),
+                 fBarrelSlotID(-1)
 {
   SetName("JPetScin");
 }
@@ -38,7 +41,8 @@ JPetScin::JPetScin(int id) : fID(id),
 JPetScin::JPetScin(int id, float attenLen, float length, float height, float width):
 fID(id),
 fAttenLen(attenLen),
-fScinSize(length, height, width)
+fScinSize(length, height, width),
+fBarrelSlotID(-1)
 {
   /* */
   SetName("JPetScin");
@@ -48,6 +52,18 @@ JPetScin::~JPetScin()
 {
 }
 
+JPetBarrelSlot& JPetScin::getBarrelSlot() const
+{
+  return JPetParamBank::resolve<JPetBarrelSlot>(fBarrelSlotID, fTRefBarrelSlot);
+}
+
+bool JPetScin::hasBarrelSlot() const
+{
+  const JPetParamBank* bank = JPetParamBank::getActive();
+  if (bank && fBarrelSlotID >= 0 && bank->find<JPetBarrelSlot>(fBarrelSlotID)) return true;
+  return fTRefBarrelSlot.GetObject() != 0;
+}
+
 float JPetScin::getScinSize(JPetScin::Dimension dim) const
 {
   float value = 0;
@@ -52,8 +52,10 @@ class JPetScin: public TNamed
   inline void setScinSize(ScinDimensions size) { fScinSize = size; }
   void setScinSize(Dimension dim, float value);
 
-  void setBarrelSlot(JPetBarrelSlot &p_barrelSlot){ fTRefBarrelSlot = &p_barrelSlot; }
-  JPetBarrelSlot& getBarrelSlot() const { return (JPetBarrelSlot&)*(fTRefBarrelSlot.GetObject()); }	
+  void setBarrelSlot(JPetBarrelSlot &p_barrelSlot){ fTRefBarrelSlot = &p_barrelSlot; fBarrelSlotID = p_barrelSlot.getID(); }
+  JPetBarrelSlot& getBarrelSlot() const;
+  /// false if getBarrelSlot() has nothing to return
+  bool hasBarrelSlot() const;
   
   inline bool operator==(const JPetScin& scin) const { return getID() == scin.getID(); }
   inline bool operator!=(const JPetScin& scin) const { return getID() != scin.getID(); }
@@ -80,12 +82,13 @@ class JPetScin: public TNamed
   int fID;
   float fAttenLen;  /// attenuation length
   ScinDimensions fScinSize; /// @todo check if there is no problem with the ROOT dictionnary
-  ClassDef(JPetScin, 3);
+  ClassDef(JPetScin, 4);
   
 protected:
   TRef fTRefBarrelSlot;
+  int fBarrelSlotID; ///< id of the referenced slot, resolved by JPetParamBank::resolve(), -1 if unset
   
-  void clearTRefBarrelSlot() { fTRefBarrelSlot = NULL; }
+  void clearTRefBarrelSlot() { fTRefBarrelSlot = NULL; fBarrelSlotID = -1; }
   /*
   TRef fTRefPMLeft;
   TRef fTRefPMRight;
@@ -51,6 +51,16 @@ BOOST_AUTO_TEST_CASE( constructor )
   BOOST_REQUIRE_CLOSE(size.fWidth, 2.5, epsilon);
 }
 
+BOOST_AUTO_TEST_CASE( barrel_slot )
+{
+  JPetScin scint(1, 10.34, 100, 4.5, 2.5);
+  BOOST_REQUIRE(!scint.hasBarrelSlot());
+  JPetBarrelSlot slot(2, true, "slot", 30.f, 1);
+  scint.setBarrelSlot(slot);
+  BOOST_REQUIRE(scint.hasBarrelSlot());
+  BOOST_REQUIRE_EQUAL(scint.getBarrelSlot().getID(), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(FactorySuite)
@@ -170,9 +170,15 @@ void JPetScopeLoader::terminate()
   assert(fHeader);
   assert(fStatistics);
   fWriter->writeHeader(fHeader);
-  fWriter->writeObject(fStatistics->getHistogramsTable(), "Stats");
-   //store the parametric objects in the ouptut ROOT file
-  getParamManager().saveParametersToFile(fWriter);
-  getParamManager().clearParameters();
+  fHeader = 0;
+  if (fWriter->isOpen()) {
+    fWriter->writeObject(fStatistics->getHistogramsTable(), "Stats");
+    //store the parametric objects in the ouptut ROOT file
+    getParamManager().saveParametersToFile(fWriter);
+  }
+  // the next tasks of a streaming chain still use the parameters
+  if (!fOutputQueue) {
+    getParamManager().clearParameters();
+  }
   fWriter->closeFile();
 }
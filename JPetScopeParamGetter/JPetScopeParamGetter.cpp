@@ -15,14 +15,20 @@
 
 #include "./JPetScopeParamGetter.h"
 #include "../JPetScopeConfigParser/JPetScopeConfigParser.h"
-#include <TThread.h>
+#include <mutex>
 #include "../JPetLoggerInclude.h"
 
 std::map<std::string, JPetParamBank*> JPetScopeParamGetter::gParamCache;
 
+namespace
+{
+/// Guards gParamCache, the returned banks are copies owned by the caller.
+std::mutex gCacheMutex;
+}
+
 void JPetScopeParamGetter::clearParamCache()
 {
-  TThread::Lock();
+  std::lock_guard<std::mutex> lock(gCacheMutex);
   WARNING("JPetScopeParamGetter::gParamCache will be cleared");
   for (auto & pair : JPetScopeParamGetter::gParamCache) {
     if (pair.second) {
@@ -31,7 +37,6 @@ void JPetScopeParamGetter::clearParamCache()
     }
   }
   JPetScopeParamGetter::gParamCache.clear();
-  TThread::UnLock();
 }
 
 JPetScopeParamGetter::JPetScopeParamGetter()
@@ -46,9 +51,9 @@ JPetScopeParamGetter::~JPetScopeParamGetter()
 
 JPetParamBank* JPetScopeParamGetter::generateParamBank(const std::string& scopeConfFile)
 {
-  TThread::Lock();
   JPetScopeConfigParser parser;
   auto config = parser.getConfig(scopeConfFile);
+  std::lock_guard<std::mutex> lock(gCacheMutex);
   auto configName = config.fName;
   if (JPetScopeParamGetter::gParamCache.find(configName) == JPetScopeParamGetter::gParamCache.end()) {
     JPetParamBank* param_bank = new JPetParamBank();
@@ -92,7 +97,5 @@ JPetParamBank* JPetScopeParamGetter::generateParamBank(const std::string& scopeC
     JPetScopeParamGetter::gParamCache[configName] = param_bank;
   }
   JPetParamBank* returnedParamBank = new JPetParamBank(*JPetScopeParamGetter::gParamCache[configName]);
-
-  TThread::UnLock();
   return returnedParamBank;
 }
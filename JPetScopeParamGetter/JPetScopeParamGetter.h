@@ -28,13 +28,13 @@ public:
   JPetScopeParamGetter();
   ~JPetScopeParamGetter();
   JPetParamBank* generateParamBank(const std::string& scopeConfFile);
-  static void clearParamCache(); ///Dangerous cause it is shared by all threads
+  static void clearParamCache(); /// the cache is shared by all threads, clear it only when no file is processed
   
 private:
   JPetScopeParamGetter(const JPetScopeParamGetter&);
   JPetScopeParamGetter& operator=(const JPetScopeParamGetter&);
   
   friend class JPetParamManager;
-  static std::map<std::string, JPetParamBank*> gParamCache; /// this static variable is shared among all threads
+  static std::map<std::string, JPetParamBank*> gParamCache; /// shared among all threads, guarded by a mutex
 };
 #endif /*  !JPETSCOPEPARAMGETTER_H */
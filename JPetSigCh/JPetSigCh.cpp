@@ -15,6 +15,7 @@
  */
 
 #include "JPetSigCh.h"
+#include "../JPetParamBank/JPetParamBank.h"
 #include <limits>
 #include <cstring>
 
@@ -28,6 +29,26 @@ void JPetSigCh::Init() {
   fType = Leading;
   fThreshold = kUnset;
   fThresholdNumber = 0;
+  fPMID = -1;
+  fFEBID = -1;
+  fTRBID = -1;
+  fTOMBChannelID = -1;
+}
+
+const JPetPM & JPetSigCh::getPM() const {
+  return JPetParamBank::resolve<JPetPM>(fPMID, fPM);
+}
+
+const JPetTRB & JPetSigCh::getTRB() const {
+  return JPetParamBank::resolve<JPetTRB>(fTRBID, fTRB);
+}
+
+const JPetFEB & JPetSigCh::getFEB() const {
+  return JPetParamBank::resolve<JPetFEB>(fFEBID, fFEB);
+}
+
+const JPetTOMBChannel & JPetSigCh::getTOMBChannel() const {
+  return JPetParamBank::resolve<JPetTOMBChannel>(fTOMBChannelID, fTOMBChannel);
 }
 
 JPetSigCh::JPetSigCh(EdgeType Edge, float EdgeTime) {
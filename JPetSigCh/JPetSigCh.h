@@ -67,18 +67,11 @@ public:
     return fType;
   }
 
-  inline const JPetPM & getPM() const {
-    return (JPetPM&) *fPM.GetObject();
-  }
-  inline const JPetTRB & getTRB() const {
-    return (JPetTRB&) *fTRB.GetObject();
-  }
-  inline const JPetFEB & getFEB() const {
-    return (JPetFEB&) *fFEB.GetObject();
-  }
-  inline const JPetTOMBChannel & getTOMBChannel() const {
-    return (JPetTOMBChannel&) *fTOMBChannel.GetObject();
-  }
+  /// The parametric objects are looked up by id in the active JPetParamBank, see JPetParamBank::resolve()
+  const JPetPM & getPM() const;
+  const JPetTRB & getTRB() const;
+  const JPetFEB & getFEB() const;
+  const JPetTOMBChannel & getTOMBChannel() const;
 
   /**
    * A proxy method for quick access to DAQ channel number ignorantly of what a TOMBCHannel is
@@ -99,15 +92,19 @@ public:
 
   inline void setPM(const JPetPM & pm) {
     fPM = const_cast<JPetPM*>(&pm);
+    fPMID = pm.getID();
   }
   inline void setTRB(const JPetTRB & trb) {
     fTRB = const_cast<JPetTRB*>(&trb);
+    fTRBID = trb.getID();
   }
   inline void setFEB(const JPetFEB & feb) {
     fFEB = const_cast<JPetFEB*>(&feb);
+    fFEBID = feb.getID();
   }
   inline void setTOMBChannel(const JPetTOMBChannel & channel) {
     fTOMBChannel = const_cast<JPetTOMBChannel*>(&channel);
+    fTOMBChannelID = channel.getChannel();
   }
 
   // Set time wrt beginning of TSlot [ps] or charge
@@ -170,7 +167,7 @@ public:
   static bool compareByThresholdNumber(const JPetSigCh & A,
                                        const JPetSigCh & B);
   
-  ClassDef(JPetSigCh, 4);
+  ClassDef(JPetSigCh, 5);
   
 protected:
   EdgeType fType; ///< type of the SigCh: Leading, Trailing (time) or Charge (charge)
@@ -184,6 +181,11 @@ protected:
   TRef fFEB;
   TRef fTRB;
   TRef fTOMBChannel;
+  // ids of the referenced objects (channel of the TOMBChannel), -1 if unset or read from an older file
+  int fPMID;
+  int fFEBID;
+  int fTRBID;
+  int fTOMBChannelID;
   
   void Init();
 };
@@ -17,6 +17,13 @@
 
 ClassImp(JPetStatistics);
 
+JPetStatistics::~JPetStatistics(){
+  for (auto shard : fShards) {
+    shard->fHistos.Delete();
+    delete shard;
+  }
+}
+
 void JPetStatistics::createHistogram(TObject * object){
   fHistos.Add(object);
 }
@@ -54,6 +61,52 @@ double & JPetStatistics::getCounter(const char * name){
   return fCounters[name];
 }
 
+int JPetStatistics::getHisto1DHandle(const char * name){
+  return addHandle(fHistos1D, dynamic_cast<TH1F*>(fHistos.FindObject(name)));
+}
+
+int JPetStatistics::getHisto2DHandle(const char * name){
+  return addHandle(fHistos2D, dynamic_cast<TH2F*>(fHistos.FindObject(name)));
+}
+
+int JPetStatistics::getCounterHandle(const char * name){
+  return addHandle(fCounterValues, &fCounters[name]);
+}
+
 const THashTable * JPetStatistics::getHistogramsTable() const{
   return &fHistos;
 }
+
+void JPetStatistics::merge(const JPetStatistics & other){
+  TIter next(&other.fHistos);
+  while (TObject* object = next()) {
+    TObject* own = fHistos.FindObject(object->GetName());
+    if (!own) {
+      fHistos.Add(object->Clone());
+      continue;
+    }
+    TH1* ownHisto = dynamic_cast<TH1*>(own);
+    TH1* otherHisto = dynamic_cast<TH1*>(object);
+    if (ownHisto && otherHisto) {
+      ownHisto->Add(otherHisto);
+    }
+  }
+  for (auto& counter : other.fCounters) {
+    fCounters[counter.first] += counter.second;
+  }
+}
+
+JPetStatistics * JPetStatistics::createShard(){
+  JPetStatistics * shard = new JPetStatistics();
+  fShards.push_back(shard);
+  return shard;
+}
+
+void JPetStatistics::mergeShards(){
+  for (auto shard : fShards) {
+    merge(*shard);
+    shard->fHistos.Delete();
+    delete shard;
+  }
+  fShards.clear();
+}
@@ -21,6 +21,7 @@
 #include <TH2F.h>
 #include <TString.h>
 #include <map>
+#include <vector>
 #include <TGraph.h>
 #include <TCanvas.h>
 
@@ -32,6 +33,8 @@
 class JPetStatistics: public TObject{
   
  public:
+
+  virtual ~JPetStatistics();
   
   void createHistogram(TObject * object);
   void createGraph(TObject * object);
@@ -43,7 +46,32 @@ class JPetStatistics: public TObject{
   void createCounter(const char * name);
   double & getCounter(const char * name);
 
+  /// Handles resolve the name once, e.g. in init(), so that filling per event needs no lookup.
+  /// They return -1 if there is no histogram of this name and type.
+  int getHisto1DHandle(const char * name);
+  int getHisto2DHandle(const char * name);
+  /// Creates the counter if it does not exist yet, like getCounter(name)
+  int getCounterHandle(const char * name);
+  inline TH1F & getHisto1D(int handle) {
+    return *fHistos1D[handle];
+  }
+  inline TH2F & getHisto2D(int handle) {
+    return *fHistos2D[handle];
+  }
+  inline double & getCounter(int handle) {
+    return *fCounterValues[handle];
+  }
+
   const THashTable * getHistogramsTable() const;
+
+  /// Adds the histograms and counters of other, filled from another range of events, to these ones
+  void merge(const JPetStatistics & other);
+
+  /// Creates an empty statistics object to be filled by a single thread, without any locking.
+  /// The shards are owned by this object and should be created before the threads are started.
+  JPetStatistics * createShard();
+  /// Adds the contents of all the shards to this object and deletes them together with their histograms
+  void mergeShards();
   
   ClassDef(JPetStatistics,1); 
     
@@ -52,6 +80,22 @@ class JPetStatistics: public TObject{
   THashTable fGraphs;
   THashTable fCanvas;
   std::map<TString, double> fCounters;
+
+  std::vector<TH1F*> fHistos1D; //!
+  std::vector<TH2F*> fHistos2D; //!
+  std::vector<double*> fCounterValues; //!
+  std::vector<JPetStatistics*> fShards; //!
+
+  template <typename T>
+  static int addHandle(std::vector<T*> & handles, T * object)
+  {
+    if (!object) return -1;
+    for (size_t i = 0; i < handles.size(); i++) {
+      if (handles[i] == object) return i;
+    }
+    handles.push_back(object);
+    return handles.size() - 1;
+  }
  
 };
 
@@ -0,0 +1,81 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE JPetStatisticsTest
+#include <boost/test/unit_test.hpp>
+#include <TThread.h>
+#include "../JPetStatistics/JPetStatistics.h"
+
+namespace
+{
+const int kNumberOfThreads = 4;
+const int kEventsPerThread = 10000;
+
+void* fillShard(void* arg)
+{
+  JPetStatistics* shard = static_cast<JPetStatistics*>(arg);
+  shard->createHistogram(new TH1F("time", "time", 100, 0., 100.));
+  shard->createCounter("events");
+  const int histo = shard->getHisto1DHandle("time");
+  const int counter = shard->getCounterHandle("events");
+  for (int i = 0; i < kEventsPerThread; i++) {
+    shard->getHisto1D(histo).Fill(i % 100);
+    shard->getCounter(counter) += 1.;
+  }
+  return 0;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(FirstSuite)
+
+BOOST_AUTO_TEST_CASE( handlesPointToTheNamedObjects )
+{
+  JPetStatistics stats;
+  TH1F* histo1D = new TH1F("histo1D", "", 10, 0., 10.);
+  TH2F* histo2D = new TH2F("histo2D", "", 10, 0., 10., 10, 0., 10.);
+  stats.createHistogram(histo1D);
+  stats.createHistogram(histo2D);
+  stats.createCounter("counter");
+
+  const int handle1D = stats.getHisto1DHandle("histo1D");
+  BOOST_REQUIRE(handle1D >= 0);
+  BOOST_REQUIRE_EQUAL(stats.getHisto1DHandle("histo1D"), handle1D);
+  BOOST_REQUIRE(&stats.getHisto1D(handle1D) == histo1D);
+  BOOST_REQUIRE(&stats.getHisto2D(stats.getHisto2DHandle("histo2D")) == histo2D);
+  BOOST_REQUIRE_EQUAL(stats.getHisto1DHandle("histo2D"), -1);
+  BOOST_REQUIRE_EQUAL(stats.getHisto1DHandle("missing"), -1);
+
+  const int counter = stats.getCounterHandle("counter");
+  stats.getCounter(counter) += 2.;
+  BOOST_REQUIRE_EQUAL(stats.getCounter("counter"), 2.);
+  stats.getCounter(stats.getCounterHandle("new counter")) = 1.;
+  BOOST_REQUIRE_EQUAL(stats.getCounter("new counter"), 1.);
+  // a new counter does not move the existing ones
+  BOOST_REQUIRE_EQUAL(stats.getCounter(counter), 2.);
+}
+
+BOOST_AUTO_TEST_CASE( shardsFilledByThreadsAreMerged )
+{
+  const Bool_t addDirectory = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(kFALSE);
+  JPetStatistics stats;
+  std::vector<TThread*> threads;
+  for (int t = 0; t < kNumberOfThreads; t++) {
+    threads.push_back(new TThread(Form("shard%d", t), fillShard, (void*) stats.createShard()));
+  }
+  for (auto thread : threads) {
+    thread->Run();
+  }
+  for (auto thread : threads) {
+    thread->Join();
+    delete thread;
+  }
+  stats.mergeShards();
+
+  BOOST_REQUIRE_EQUAL(stats.getHisto1D("time").GetEntries(), kNumberOfThreads * kEventsPerThread);
+  BOOST_REQUIRE_EQUAL(stats.getCounter("events"), kNumberOfThreads * kEventsPerThread);
+  // merging again does not add anything
+  stats.mergeShards();
+  BOOST_REQUIRE_EQUAL(stats.getCounter("events"), kNumberOfThreads * kEventsPerThread);
+  TH1::AddDirectory(addDirectory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -15,15 +15,16 @@
 
 
 #include "JPetTOMBChannel.h"
+#include "../JPetParamBank/JPetParamBank.h"
 
 ClassImp(JPetTOMBChannel);
 
-JPetTOMBChannel::JPetTOMBChannel(): fChannel(0), fFEB(NULL), fTRB(NULL), fPM(NULL), fThreshold(-1), fLocalChannelNumber(0), fFEBInputNumber(0)
+JPetTOMBChannel::JPetTOMBChannel(): fChannel(0), fFEB(NULL), fTRB(NULL), fPM(NULL), fThreshold(-1), fLocalChannelNumber(0), fFEBInputNumber(0), fFEBID(-1), fTRBID(-1), fPMID(-1)
 {
   SetName("JPetTOMBChannel");
 }
 
-JPetTOMBChannel::JPetTOMBChannel(unsigned int p_channel): fChannel(p_channel), fFEB(NULL), fTRB(NULL), fPM(NULL), fThreshold(-1), fLocalChannelNumber(0), fFEBInputNumber(0)
+JPetTOMBChannel::JPetTOMBChannel(unsigned int p_channel): fChannel(p_channel), fFEB(NULL), fTRB(NULL), fPM(NULL), fThreshold(-1), fLocalChannelNumber(0), fFEBInputNumber(0), fFEBID(-1), fTRBID(-1), fPMID(-1)
 {
   SetName("JPetTOMBChannel");
 }
@@ -32,3 +33,18 @@ JPetTOMBChannel::~JPetTOMBChannel()
 {
 }
 
+const JPetFEB & JPetTOMBChannel::getFEB() const
+{
+  return JPetParamBank::resolve<JPetFEB>(fFEBID, fFEB);
+}
+
+const JPetTRB & JPetTOMBChannel::getTRB() const
+{
+  return JPetParamBank::resolve<JPetTRB>(fTRBID, fTRB);
+}
+
+const JPetPM & JPetTOMBChannel::getPM() const
+{
+  return JPetParamBank::resolve<JPetPM>(fPMID, fPM);
+}
+
@@ -41,14 +41,14 @@ public:
   JPetTOMBChannel(unsigned int p_channel);
   virtual ~JPetTOMBChannel(void);
   
-  void setFEB(JPetFEB& p_FEB){ fFEB = &p_FEB; }
-  void setTRB(JPetTRB& p_TRB){ fTRB = &p_TRB; }
-  void setPM(JPetPM& p_PM){ fPM = &p_PM; }
+  void setFEB(JPetFEB& p_FEB){ fFEB = &p_FEB; fFEBID = p_FEB.getID(); }
+  void setTRB(JPetTRB& p_TRB){ fTRB = &p_TRB; fTRBID = p_TRB.getID(); }
+  void setPM(JPetPM& p_PM){ fPM = &p_PM; fPMID = p_PM.getID(); }
   void setThreshold(float p_threshold){ fThreshold = p_threshold; }
   
-  const JPetFEB & getFEB()const{ return (JPetFEB&)*fFEB.GetObject(); }
-  const JPetTRB & getTRB()const{ return (JPetTRB&)*fTRB.GetObject(); }
-  const JPetPM & getPM()const{ return (JPetPM&)*fPM.GetObject(); }
+  const JPetFEB & getFEB()const;
+  const JPetTRB & getTRB()const;
+  const JPetPM & getPM()const;
   float getThreshold()const{ return fThreshold; }
   int getChannel()const{ return fChannel; }
   std::string getDescription()const{ return m_description; }
@@ -86,8 +86,12 @@ private:
   float fThreshold;
   unsigned int fLocalChannelNumber; ///< number of the threshold
   unsigned int fFEBInputNumber; ///< number of input of the FEB from which this channel comes
+  // ids of the referenced objects, resolved by JPetParamBank::resolve(), -1 if unset
+  int fFEBID;
+  int fTRBID;
+  int fPMID;
   
-  ClassDef(JPetTOMBChannel, 3);
+  ClassDef(JPetTOMBChannel, 4);
 };
 
 #endif // JPET_TOMB_CHANNEL_H
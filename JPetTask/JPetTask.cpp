@@ -22,7 +22,8 @@ TNamed(name, description),
 fEvent(0),
 fParamManager(0),
 fStatistics(0),
-fAuxilliaryData(0)
+fAuxilliaryData(0),
+fFirstEventNumber(0)
 {
 }
 
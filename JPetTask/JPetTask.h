@@ -27,6 +27,18 @@ class JPetWriter;
 class JPetTask: public JPetTaskInterface, public TNamed
 {
  public:
+  /**
+   * @brief Declares if the events of one file can be processed by several threads, see JPetTaskIO.
+   *
+   * kSerial - the task needs all the events in order (default).
+   * kStateless - every event is processed independently of the other ones.
+   * kReducible - the task keeps some state (e.g. counters), the state of
+   * the clones is added to the original task with reduce() before terminate().
+   * In both parallel modes every thread runs its own clone made by cloneForThread(),
+   * with its own writer and statistics. The histograms are merged at the end.
+   */
+  enum ParallelMode { kSerial, kStateless, kReducible };
+
   JPetTask(const char * name="", const char * description="");
   virtual void init(const JPetTaskInterface::Options&);
   virtual void exec();
@@ -41,11 +53,20 @@ class JPetTask: public JPetTaskInterface, public TNamed
   JPetStatistics & getStatistics();
   JPetAuxilliaryData & getAuxilliaryData();
   virtual TNamed* getEvent() {return fEvent;}
+  virtual ParallelMode getParallelMode() const {return kSerial;}
+  /// A new task doing the same job, run by another thread, or 0 if the task cannot be cloned
+  virtual JPetTask* cloneForThread() const {return 0;}
+  /// Adds the state of a clone, which processed another range of events, to this task
+  virtual void reduce(const JPetTask& /*clone*/) {}
+  /// Position of the first event given to the task among all the processed events, 0 unless the task is a clone
+  inline void setFirstEventNumber(long long number) {fFirstEventNumber = number;}
+  inline long long getFirstEventNumber() const {return fFirstEventNumber;}
 
  protected:
   TNamed* fEvent;
   JPetParamManager* fParamManager;
   JPetStatistics * fStatistics;
   JPetAuxilliaryData * fAuxilliaryData;
+  long long fFirstEventNumber;
 };
 #endif /*  !JPETTASK_H */
@@ -15,13 +15,41 @@
 
 #include "JPetTaskExecutor.h"
 #include <cassert>
+#include <boost/filesystem.hpp>
 #include "../JPetTaskInterface/JPetTaskInterface.h"
 #include "../JPetScopeLoader/JPetScopeLoader.h"
 #include "../JPetTaskLoader/JPetTaskLoader.h"
+#include "../JPetEventQueue/JPetEventQueue.h"
 #include "../JPetParamGetterAscii/JPetParamGetterAscii.h"
 #include "../JPetParamGetterAscii/JPetParamSaverAscii.h"
+#include "../JPetParamGetterAscii/JPetParamSnapshot.h"
 #include "../JPetLoggerInclude.h"
 
+namespace
+{
+/// One task of the streaming chain and the queue it fills, see JPetTaskExecutor::processStreaming
+struct StreamStage {
+  JPetTaskIO* fTask;
+  JPetEventQueue* fInputQueue;
+  JPetEventQueue* fOutputQueue;
+  TThread* fThread;
+};
+
+void* runStreamStage(void* arg)
+{
+  StreamStage* stage = static_cast<StreamStage*>(arg);
+  stage->fTask->exec();
+  if (stage->fOutputQueue) {
+    stage->fOutputQueue->close();
+  }
+  // if the task stopped before the end of its input, the previous task is not blocked by the full queue
+  if (stage->fInputQueue) {
+    stage->fInputQueue->close();
+  }
+  return 0;
+}
+}
+
 
 JPetTaskExecutor::JPetTaskExecutor(TaskGeneratorChain* taskGeneratorChain, int processedFileId, JPetOptions opt) :
   fProcessedFile(processedFileId),
@@ -33,6 +61,9 @@ JPetTaskExecutor::JPetTaskExecutor(TaskGeneratorChain* taskGeneratorChain, int p
   } else {
     fParamManager = new JPetParamManager();
   }
+  if (fOptions.isParamCache()) {
+    fParamManager->setCacheDirectory(fOptions.getParamCache());
+  }
   if (taskGeneratorChain) {
     for (auto taskGenerator : *ftaskGeneratorChain) {
       auto task = taskGenerator();
@@ -50,20 +81,15 @@ bool JPetTaskExecutor::process()
     ERROR("Error in processFromCmdLineArgs");
     return false;
   }
-  for (auto currentTask = fTasks.begin(); currentTask != fTasks.end(); currentTask++) {
-    JPetOptions::Options currOpts = fOptions.getOptions();
-    if (currentTask != fTasks.begin()) {
-    /// Ignore the event range options for all but the first task.
-      currOpts = JPetOptions::resetEventRange(currOpts);
-   /// For all but the first task, 
-   /// the input path must be changed if 
-   /// the output path argument -o was given, because the input
-   /// data for them will lay in the location defined by -o.
-      auto outPath  = currOpts.at("outputPath");
-      if (!outPath.empty()) {
-        currOpts.at("inputFile") = outPath + JPetCommonTools::extractPathFromFile(currOpts.at("inputFile")) + JPetCommonTools::extractFileNameFromFullPath(currOpts.at("inputFile"));
-      }
+  if (fOptions.isStreamTasks()) {
+    if (canStreamTasks()) {
+      processStreaming();
+      return true;
     }
+    WARNING("The tasks cannot be streamed, they are run one after another");
+  }
+  for (auto currentTask = fTasks.begin(); currentTask != fTasks.end(); currentTask++) {
+    JPetOptions::Options currOpts = getTaskOptions(currentTask == fTasks.begin());
 
     INFO(Form("Starting task: %s", dynamic_cast<JPetTaskLoader*>(*currentTask)->getSubTask()->GetName()));
     (*currentTask)->init(currOpts);
@@ -74,6 +100,88 @@ bool JPetTaskExecutor::process()
   return true;
 }
 
+JPetOptions::Options JPetTaskExecutor::getTaskOptions(bool isFirstTask) const
+{
+  JPetOptions::Options currOpts = fOptions.getOptions();
+  if (!isFirstTask) {
+  /// Ignore the event range options for all but the first task.
+    currOpts = JPetOptions::resetEventRange(currOpts);
+ /// For all but the first task, 
+ /// the input path must be changed if 
+ /// the output path argument -o was given, because the input
+ /// data for them will lay in the location defined by -o.
+    auto outPath  = currOpts.at("outputPath");
+    if (!outPath.empty()) {
+      currOpts.at("inputFile") = outPath + JPetCommonTools::extractPathFromFile(currOpts.at("inputFile")) + JPetCommonTools::extractFileNameFromFullPath(currOpts.at("inputFile"));
+    }
+  }
+  return currOpts;
+}
+
+/// Streaming needs at least two tasks, all of them reading and writing through JPetTaskIO
+bool JPetTaskExecutor::canStreamTasks() const
+{
+  if (fTasks.size() < 2) return false;
+  for (auto task : fTasks) {
+    if (!dynamic_cast<JPetTaskIO*>(task)) return false;
+  }
+  return true;
+}
+
+/**
+ * Runs all the tasks at the same time, each in its own thread. The objects written
+ * by a task are passed to the next one through a JPetEventQueue instead of a file,
+ * so only the first task reads from disk. Only the output of the last task and
+ * the outputs of the types given by the persistentOutputs option are saved.
+ * The tasks are initialized and terminated in order by the calling thread.
+ */
+void JPetTaskExecutor::processStreaming()
+{
+  std::vector<StreamStage> stages;
+  for (auto task : fTasks) {
+    StreamStage stage;
+    stage.fTask = dynamic_cast<JPetTaskIO*>(task);
+    stage.fInputQueue = 0;
+    stage.fOutputQueue = 0;
+    stage.fThread = 0;
+    stages.push_back(stage);
+  }
+  for (size_t k = 0; k < stages.size(); k++) {
+    JPetTaskIO* task = stages[k].fTask;
+    if (k > 0) {
+      stages[k].fInputQueue = stages[k - 1].fOutputQueue;
+      task->setInputQueue(stages[k].fInputQueue, stages[k - 1].fTask->getHeader());
+    }
+    if (k + 1 < stages.size()) {
+      stages[k].fOutputQueue = new JPetEventQueue();
+      task->setOutputQueue(stages[k].fOutputQueue);
+    }
+    task->init(getTaskOptions(k == 0));
+  }
+
+  INFO(Form("Streaming %d tasks", (int)stages.size()));
+  TThread::Initialize();
+  for (size_t k = 0; k < stages.size(); k++) {
+    stages[k].fThread = new TThread(Form("JPetTaskExecutor%d_%d", fProcessedFile, (int)k), runStreamStage, (void*) &stages[k]);
+    stages[k].fThread->Run();
+  }
+  for (auto& stage : stages) {
+    stage.fThread->Join();
+    delete stage.fThread;
+    stage.fThread = 0;
+  }
+
+  for (auto& stage : stages) {
+    stage.fTask->terminate();
+    INFO(Form("Finished task: %s", stage.fTask->getSubTask()->GetName()));
+  }
+  fParamManager->clearParameters();
+  for (auto& stage : stages) {
+    delete stage.fOutputQueue;
+    stage.fOutputQueue = 0;
+  }
+}
+
 void* JPetTaskExecutor::processProxy(void* runner)
 {
   assert(runner);
@@ -101,7 +209,12 @@ bool JPetTaskExecutor::processFromCmdLineArgs(int)
     }
     if (fOptions.isLocalDBCreate()) {
       JPetParamSaverAscii saver;
-      saver.saveParamBank(fParamManager->getParamBank(), runNum, fOptions.getLocalDBCreate());
+      std::string localDB = fOptions.getLocalDBCreate();
+      if (boost::filesystem::extension(localDB) == JPetParamSnapshot::kFileExtension) {
+        saver.saveParamBankSnapshot(fParamManager->getParamBank(), runNum, localDB);
+      } else {
+        saver.saveParamBank(fParamManager->getParamBank(), runNum, localDB);
+      }
     }
   }
   auto inputFileType = fOptions.getInputFileType();
@@ -116,6 +229,8 @@ bool JPetTaskExecutor::processFromCmdLineArgs(int)
     } else {
       fUnpacker.setParams(fOptions.getInputFile());
     }
+    fUnpacker.setThreads(fOptions.getUnpackerThreads());
+    fUnpacker.setIntermediateFiles(fOptions.isUnpackerIntermediateFiles());
     unpackFile();
   }
   return true;
@@ -150,4 +265,9 @@ JPetTaskExecutor::~JPetTaskExecutor()
       task = 0;
     }
   }
+  /// Each executor owns the param manager of its file, the tasks using it are gone by now.
+  if (fParamManager) {
+    delete fParamManager;
+    fParamManager = 0;
+  }
 }
@@ -38,6 +38,9 @@ public :
 
   bool process(); /// That was private. I made it public to run without threads.
 private:
+  JPetOptions::Options getTaskOptions(bool isFirstTask) const;
+  bool canStreamTasks() const;
+  void processStreaming();
   void createScopeTaskAndAddToTaskList();
   static void* processProxy(void*);
   bool processFromCmdLineArgs(int);
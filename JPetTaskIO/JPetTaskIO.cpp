@@ -15,14 +15,57 @@
 
 #include "JPetTaskIO.h"
 #include <cassert>
+#include <cstdio>
+#include <vector>
+#include <TFile.h>
+#include <TH1.h>
+#include <TThread.h>
+#include <TTree.h>
 #include "../JPetReader/JPetReader.h"
 #include "../JPetTreeHeader/JPetTreeHeader.h"
 #include "../JPetTask/JPetTask.h"
 #include "../JPetHLDReader/JPetHLDReader.h"
 #include "../JPetCommonTools/JPetCommonTools.h"
+#include "../JPetReadCache/JPetReadCache.h"
+#include "../JPetEventQueue/JPetEventQueue.h"
+#include "../JPetParamBank/JPetParamBank.h"
 
 #include "../JPetLoggerInclude.h"
 
+namespace
+{
+/// One range of events processed by a clone of the task, see JPetTaskIO::execParallel
+struct TaskIOWorker {
+  JPetTask* fTask;
+  JPetReaderInterface* fReader;
+  JPetWriter* fWriter;
+  JPetStatistics* fStatistics;
+  const JPetParamBank* fParamBank;
+  long long fFirstEvent;
+  long long fLastEvent;
+  long long fFailedEvents;
+  std::string fOutputFilename;
+  TThread* fThread;
+};
+
+void* runTaskIOWorker(void* arg)
+{
+  TaskIOWorker* worker = static_cast<TaskIOWorker*>(arg);
+  // the active bank is per thread, the references of the events are resolved in it
+  JPetParamBank::setActive(worker->fParamBank);
+  for (auto i = worker->fFirstEvent; i <= worker->fLastEvent; i++) {
+    auto event = worker->fReader->readEvent(i);
+    if (!event) {
+      worker->fFailedEvents++;
+      continue;
+    }
+    worker->fTask->setEvent(static_cast<TNamed*>(event));
+    worker->fTask->exec();
+  }
+  JPetParamBank::setActive(0);
+  return 0;
+}
+}
 
 JPetTaskIO::JPetTaskIO():
   fTask(0),
@@ -32,7 +75,10 @@ JPetTaskIO::JPetTaskIO():
   fHeader(0),
   fStatistics(0),
   fAuxilliaryData(0),
-  fParamManager(0)
+  fParamManager(0),
+  fInputQueue(0),
+  fInputHeader(0),
+  fOutputQueue(0)
 {
 }
 
@@ -50,11 +96,16 @@ void JPetTaskIO::init(const JPetOptions::Options& opts)
 void JPetTaskIO::exec()
 {
   assert(fTask);
-  assert(fReader);
   assert(fParamManager);
   fTask->setParamManager(fParamManager);
+  JPetParamBank::setActive(&fParamManager->getParamBank());
   JPetTaskInterface::Options emptyOpts;
   fTask->init(emptyOpts); //prepare current task for file
+  if (fInputQueue) {
+    execStream();
+    return;
+  }
+  assert(fReader);
   auto totalEvents = 0ll;
   if (fReader) {
     totalEvents = fReader->getNbOfAllEvents();
@@ -66,38 +117,196 @@ void JPetTaskIO::exec()
   auto lastEvent = 0ll;
   setUserLimits(fOptions, totalEvents,  firstEvent, lastEvent);
   assert(lastEvent >= 0);
+  const int nThreads = fOptions.getTaskThreads();
+  if (nThreads > 1 && fTask->getParallelMode() != JPetTask::kSerial
+      && execParallel(firstEvent, lastEvent, nThreads)) {
+    // the task sees the histograms of all the threads in terminate()
+    fStatistics->mergeShards();
+    fTask->terminate();
+    return;
+  }
   for (auto i = firstEvent; i <= lastEvent; i++) {
-    fTask->setEvent(&(static_cast<TNamed&>(fReader->getCurrentEvent())));
+    // every entry is read from the tree once, into the same event object
+    auto event = fReader->readEvent(i);
+    if (!event) {
+      ERROR("Could not read the event " + std::to_string(i));
+      continue;
+    }
+    fTask->setEvent(static_cast<TNamed*>(event));
     if (fOptions.isProgressBar()) {
       manageProgressBar(i, lastEvent);
     }
     fTask->exec();
-    fReader->nextEvent();
   }
+  if (lastEvent >= firstEvent) {
+    INFO(Form("Read %lld tree entries, %.1f entries and %.1f bytes per processed event",
+              fReader->getNbOfReadEntries(),
+              fReader->getNbOfReadEntries() / double(lastEvent - firstEvent + 1),
+              fReader->getNbOfReadBytes() / double(lastEvent - firstEvent + 1)));
+  }
+  if (fStatistics) {
+    fReader->getReadCache().fillStatistics(*fStatistics);
+  }
+  fTask->terminate();
+}
+
+/**
+ * Processes the objects written by the previous task of a streaming chain until
+ * it closes the queue. As with the reader, the current event stays valid until
+ * the next one is taken, the last one until the task is terminated.
+ */
+void JPetTaskIO::execStream()
+{
+  long long nEvents = 0;
+  TObject* event = 0;
+  while (TObject* next = fInputQueue->pop()) {
+    delete event;
+    event = next;
+    fTask->setEvent(static_cast<TNamed*>(event));
+    fTask->exec();
+    nEvents++;
+  }
+  INFO(Form("%s: processed %lld events passed by the previous task", fTask->GetName(), nEvents));
   fTask->terminate();
+  fTask->setEvent(0);
+  delete event;
+}
+
+/**
+ * Processes the events [firstEvent, lastEvent] with nThreads clones of the task.
+ * Every clone gets a contiguous range of events, its own reader, statistics and
+ * writer to a temporary file. The temporary files are appended to the output
+ * in the order of the ranges, so the output tree is the same as the one of the
+ * serial processing. Returns false if the task cannot be cloned.
+ */
+bool JPetTaskIO::execParallel(long long firstEvent, long long lastEvent, int nThreads)
+{
+  const long long nEvents = lastEvent - firstEvent + 1;
+  if (nThreads > nEvents) nThreads = nEvents;
+  if (nThreads < 2) return false;
+
+  std::vector<TaskIOWorker> workers(nThreads);
+  for (int t = 0; t < nThreads; t++) {
+    workers[t].fTask = fTask->cloneForThread();
+    if (!workers[t].fTask) {
+      WARNING(std::string(fTask->GetName()) + ": the task cannot be cloned, the events are processed serially");
+      for (int i = 0; i < t; i++) delete workers[i].fTask;
+      return false;
+    }
+  }
+
+  JPetWriter::Settings settings = fWriter->getSettings();
+  settings.fAsync = false;
+  JPetTaskInterface::Options emptyOpts;
+  // the histograms of the shards are merged and deleted in terminate(), not by the current directory
+  const Bool_t addDirectory = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(kFALSE);
+  for (int t = 0; t < nThreads; t++) {
+    TaskIOWorker& worker = workers[t];
+    worker.fFirstEvent = firstEvent + nEvents * t / nThreads;
+    worker.fLastEvent = firstEvent + nEvents * (t + 1) / nThreads - 1;
+    worker.fFailedEvents = 0;
+    worker.fReader = createReader(fOptions.getInputFile());
+    worker.fOutputFilename = fOutputFilename + ".part" + std::to_string(t);
+    worker.fWriter = new JPetWriter(worker.fOutputFilename.c_str(), settings);
+    worker.fStatistics = fStatistics->createShard();
+    worker.fThread = 0;
+    worker.fParamBank = &fParamManager->getParamBank();
+    worker.fTask->setParamManager(fParamManager);
+    worker.fTask->setStatistics(worker.fStatistics);
+    worker.fTask->setAuxilliaryData(fAuxilliaryData);
+    worker.fTask->setWriter(worker.fWriter);
+    worker.fTask->setFirstEventNumber(worker.fFirstEvent - firstEvent);
+    worker.fTask->init(emptyOpts);
+  }
+  TH1::AddDirectory(addDirectory);
+
+  INFO(Form("Processing events %lld - %lld with %d threads", firstEvent, lastEvent, nThreads));
+  TThread::Initialize();
+  for (int t = 0; t < nThreads; t++) {
+    if (!workers[t].fReader) continue;
+    workers[t].fThread = new TThread(Form("JPetTaskIO%d", t), runTaskIOWorker, (void*) &workers[t]);
+    workers[t].fThread->Run();
+  }
+  for (int t = 0; t < nThreads; t++) {
+    if (!workers[t].fThread) continue;
+    workers[t].fThread->Join();
+    delete workers[t].fThread;
+    workers[t].fThread = 0;
+  }
+
+  for (int t = 0; t < nThreads; t++) {
+    TaskIOWorker& worker = workers[t];
+    if (!worker.fReader) {
+      ERROR(Form("Could not open the input file, events %lld - %lld were not processed", worker.fFirstEvent, worker.fLastEvent));
+    } else if (worker.fFailedEvents > 0) {
+      ERROR(Form("Could not read %lld events of the range %lld - %lld", worker.fFailedEvents, worker.fFirstEvent, worker.fLastEvent));
+    }
+    if (fTask->getParallelMode() == JPetTask::kReducible) {
+      fTask->reduce(*worker.fTask);
+    }
+    worker.fWriter->closeFile();
+    delete worker.fWriter;
+    appendOutput(worker.fOutputFilename);
+
+    delete worker.fTask;
+    delete worker.fReader;
+  }
+  return true;
+}
+
+/// Copies the entries written to a temporary file by execParallel to the output and removes the file
+void JPetTaskIO::appendOutput(const std::string& fileName)
+{
+  long long nEntries = 0;
+  {
+    TFile file(fileName.c_str(), "READ");
+    TTree* tree = static_cast<TTree*>(file.Get("tree"));
+    if (tree) nEntries = tree->GetEntries();
+  }
+  if (nEntries > 0) {
+    JPetReader reader;
+    if (reader.openFileAndLoadData(fileName.c_str(), "tree")) {
+      for (long long i = 0; i < nEntries; i++) {
+        auto event = reader.readEvent(i);
+        if (event) fWriter->copyEntry(*event);
+      }
+    }
+    reader.closeFile();
+  }
+  std::remove(fileName.c_str());
 }
 
 void JPetTaskIO::terminate()
 {
-  assert(fReader);
+  assert(fReader || fInputQueue);
   assert(fWriter);
   assert(fHeader);
   assert(fStatistics);
   assert(fAuxilliaryData);
   
   fWriter->writeHeader(fHeader);
+  fHeader = 0;
 
-  fWriter->writeObject(fStatistics->getHistogramsTable(), "Stats");
+  fStatistics->mergeShards();
+  if (fWriter->isOpen()) {
+    fWriter->writeObject(fStatistics->getHistogramsTable(), "Stats");
 
-  fWriter->writeObject(fAuxilliaryData, "Auxilliary Data");
-  
-  // store the parametric objects in the ouptut ROOT file
-  getParamManager().saveParametersToFile(
-    fWriter);
-  getParamManager().clearParameters();
+    fWriter->writeObject(fAuxilliaryData, "Auxilliary Data");
+
+    // store the parametric objects in the ouptut ROOT file
+    getParamManager().saveParametersToFile(
+      fWriter);
+  }
+  // in a streaming chain the parameters are shared by all the tasks, JPetTaskExecutor clears them
+  if (!fInputQueue && !fOutputQueue) {
+    getParamManager().clearParameters();
+  }
 
   fWriter->closeFile();
-  fReader->closeFile();
+  if (fReader) {
+    fReader->closeFile();
+  }
 
 }
 void JPetTaskIO::addSubTask(JPetTaskInterface* subtask)
@@ -119,6 +328,23 @@ void JPetTaskIO::setParamManager(JPetParamManager* paramManager)
   fParamManager = paramManager;
 }
 
+void JPetTaskIO::setInputQueue(JPetEventQueue* queue, const JPetTreeHeader* header)
+{
+  fInputQueue = queue;
+  if (fInputHeader) {
+    delete fInputHeader;
+    fInputHeader = 0;
+  }
+  if (header) {
+    fInputHeader = new JPetTreeHeader(*header);
+  }
+}
+
+void JPetTaskIO::setOutputQueue(JPetEventQueue* queue)
+{
+  fOutputQueue = queue;
+}
+
 JPetParamManager& JPetTaskIO::getParamManager()
 {
   DEBUG("JPetTaskIO");
@@ -132,17 +358,34 @@ JPetParamManager& JPetTaskIO::getParamManager()
   }
 }
 
-void JPetTaskIO::createInputObjects(const char* inputFilename)
+JPetReaderInterface* JPetTaskIO::createReader(const char* inputFilename) const
 {
+  JPetReaderInterface* reader = 0;
   auto treeName = "";
   if (fOptions.getInputFileType() == JPetOptions::kHld ) {
-    fReader = new JPetHLDReader;
+    reader = new JPetHLDReader;
     treeName = "T";
   } else {
-    fReader = new JPetReader;
+    reader = new JPetReader;
     treeName = "tree";
   }
-  if ( fReader->openFileAndLoadData( inputFilename, treeName )) {
+  JPetReadCache& readCache = reader->getReadCache();
+  readCache.setCacheSize(fOptions.getReadCacheSize());
+  if (!reader->openFileAndLoadData(inputFilename, treeName)) {
+    delete reader;
+    return 0;
+  }
+  return reader;
+}
+
+void JPetTaskIO::createInputObjects(const char* inputFilename)
+{
+  if (fInputQueue) {
+    createStreamInputObjects();
+    return;
+  }
+  fReader = createReader(inputFilename);
+  if (fReader) {
     if (fOptions.getInputFileType() == JPetOptions::kHld ) {
       // create a header to be stored along with the output tree
       fHeader = new JPetTreeHeader(fOptions.getRunNumber());
@@ -175,9 +418,37 @@ void JPetTaskIO::createInputObjects(const char* inputFilename)
   }
 }
 
+/// The input of a task in a streaming chain: no reader, the parameters are already loaded by the first task
+void JPetTaskIO::createStreamInputObjects()
+{
+  if (fInputHeader) {
+    fHeader = fInputHeader;
+    fInputHeader = 0;
+  } else {
+    fHeader = new JPetTreeHeader(fOptions.getRunNumber());
+    fHeader->setBaseFileName(fOptions.getInputFile());
+  }
+  fStatistics = new JPetStatistics();
+  fHeader->addStageInfo(fTask->GetName(), fTask->GetTitle(), 0,
+                        JPetCommonTools::getTimeString());
+}
+
 void JPetTaskIO::createOutputObjects(const char* outputFilename)
 {
-  fWriter = new JPetWriter( outputFilename );
+  // the temporary files of execParallel are created next to the output file
+  fOutputFilename = outputFilename;
+  JPetWriter::Settings settings;
+  settings.fAsync = fOptions.isAsyncWriter();
+  if (fOptions.getCompressionAlgorithm() >= 0) settings.fCompressionAlgorithm = fOptions.getCompressionAlgorithm();
+  if (fOptions.getCompressionLevel() >= 0) settings.fCompressionLevel = fOptions.getCompressionLevel();
+  if (fOptions.getBasketSize() > 0) settings.fBasketSize = fOptions.getBasketSize();
+  if (fOptions.getAutoSave() > 0) settings.fAutoSave = fOptions.getAutoSave();
+  if (fOutputQueue && !fOptions.isPersistentOutput(fOptions.getOptions().at("outputFileType"))) {
+    fWriter = new JPetWriter(fOutputQueue);
+  } else {
+    fWriter = new JPetWriter( outputFilename, settings );
+    fWriter->setOutputQueue(fOutputQueue);
+  }
   assert(fWriter);
   if (fTask) {
     fTask->setWriter(fWriter);
@@ -231,7 +502,10 @@ JPetTaskIO::~JPetTaskIO()
     delete fAuxilliaryData;
     fAuxilliaryData = 0;
   }
-
+  if (fInputHeader) {
+    delete fInputHeader;
+    fInputHeader = 0;
+  }
 }
 
 
@@ -27,6 +27,7 @@ class JPetReader;
 class JPetTreeHeader;
 class JPetStatistics;
 class JPetAuxilliaryData;
+class JPetEventQueue;
 //class JPetTask;
 
 
@@ -53,9 +54,27 @@ public:
 
   void setParamManager(JPetParamManager* paramManager);
 
+  /**
+   * @brief Streaming chain, see JPetTaskExecutor.
+   *
+   * With an input queue the events are taken from the queue filled by the previous
+   * task instead of the input file and the tree header is a copy of the previous one.
+   * With an output queue every written object is passed to the next task and the
+   * output file is created only if its type is one of the persistentOutputs options.
+   * Both have to be set before init().
+   */
+  void setInputQueue(JPetEventQueue* queue, const JPetTreeHeader* header);
+  void setOutputQueue(JPetEventQueue* queue);
+  inline const JPetTreeHeader* getHeader() const { return fHeader; }
+
 protected:
   virtual void createInputObjects(const char* inputFilename);
   virtual void createOutputObjects(const char* outputFilename);
+  void createStreamInputObjects();
+  void execStream();
+  JPetReaderInterface* createReader(const char* inputFilename) const;
+  bool execParallel(long long firstEvent, long long lastEvent, int nThreads);
+  void appendOutput(const std::string& fileName);
   void setUserLimits(const JPetOptions& opts,const long long totEventsFromReader, long long& firstEvent, long long& lastEvent) const;
 
   const JPetParamBank& getParamBank();
@@ -70,6 +89,10 @@ protected:
   JPetStatistics* fStatistics;
   JPetAuxilliaryData * fAuxilliaryData;
   JPetParamManager* fParamManager;
+  std::string fOutputFilename;
+  JPetEventQueue* fInputQueue;
+  JPetTreeHeader* fInputHeader;
+  JPetEventQueue* fOutputQueue;
 
 };
 #endif /*  !JPETTASKIO_H */
@@ -1,9 +1,45 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE JPetTaskLoaderTest
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <atomic>
+#include <string>
+#include <TFile.h>
+#include <TTree.h>
 #include "../JPetTaskLoader/JPetTaskLoader.h"
+#include "../JPetParamBank/JPetParamBank.h"
+#include "../JPetPhysSignal/JPetPhysSignal.h"
+#include "../JPetTreeHeader/JPetTreeHeader.h"
+#include "../JPetWriter/JPetWriter.h"
 
+namespace
+{
+const int kNbOfThreads = 3;
+const int kNbOfEvents = 30;
 
+std::string gOutputFile;
+std::atomic<int> gEventsWithParts(0);
+
+/// Copies the signals and checks that the temporary files of all the threads are next to the output file
+class CopySignals: public JPetTask
+{
+public:
+  CopySignals(): JPetTask("CopySignals", ""), fWriter(0) {}
+  virtual ParallelMode getParallelMode() const override { return kStateless; }
+  virtual JPetTask* cloneForThread() const override { return new CopySignals; }
+  virtual void setWriter(JPetWriter* writer) override { fWriter = writer; }
+  virtual void exec() override {
+    bool allParts = true;
+    for (int t = 0; t < kNbOfThreads; t++) {
+      allParts = allParts && boost::filesystem::exists(gOutputFile + ".part" + std::to_string(t));
+    }
+    if (allParts) gEventsWithParts++;
+    fWriter->write(*static_cast<JPetPhysSignal*>(getEvent()));
+  }
+private:
+  JPetWriter* fWriter;
+};
+}
 
 BOOST_AUTO_TEST_SUITE(FirstSuite)
 
@@ -23,4 +59,47 @@ BOOST_AUTO_TEST_CASE(defaultConstrutocTest)
     taskLoader.init(options);*/
 }
 
+BOOST_AUTO_TEST_CASE(parallelPartsAreWrittenNextToTheOutput)
+{
+  const boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  boost::filesystem::create_directories(dir);
+  const std::string inputFile = (dir / "run.raw.sig.root").native();
+  gOutputFile = (dir / "run.phys.sig.root").native();
+  {
+    JPetParamBank bank;
+    JPetWriter writer(inputFile.c_str());
+    for (int i = 0; i < kNbOfEvents; i++) {
+      JPetPhysSignal signal;
+      signal.setTime(i);
+      writer.write(signal);
+    }
+    writer.writeHeader(new JPetTreeHeader(1));
+    writer.writeObject(&bank, "ParamBank");
+    writer.closeFile();
+  }
+
+  JPetOptions::Options options = JPetOptions::getDefaultOptions();
+  options["inputFile"] = inputFile;
+  options["taskThreads"] = std::to_string(kNbOfThreads);
+  JPetParamManager paramManager;
+  JPetTaskLoader loader("raw.sig", "phys.sig", new CopySignals);
+  loader.setParamManager(&paramManager);
+  loader.init(options);
+  loader.exec();
+  loader.terminate();
+
+  BOOST_REQUIRE_EQUAL(gEventsWithParts.load(), kNbOfEvents);
+  for (int t = 0; t < kNbOfThreads; t++) {
+    BOOST_REQUIRE(!boost::filesystem::exists(gOutputFile + ".part" + std::to_string(t)));
+    BOOST_REQUIRE(!boost::filesystem::exists(".part" + std::to_string(t)));
+  }
+  {
+    TFile output(gOutputFile.c_str(), "READ");
+    TTree* tree = static_cast<TTree*>(output.Get("tree"));
+    BOOST_REQUIRE(tree);
+    BOOST_REQUIRE_EQUAL(tree->GetEntries(), kNbOfEvents);
+  }
+  boost::filesystem::remove_all(dir);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -21,6 +21,7 @@
 #include "Unpacker2/TDCHit.h"
 #include "Unpacker2/TDCHitExtended.h"
 #include "Unpacker2/TDCChannel.h"
+#include "Unpacker2/LeadTrailPairing.h"
 #include "Unpacker2/Unpacker2.h"
 #include <TH1F.h>
 #include <TF1.h>
@@ -34,6 +35,7 @@
 #include <TIterator.h>
 #include <TCollection.h>
 #include <unistd.h>
+#include <TStopwatch.h>
 
 using namespace std;
 
@@ -45,9 +47,14 @@ int JPetPostUnpackerFilter::calculate_hits(int eventsNum, const char* fileName)
   chain.Add(fileName);
     
   Event* pEvent = 0;
-  TDCHitExtended* pHit = 0;
-  TClonesArray* pArray = 0;
   chain.SetBranchAddress("event", &pEvent);
+  // only the time lines of the hits are needed
+  chain.SetBranchStatus("*", 0);
+  chain.SetBranchStatus("*TDCHits", 1);
+  chain.SetBranchStatus("*TDCHits.channel", 1);
+  chain.SetBranchStatus("*TDCHits.timeLineSize", 1);
+  chain.SetBranchStatus("*TDCHits.absoluteTimeLine*", 1);
+  chain.SetBranchStatus("*TDCHits.riseTimeLine*", 1);
 
   string newFileName = "";
   newFileName = string(fileName);
@@ -65,44 +72,22 @@ int JPetPostUnpackerFilter::calculate_hits(int eventsNum, const char* fileName)
   
   Int_t entries = (Int_t)chain.GetEntries();
 
-  double actualLead = -100000;
-  bool firstLeadFound = false;
-  
-  TIter * iter;
-  
+  TStopwatch timer;
+  timer.Start();
+  Int_t processed = 0;
   for(Int_t i = 0; i < entries; i++){
 
     //if (i % 10000 == 0) cerr<<i<<" of "<<entries<<"\r";
     if (i == eventsNum) break;
     chain.GetEntry(i);
-    pArray = pEvent->GetTDCHitsArray();
-    if (pArray == 0) continue;
-    iter = new TIter(pArray);
-    
-    
-    while( (pHit = (TDCHitExtended*) iter->Next()) ){
-      TDCChannel* new_ch = new_event->AddTDCChannel(pHit->GetChannel());
-      
-      // hit construction logic
-      actualLead = -100000;
-      firstLeadFound = false;
-	
-      for (int j = 0; j < pHit->GetTimeLineSize(); j++) {
-	if (pHit->GetRisingEdge(j) == true && firstLeadFound == false) {
-	  actualLead = pHit->GetAbsoluteTimeLine(j);
-	  firstLeadFound = true;
-	}
-	else if (pHit->GetRisingEdge(j) == false && firstLeadFound == true) {
-	  new_ch->AddHit(actualLead, pHit->GetAbsoluteTimeLine(j));
-	  firstLeadFound = false;	    
-	}
-      }
-    }
+    processed++;
+    if (!calculate_hits_for_event(pEvent, new_event)) continue;
     
     new_tree->Fill();
     new_event->Clear();
-    delete iter;
   }
+  timer.Stop();
+  print_rate("HITS", processed, timer.RealTime());
   
   new_tree->Write();
   
@@ -111,8 +96,23 @@ int JPetPostUnpackerFilter::calculate_hits(int eventsNum, const char* fileName)
   return 0;
 }
 
+bool JPetPostUnpackerFilter::calculate_hits_for_event(Event* pEvent, EventIII* new_event)
+{
+  TClonesArray* pArray = pEvent->GetTDCHitsArray();
+  if (pArray == 0) return false;
 
-int JPetPostUnpackerFilter::calculate_times(int eventsNum, const char* fileName, int refChannelOffset, const char* calibFile)
+  TDCHitExtended* pHit = 0;
+  TIter iter(pArray);
+  while( (pHit = (TDCHitExtended*) iter.Next()) ){
+    LeadTrailPairing pairing(new_event->AddTDCChannel(pHit->GetChannel()));
+    for (int j = 0; j < pHit->GetTimeLineSize(); j++) {
+      pairing.AddEdge(pHit->GetAbsoluteTimeLine(j), pHit->GetRisingEdge(j));
+    }
+  }
+  return true;
+}
+
+TH1F* JPetPostUnpackerFilter::load_calibration(int refChannelOffset, const char* calibFile)
 {
   TH1F* calibHist;
   TH1F* tmp;
@@ -134,8 +134,6 @@ int JPetPostUnpackerFilter::calculate_times(int eventsNum, const char* fileName,
     TDirectory* dir = gDirectory->GetDirectory("Rint:/");
     tmp = (TH1F*)file->Get("stretcher_offsets");
     
-    cerr<<"Calculated  calib loadedasdasd"<<endl;
-    
     calibHist = (TH1F*)(tmp->Clone("stretcher_offsets"));
     calibHist->SetDirectory(dir);
     
@@ -143,18 +141,38 @@ int JPetPostUnpackerFilter::calculate_times(int eventsNum, const char* fileName,
     
     file->Close();
   }
-  
-  //int localTrailIndex = 0;
-  //double lastTime = -1;
-  int localIndex = 0;
+  return calibHist;
+}
+
+void JPetPostUnpackerFilter::print_rate(const char* stage, int events, double seconds)
+{
+  cerr<<stage<<": "<<events<<" events in "<<seconds<<" s";
+  if (seconds > 0) cerr<<" ("<<events / seconds<<" events/s)";
+  cerr<<endl;
+}
+
+TH1F* JPetPostUnpackerFilter::create_multiplicity_histogram()
+{
+  TH1F* hist = new TH1F("timeline_multiplicity", "Number of edges in the time line of a channel", MAX_HITS * 2 + 1, -0.5, MAX_HITS * 2 + 0.5);
+  hist->SetDirectory(0);
+  return hist;
+}
+
+int JPetPostUnpackerFilter::calculate_times(int eventsNum, const char* fileName, int refChannelOffset, const char* calibFile)
+{
+  TH1F* calibHist = load_calibration(refChannelOffset, calibFile);
   
   TChain chain("T");
   chain.Add(fileName);
   
   Event* pEvent = 0;
-  TDCHit* pHit = 0;
-  TClonesArray* pArray = 0;
   chain.SetBranchAddress("event", &pEvent);
+  // only the channels and the lead and trail times of the hits are needed
+  chain.SetBranchStatus("*", 0);
+  chain.SetBranchStatus("*TDCHits", 1);
+  chain.SetBranchStatus("*TDCHits.channel", 1);
+  chain.SetBranchStatus("*TDCHits.lead*", 1);
+  chain.SetBranchStatus("*TDCHits.trail*", 1);
   
   string newFileName = string(fileName);
   cerr<<"TIMES:"<<newFileName<<endl;
@@ -170,21 +188,46 @@ int JPetPostUnpackerFilter::calculate_times(int eventsNum, const char* fileName,
   
   Int_t entries = (Int_t)chain.GetEntries();
   cout<<"Entries = " <<entries<<endl;
+
+  TimelineBuffer buffer;
+  TH1F* multiplicityHist = create_multiplicity_histogram();
   
+ TStopwatch timer;
+ timer.Start();
+ Int_t processed = 0;
+ for(Int_t i = 0; i < entries; i++){
+
+   if (i == eventsNum) break;
+   chain.GetEntry(i);
+   processed++;
+   if (!calculate_times_for_event(pEvent, new_event, refChannelOffset, calibHist, buffer, multiplicityHist)) continue;
+   new_tree->Fill();
+   new_event->Clear();
+ }
+ 
+ timer.Stop();
+ print_rate("TIMES", processed, timer.RealTime());
+ 
+ new_tree->Write();
+ multiplicityHist->Write();
+ delete multiplicityHist;
+ 
+ new_file->Close();
+ 
+ return 0;
+}
+
+bool JPetPostUnpackerFilter::calculate_times_for_event(Event* pEvent, Event* new_event, int refChannelOffset, TH1F* calibHist, TimelineBuffer& buffer, TH1F* multiplicityHist)
+{
+  TDCHit* pHit = 0;
+  TClonesArray* pArray = pEvent->GetTDCHitsArray();
+  if (pArray == 0) return false;
 
  int refTimeEpoch[REF_CHANNELS_NUMBER];
  int refTimeCoarse[REF_CHANNELS_NUMBER];
  int refTimeFine[REF_CHANNELS_NUMBER];
  
- TIter * iter;
-
- for(Int_t i = 0; i < entries; i++){
-
-   if (i == eventsNum) break;
-   chain.GetEntry(i);
-   pArray = pEvent->GetTDCHitsArray();
-   if (pArray == 0) continue;
-   iter = new TIter(pArray);
+   TIter iter(pArray);
    
    for(int l = 0; l < REF_CHANNELS_NUMBER; l++) {
      refTimeEpoch[l] = -222222;
@@ -193,7 +236,7 @@ int JPetPostUnpackerFilter::calculate_times(int eventsNum, const char* fileName,
    }
    
    // fetch the reference times
-   while( (pHit = (TDCHit*) iter->Next()) ) {
+   while( (pHit = (TDCHit*) iter.Next()) ) {
      if (pHit->GetChannel() % refChannelOffset == 0){
        
        refTimeEpoch[pHit->GetChannel() / refChannelOffset] = pHit->GetLeadEpoch(0);
@@ -216,16 +259,14 @@ int JPetPostUnpackerFilter::calculate_times(int eventsNum, const char* fileName,
      }
    }
    // create time lines for normal channels
-   iter->Begin();
-   while( (pHit = (TDCHit*) iter->Next()) ){
+   iter.Begin();
+   while( (pHit = (TDCHit*) iter.Next()) ){
      if ( (pHit->GetLeadsNum() > 0 && pHit->GetTrailsNum() > 0) && ((pHit->GetChannel() % refChannelOffset) != 0) ){
        TDCHitExtended* new_hit = new_event->AddTDCHitExtended(pHit->GetChannel());
-       //localTrailIndex = 0;
-       //lastTime = -1;
-       localIndex = 0;
        
        int tdc_number = pHit->GetChannel() / refChannelOffset;
        
+       buffer.leads.clear();
        for (int j = 0; j < pHit->GetLeadsNum(); j++) {
 
 	 double leadTime = (double) (
@@ -235,26 +276,9 @@ int JPetPostUnpackerFilter::calculate_times(int eventsNum, const char* fileName,
 										)
 				     );
 	 leadTime += ((((pHit->GetLeadCoarse(j) - refTimeCoarse[tdc_number]) * 5000.) - (pHit->GetLeadFine(j) - refTimeFine[tdc_number])) / 1000.);
-	 if (localIndex > 0) {
-	   for(int l = 0; l <= localIndex; l++)
-	     {
-	       if (leadTime < new_hit->GetAbsoluteTimeLine(l) || l == localIndex) {
-		 new_hit->ShiftEverythingUpByOne(l - 1);
-		 new_hit->SetAbsoluteTimeLine(leadTime, l);
-		 new_hit->SetRisingEdge(true, l);
-		 localIndex++;
-		 new_hit->SetTimeLineSize(localIndex);
-		 break;
-	       }
-	     }
-	 }
-	 else {
-	   new_hit->SetAbsoluteTimeLine(leadTime, 0);
-	   new_hit->SetRisingEdge(true, 0);
-	   localIndex++;
-	   new_hit->SetTimeLineSize(localIndex);
-	 }
+	 buffer.leads.push_back(leadTime);
        }
+       buffer.trails.clear();
        for (int k = 0; k < pHit->GetTrailsNum(); k++){
 
 	 double trailTime = (double) (
@@ -268,37 +292,51 @@ int JPetPostUnpackerFilter::calculate_times(int eventsNum, const char* fileName,
 	 //cerr<<calibHist->GetBinContent(pHit->GetChannel() + 1)<<endl;
 	 
 	 trailTime += ( (((pHit->GetTrailCoarse(k) - refTimeCoarse[tdc_number]) * 5000.) - (pHit->GetTrailFine(k) - refTimeFine[tdc_number])) / 1000.);
-	 
-	 if (localIndex > 0) {
-	   for(int l = 0; l <= localIndex; l++){
-	     if (trailTime < new_hit->GetAbsoluteTimeLine(l) || l == localIndex ) {
-	       new_hit->ShiftEverythingUpByOne(l - 1);
-	       new_hit->SetAbsoluteTimeLine(trailTime, l);
-	       new_hit->SetRisingEdge(false, l);
-	       localIndex++;
-	       new_hit->SetTimeLineSize(localIndex);
-	       break;
-	     }
-	   }
-	 }
-	 else {
-	   new_hit->SetAbsoluteTimeLine(trailTime, 0);
-	   new_hit->SetRisingEdge(false, 0);
-	   localIndex++;
-	   new_hit->SetTimeLineSize(localIndex);
-	 }
+	 buffer.trails.push_back(trailTime);
        }
-       new_hit->SetTimeLineSize(localIndex);
+       merge_timeline(buffer, new_hit);
+       if (multiplicityHist) multiplicityHist->Fill(new_hit->GetTimeLineSize());
      }
    }
-   new_tree->Fill();
-   new_event->Clear();
-   delete iter;
- }
- 
- new_tree->Write();
- 
- new_file->Close();
- 
- return 0;
+   return true;
+}
+
+namespace
+{
+/// Stable insertion sort, linear for the already ordered leads and trails of a TDC channel.
+void sort_times(std::vector<double>& times)
+{
+  for (size_t i = 1; i < times.size(); i++) {
+    double time = times[i];
+    size_t j = i;
+    while (j > 0 && time < times[j - 1]) {
+      times[j] = times[j - 1];
+      j--;
+    }
+    times[j] = time;
+  }
+}
+}
+
+void JPetPostUnpackerFilter::merge_timeline(TimelineBuffer& buffer, TDCHitExtended* new_hit)
+{
+  sort_times(buffer.leads);
+  sort_times(buffer.trails);
+
+  // a lead goes before a trail with the same time, as it was inserted first
+  const size_t maxSize = MAX_HITS * 2;
+  size_t l = 0;
+  size_t t = 0;
+  size_t index = 0;
+  while ((l < buffer.leads.size() || t < buffer.trails.size()) && index < maxSize) {
+    if (t == buffer.trails.size() || (l < buffer.leads.size() && !(buffer.trails[t] < buffer.leads[l]))) {
+      new_hit->SetAbsoluteTimeLine(buffer.leads[l++], index);
+      new_hit->SetRisingEdge(true, index);
+    } else {
+      new_hit->SetAbsoluteTimeLine(buffer.trails[t++], index);
+      new_hit->SetRisingEdge(false, index);
+    }
+    index++;
+  }
+  new_hit->SetTimeLineSize(index);
 }
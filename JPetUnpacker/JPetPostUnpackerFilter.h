@@ -16,6 +16,13 @@
 #ifndef _POST_UNPACKER_FILTER_
 #define _POST_UNPACKER_FILTER_
 
+#include <vector>
+
+class Event;
+class EventIII;
+class TDCHitExtended;
+class TH1F;
+
 class JPetPostUnpackerFilter{
 
  public:
@@ -23,6 +30,28 @@ class JPetPostUnpackerFilter{
   static int calculate_hits(int eventsNum, const char* fileName);
 
   static int calculate_times(int eventsNum, const char* fileName, int refChannelOffset, const char* calibFile);
+
+  /// Loads the stretcher offsets used by calculate_times, zero offsets if calibFile is not a root file.
+  static TH1F* load_calibration(int refChannelOffset, const char* calibFile);
+
+  /// Lead and trail times of one channel, reused for all the channels to avoid allocations.
+  struct TimelineBuffer {
+    std::vector<double> leads;
+    std::vector<double> trails;
+  };
+
+  /// Histogram of the number of edges in the time line of a channel, filled by calculate_times.
+  static TH1F* create_multiplicity_histogram();
+
+  /// Single-event steps of calculate_times and calculate_hits. They return false if the input event has no hits array.
+  static bool calculate_times_for_event(Event* pEvent, Event* new_event, int refChannelOffset, TH1F* calibHist, TimelineBuffer& buffer, TH1F* multiplicityHist = 0);
+  static bool calculate_hits_for_event(Event* pEvent, EventIII* new_event);
+
+  /// Merges the leads and trails of the buffer into the time ordered time line of new_hit.
+  static void merge_timeline(TimelineBuffer& buffer, TDCHitExtended* new_hit);
+
+  /// Prints the number of processed events per second of a stage.
+  static void print_rate(const char* stage, int events, double seconds);
   
  private:
   
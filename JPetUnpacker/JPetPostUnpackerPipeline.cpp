@@ -0,0 +1,86 @@
+/**
+ *  @copyright Copyright 2016 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetPostUnpackerPipeline.cpp
+ */
+
+#include "JPetPostUnpackerPipeline.h"
+#include "JPetPostUnpackerFilter.h"
+#include "Unpacker2/Event.h"
+#include "Unpacker2/CompactEvent.h"
+#include "Unpacker2/TDCHitExtended.h"
+#include <TClonesArray.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <TH1F.h>
+#include <TStopwatch.h>
+
+JPetPostUnpackerPipeline::JPetPostUnpackerPipeline(const std::string& outputFileName, int refChannelOffset, const char* calibFile):
+  fFile(0),
+  fTree(0),
+  fEvent(new CompactEvent()),
+  fTimesEvent(new Event()),
+  fCalibHist(0),
+  fMultiplicityHist(0),
+  fRefChannelOffset(refChannelOffset),
+  fProcessedEvents(0)
+{
+  fCalibHist = JPetPostUnpackerFilter::load_calibration(refChannelOffset, calibFile);
+  fMultiplicityHist = JPetPostUnpackerFilter::create_multiplicity_histogram();
+
+  fFile = new TFile(outputFileName.c_str(), "RECREATE");
+  fTree = new TTree("T", "Times converted into hit units");
+  Int_t split = 2;
+  Int_t bsize = 64000;
+  fTree->Branch("compactEvent", "CompactEvent", &fEvent, bsize, split);
+
+  fTimer.Start();
+}
+
+JPetPostUnpackerPipeline::~JPetPostUnpackerPipeline()
+{
+  close();
+  delete fTimesEvent;
+  delete fEvent;
+  delete fMultiplicityHist;
+}
+
+void JPetPostUnpackerPipeline::Process(Event* evt)
+{
+  if (!JPetPostUnpackerFilter::calculate_times_for_event(evt, fTimesEvent, fRefChannelOffset, fCalibHist, fBuffer, fMultiplicityHist)) return;
+  TClonesArray* pArray = fTimesEvent->GetTDCHitsArray();
+  TDCHitExtended* pHit = 0;
+  TIter iter(pArray);
+  while ( (pHit = (TDCHitExtended*) iter.Next()) ) {
+    fEvent->AddTimeLine(pHit);
+  }
+  fTree->Fill();
+  fEvent->Clear();
+  fTimesEvent->Clear();
+  fProcessedEvents++;
+}
+
+void JPetPostUnpackerPipeline::close()
+{
+  if (fFile) {
+    fTimer.Stop();
+    JPetPostUnpackerFilter::print_rate("UNPACKER PIPELINE", fProcessedEvents, fTimer.RealTime());
+
+    fFile->cd();
+    fTree->Write();
+    fMultiplicityHist->Write();
+    fFile->Close();
+    delete fFile;
+    fFile = 0;
+    fTree = 0;
+  }
+}
@@ -0,0 +1,68 @@
+/**
+ *  @copyright Copyright 2016 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetPostUnpackerPipeline.h
+ *  @brief Applies the post-unpacker filters in memory to the events coming from the unpacker
+ */
+
+#ifndef _POST_UNPACKER_PIPELINE_
+#define _POST_UNPACKER_PIPELINE_
+
+#include <string>
+#include <TStopwatch.h>
+#include "./Unpacker2/EventSink.h"
+#include "JPetPostUnpackerFilter.h"
+
+class CompactEvent;
+class Event;
+class TH1F;
+class TFile;
+class TTree;
+
+/**
+ * @brief Event sink performing calculate_times on every unpacked event.
+ *
+ * The time lines are written as CompactEvent objects (branch "compactEvent")
+ * to the same .hld.root file as the file-based JPetPostUnpackerFilter chain
+ * would produce, together with the time line multiplicity histogram.
+ * The hits are built from the time lines when the file is read,
+ * see CompactEvent::FillEventIII and JPetHLDReader.
+ */
+class JPetPostUnpackerPipeline: public EventSink
+{
+public:
+  JPetPostUnpackerPipeline(const std::string& outputFileName, int refChannelOffset, const char* calibFile);
+  ~JPetPostUnpackerPipeline();
+
+  void Process(Event* evt);
+  void close();
+
+  inline int getProcessedEvents() const { return fProcessedEvents; }
+  inline const TH1F* getMultiplicityHistogram() const { return fMultiplicityHist; }
+
+private:
+  JPetPostUnpackerPipeline(const JPetPostUnpackerPipeline&);
+  JPetPostUnpackerPipeline& operator=(const JPetPostUnpackerPipeline&);
+
+  TFile* fFile;
+  TTree* fTree;
+  CompactEvent* fEvent;
+  Event* fTimesEvent;
+  TH1F* fCalibHist;
+  TH1F* fMultiplicityHist;
+  JPetPostUnpackerFilter::TimelineBuffer fBuffer;
+  int fRefChannelOffset;
+  int fProcessedEvents;
+  TStopwatch fTimer;
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include <cassert>
 
 #include "JPetPostUnpackerFilter.h"
+#include "JPetPostUnpackerPipeline.h"
 
 ClassImp(JPetUnpacker);
 
@@ -27,7 +28,9 @@ JPetUnpacker::JPetUnpacker():
 fUnpacker(0),
 fEventsToProcess(0),
 fHldFile(""),
-fCfgFile("")
+fCfgFile(""),
+fThreads(1),
+fIntermediateFiles(false)
 {
   /**/
 }
@@ -70,14 +73,23 @@ bool JPetUnpacker::exec()
     delete fUnpacker;
     fUnpacker = 0;
   }
-  fUnpacker = new Unpacker2(fHldFile.c_str(), fCfgFile.c_str(), fEventsToProcess);
-
-  // apply post-unpacking filters
-  string newFileName = fHldFile + ".raw.root";
 
   // @todo: handle the following parameters needed by calculate_times
   //const char * calibFileName = "";
   int refChannelOffset = 65;
+
+  if (!fIntermediateFiles) {
+    // apply post-unpacking filters to every event in memory
+    JPetPostUnpackerPipeline pipeline(fHldFile + ".root", refChannelOffset, "");
+    fUnpacker = new Unpacker2(fHldFile.c_str(), fCfgFile.c_str(), fEventsToProcess, fThreads, &pipeline, false);
+    pipeline.close();
+    return true;
+  }
+
+  fUnpacker = new Unpacker2(fHldFile.c_str(), fCfgFile.c_str(), fEventsToProcess, fThreads);
+
+  // apply post-unpacking filters
+  string newFileName = fHldFile + ".raw.root";
   JPetPostUnpackerFilter::calculate_times(fEventsToProcess, newFileName.c_str(), refChannelOffset, "");
 
   newFileName = newFileName.substr(0, newFileName.size() - 8);
@@ -34,15 +34,23 @@ class JPetUnpacker: public TObject
   inline int getEventsToProcess() const { return fEventsToProcess; }
   inline std::string getHldFile() const { return fHldFile; }
   inline std::string getCfgFile() const { return fCfgFile; }
+  inline int getThreads() const { return fThreads; }
+  inline void setThreads(int threads) { fThreads = threads; }
+  /// If set, the unpacker writes the .raw.root and .times.root files and runs the post-unpacker filters on them
+  /// instead of processing every event in memory.
+  inline bool getIntermediateFiles() const { return fIntermediateFiles; }
+  inline void setIntermediateFiles(bool intermediateFiles) { fIntermediateFiles = intermediateFiles; }
   void setParams(const std::string& hldFile, int numOfEvents = 100000000, const std::string& cfgFile = "conf_trb3.xml");
 
-  ClassDef(JPetUnpacker, 1);
+  ClassDef(JPetUnpacker, 3);
 
  private:
   Unpacker2* fUnpacker;  
   int fEventsToProcess;
   std::string fHldFile;
   std::string fCfgFile;
+  int fThreads;
+  bool fIntermediateFiles;
 };
 
 #endif
@@ -3,6 +3,26 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
 #include "../JPetUnpacker/JPetUnpacker.h"
+#include "../JPetUnpacker/JPetPostUnpackerFilter.h"
+#include "../JPetUnpacker/Unpacker2/HLDFile.h"
+#include "../JPetUnpacker/Unpacker2/UnpackingModule.h"
+#include "../JPetUnpacker/Unpacker2/Unpacker_Lattice_TDC.h"
+#include "../JPetUnpacker/Unpacker2/TDCDecoder.h"
+#include "../JPetUnpacker/Unpacker2/EventIII.h"
+#include "../JPetUnpacker/Unpacker2/TDCChannel.h"
+#include "../JPetUnpacker/Unpacker2/CompactEvent.h"
+#include "../JPetUnpacker/Unpacker2/TDCHitExtended.h"
+#include "../JPetUnpacker/Unpacker2/Unpacker2.h"
+#include "../JPetUnpacker/Unpacker2/EventSink.h"
+#include "../JPetUnpacker/Unpacker2/Event.h"
+#include <TTree.h>
+#include <TRandom3.h>
+#include <TStopwatch.h>
+#include <TFile.h>
+#include <TH1F.h>
+#include <cstring>
+#include <fstream>
+#include <vector>
 
 
 
@@ -68,4 +88,400 @@ BOOST_FIXTURE_TEST_CASE( my_test4, Fixture )
   BOOST_REQUIRE(!unpack.exec());
 }
 
+BOOST_FIXTURE_TEST_CASE( inMemoryPipelineMatchesIntermediateFiles, Fixture )
+{
+  const std::string hldFile = "unitTestData/JPetUnpackerTest/xx14099113231.hld";
+  const std::string outputFile = hldFile + ".root";
+  const std::string referenceFile = hldFile + ".reference.root";
+
+  JPetUnpacker unpack;
+  unpack.setParams(hldFile, 10, "unitTestData/JPetUnpackerTest/conf_trb3.xml");
+  unpack.setIntermediateFiles(true);
+  BOOST_REQUIRE(unpack.exec());
+  BOOST_REQUIRE(boost::filesystem::exists(hldFile + ".raw.root"));
+  BOOST_REQUIRE(boost::filesystem::exists(hldFile + ".times.root"));
+  boost::filesystem::rename(outputFile, referenceFile);
+  boost::filesystem::remove(hldFile + ".raw.root");
+  boost::filesystem::remove(hldFile + ".times.root");
+
+  unpack.setIntermediateFiles(false);
+  BOOST_REQUIRE(unpack.exec());
+  BOOST_REQUIRE(!boost::filesystem::exists(hldFile + ".raw.root"));
+  BOOST_REQUIRE(!boost::filesystem::exists(hldFile + ".times.root"));
+
+  TFile reference(referenceFile.c_str(), "READ");
+  TFile output(outputFile.c_str(), "READ");
+  TTree* referenceTree = (TTree*)reference.Get("T");
+  TTree* outputTree = (TTree*)output.Get("T");
+  BOOST_REQUIRE(referenceTree);
+  BOOST_REQUIRE(outputTree);
+  BOOST_REQUIRE_EQUAL(outputTree->GetEntries(), referenceTree->GetEntries());
+
+  EventIII* referenceEvent = 0;
+  CompactEvent* compactEvent = 0;
+  EventIII* outputEvent = new EventIII();
+  referenceTree->SetBranchAddress("eventIII", &referenceEvent);
+  outputTree->SetBranchAddress("compactEvent", &compactEvent);
+  for (Long64_t i = 0; i < referenceTree->GetEntries(); i++) {
+    referenceTree->GetEntry(i);
+    outputTree->GetEntry(i);
+    outputEvent->Clear();
+    compactEvent->FillEventIII(outputEvent);
+    BOOST_REQUIRE_EQUAL(outputEvent->GetTotalNTDCChannels(), referenceEvent->GetTotalNTDCChannels());
+    for (int j = 0; j < referenceEvent->GetTotalNTDCChannels(); j++) {
+      TDCChannel* referenceChannel = (TDCChannel*)referenceEvent->GetTDCChannelsArray()->At(j);
+      TDCChannel* outputChannel = (TDCChannel*)outputEvent->GetTDCChannelsArray()->At(j);
+      BOOST_REQUIRE_EQUAL(outputChannel->GetChannel(), referenceChannel->GetChannel());
+      BOOST_REQUIRE_EQUAL(outputChannel->GetHitsNum(), referenceChannel->GetHitsNum());
+      for (int k = 0; k < referenceChannel->GetHitsNum(); k++) {
+        BOOST_REQUIRE_EQUAL(outputChannel->GetLeadTime(k), referenceChannel->GetLeadTime(k));
+        BOOST_REQUIRE_EQUAL(outputChannel->GetTrailTime(k), referenceChannel->GetTrailTime(k));
+      }
+    }
+  }
+  delete outputEvent;
+  reference.Close();
+  output.Close();
+  boost::filesystem::remove(referenceFile);
+}
+
+BOOST_AUTO_TEST_CASE( compactEventBuildsTheSameHits )
+{
+  // time lines with unpaired and repeated edges
+  const double firstTimes[] = {10., 12., 15., 16., 20.};
+  const bool firstEdges[] = {true, true, false, false, true};
+  const double secondTimes[] = {5., 6., 9.};
+  const bool secondEdges[] = {false, true, false};
+  Event times;
+  TDCHitExtended* first = times.AddTDCHitExtended(3);
+  for (int i = 0; i < 5; i++) {
+    first->SetAbsoluteTimeLine(firstTimes[i], i);
+    first->SetRisingEdge(firstEdges[i], i);
+  }
+  first->SetTimeLineSize(5);
+  TDCHitExtended* second = times.AddTDCHitExtended(7);
+  for (int i = 0; i < 3; i++) {
+    second->SetAbsoluteTimeLine(secondTimes[i], i);
+    second->SetRisingEdge(secondEdges[i], i);
+  }
+  second->SetTimeLineSize(3);
+  times.AddTDCHitExtended(8)->SetTimeLineSize(0);
+
+  CompactEvent compact;
+  TClonesArray* pArray = times.GetTDCHitsArray();
+  for (int i = 0; i < pArray->GetEntries(); i++) {
+    compact.AddTimeLine((TDCHitExtended*)pArray->At(i));
+  }
+  BOOST_REQUIRE_EQUAL(compact.GetChannelsNum(), 3);
+  BOOST_REQUIRE_EQUAL(compact.GetTotalEdgesNum(), 8);
+  BOOST_REQUIRE_EQUAL(compact.GetEdgesNum(0), 5);
+  BOOST_REQUIRE_EQUAL(compact.GetEdgesNum(1), 3);
+  BOOST_REQUIRE_EQUAL(compact.GetEdgesNum(2), 0);
+  BOOST_REQUIRE_EQUAL(compact.GetChannel(1), 7);
+  BOOST_REQUIRE_EQUAL(compact.GetTime(1, 1), 6.);
+  BOOST_REQUIRE(compact.IsRisingEdge(1, 1));
+
+  EventIII reference;
+  BOOST_REQUIRE(JPetPostUnpackerFilter::calculate_hits_for_event(&times, &reference));
+  EventIII output;
+  compact.FillEventIII(&output);
+  BOOST_REQUIRE_EQUAL(output.GetTotalNTDCChannels(), reference.GetTotalNTDCChannels());
+  for (int j = 0; j < reference.GetTotalNTDCChannels(); j++) {
+    TDCChannel* referenceChannel = (TDCChannel*)reference.GetTDCChannelsArray()->At(j);
+    TDCChannel* outputChannel = (TDCChannel*)output.GetTDCChannelsArray()->At(j);
+    BOOST_REQUIRE_EQUAL(outputChannel->GetChannel(), referenceChannel->GetChannel());
+    BOOST_REQUIRE_EQUAL(outputChannel->GetHitsNum(), referenceChannel->GetHitsNum());
+    for (int k = 0; k < referenceChannel->GetHitsNum(); k++) {
+      BOOST_REQUIRE_EQUAL(outputChannel->GetLeadTime(k), referenceChannel->GetLeadTime(k));
+      BOOST_REQUIRE_EQUAL(outputChannel->GetTrailTime(k), referenceChannel->GetTrailTime(k));
+    }
+  }
+
+  compact.Clear();
+  BOOST_REQUIRE_EQUAL(compact.GetChannelsNum(), 0);
+  BOOST_REQUIRE_EQUAL(compact.GetTotalEdgesNum(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( timelineMergeOfHighMultiplicityChannels )
+{
+  const int refChannelOffset = 65;
+  TH1F* calibHist = JPetPostUnpackerFilter::load_calibration(refChannelOffset, "");
+  TH1F* multiplicityHist = JPetPostUnpackerFilter::create_multiplicity_histogram();
+  JPetPostUnpackerFilter::TimelineBuffer buffer;
+
+  // a reference channel and a noisy channel with MAX_HITS leads and trails,
+  // some of them out of order and some of the leads and trails at the same time
+  Event event;
+  TDCHit* ref = event.AddTDCHit(0);
+  ref->AddLeadTime(100, 10, 1);
+  TDCHit* noisy = event.AddTDCHit(1);
+  for (int i = 0; i < MAX_HITS; i++) {
+    noisy->AddLeadTime(0, 20 + 2 * i + (i % 7 == 3 ? 3 : 0), 1);
+    noisy->AddTrailTime(0, 21 + 2 * i - (i % 5 == 2 ? 1 : 0), 1);
+  }
+
+  Event times;
+  BOOST_REQUIRE(JPetPostUnpackerFilter::calculate_times_for_event(&event, &times, refChannelOffset, calibHist, buffer, multiplicityHist));
+  BOOST_REQUIRE_EQUAL(times.GetTotalNTDCHits(), 2);
+  TDCHitExtended* timeline = (TDCHitExtended*)times.GetTDCHitsArray()->At(1);
+  BOOST_REQUIRE_EQUAL(timeline->GetTimeLineSize(), 2 * MAX_HITS);
+  int leads = 0;
+  for (int i = 0; i < timeline->GetTimeLineSize(); i++) {
+    if (timeline->GetRisingEdge(i)) leads++;
+    if (i > 0) {
+      BOOST_REQUIRE(timeline->GetAbsoluteTimeLine(i - 1) <= timeline->GetAbsoluteTimeLine(i));
+      // a lead goes before a trail with the same time
+      if (timeline->GetAbsoluteTimeLine(i - 1) == timeline->GetAbsoluteTimeLine(i))
+        BOOST_REQUIRE(timeline->GetRisingEdge(i - 1) || !timeline->GetRisingEdge(i));
+    }
+  }
+  BOOST_REQUIRE_EQUAL(leads, MAX_HITS);
+  BOOST_REQUIRE_EQUAL(multiplicityHist->GetBinContent(multiplicityHist->FindBin(2 * MAX_HITS)), 1);
+
+  const int events = 10000;
+  TStopwatch timer;
+  timer.Start();
+  for (int i = 0; i < events; i++) {
+    times.Clear();
+    JPetPostUnpackerFilter::calculate_times_for_event(&event, &times, refChannelOffset, calibHist, buffer);
+  }
+  timer.Stop();
+  BOOST_TEST_MESSAGE("time lines of " << events << " events with " << 2 * MAX_HITS << " edges: " << timer.RealTime() << " s");
+
+  delete multiplicityHist;
+  delete calibHist;
+}
+
+BOOST_AUTO_TEST_CASE( hldFileMatchesStream )
+{
+  const char* fileName = "unitTestData/JPetUnpackerTest/xx14099113231.hld";
+  HLDFile file;
+  BOOST_REQUIRE(file.Open(fileName));
+  std::ifstream stream(fileName, std::ios::binary);
+  stream.seekg(0, std::ios::end);
+  BOOST_REQUIRE_EQUAL(file.GetSize(), (size_t)stream.tellg());
+
+  std::vector<char> expected(64);
+  stream.seekg(32);
+  stream.read(expected.data(), expected.size());
+  const char* data = file.Get(32, expected.size());
+  BOOST_REQUIRE(data);
+  BOOST_REQUIRE(std::memcmp(data, expected.data(), expected.size()) == 0);
+  BOOST_REQUIRE(!file.Get(file.GetSize(), 1));
+}
+
+BOOST_AUTO_TEST_CASE( addressDispatchMatchesStringLookup )
+{
+  UnpackingModule hub("TRB3_S", "8000", "8000", 0, 0, 0, "", false, false);
+  UnpackingModule tdc0("LATTICE_TDC", "e000", "8000", 0, 0, 0, "TDC", false, false);
+  UnpackingModule tdc1("LATTICE_TDC", "e003", "8000", 0, 0, 0, "TDC", false, false);
+  hub.AddUnpacker("e000", &tdc0);
+  hub.AddUnpacker("e003", &tdc1);
+  AddressTable table;
+  hub.RegisterAddresses(table);
+  hub.SetAddressTable(&table);
+  BOOST_REQUIRE_EQUAL(table.GetNumberOfSlots(), 2u);
+
+  BOOST_REQUIRE(hub.GetUnpacker(0xe000) == &tdc0);
+  BOOST_REQUIRE(hub.GetUnpacker(0xe003) == &tdc1);
+  BOOST_REQUIRE(hub.GetUnpacker(0xe001) == NULL);
+  BOOST_REQUIRE(hub.GetUnpacker(0x1e000) == NULL);
+
+  // the modules of another worker use the same table without registering again
+  UnpackingModule otherHub("TRB3_S", "8000", "8000", 0, 0, 0, "", false, false);
+  UnpackingModule otherTdc0("LATTICE_TDC", "e000", "8000", 0, 0, 0, "TDC", false, false);
+  UnpackingModule otherTdc1("LATTICE_TDC", "e003", "8000", 0, 0, 0, "TDC", false, false);
+  otherHub.AddUnpacker("e000", &otherTdc0);
+  otherHub.AddUnpacker("e003", &otherTdc1);
+  otherHub.SetAddressTable(&table);
+  BOOST_REQUIRE_EQUAL(table.GetNumberOfSlots(), 2u);
+  BOOST_REQUIRE(otherHub.GetUnpacker(0xe000) == &otherTdc0);
+  BOOST_REQUIRE(otherHub.GetUnpacker(0xe003) == &otherTdc1);
+  BOOST_REQUIRE(hub.GetUnpacker(0xe000) == &tdc0);
+
+  const int lookups = 1000000;
+  const UInt_t addresses[4] = {0xe000, 0xe001, 0xe002, 0xe003};
+  TStopwatch timer;
+  int found = 0;
+  timer.Start();
+  for (int i = 0; i < lookups; i++) {
+    if (hub.GetUnpacker(hub.UIntToString(addresses[i % 4]))) found++;
+  }
+  timer.Stop();
+  double stringTime = timer.RealTime();
+  BOOST_REQUIRE_EQUAL(found, lookups / 2);
+
+  found = 0;
+  timer.Start();
+  for (int i = 0; i < lookups; i++) {
+    if (hub.GetUnpacker(addresses[i % 4])) found++;
+  }
+  timer.Stop();
+  BOOST_REQUIRE_EQUAL(found, lookups / 2);
+  BOOST_TEST_MESSAGE("dispatch of " << lookups << " subevents: string lookup " << stringTime << " s, address table " << timer.RealTime() << " s");
+}
+
+BOOST_AUTO_TEST_CASE( latticeTDCClearResetsMultiplicities )
+{
+  Unpacker_Lattice_TDC tdc("LATTICE_TDC", "e000", "8000", 4, 0, 0, "TDC", false, false, "raw");
+
+  // epoch word, then a rising and a falling edge on channel 2
+  UInt_t words[3] = {0x60000007, 0x80801805, 0x80801006};
+  tdc.SetEntireEventSize(3);
+  tdc.ProcessEvent(words);
+  BOOST_REQUIRE_EQUAL(tdc.GetLeadMult(2), 1);
+  BOOST_REQUIRE_EQUAL(tdc.GetTrailMult(2), 1);
+  BOOST_REQUIRE_EQUAL(tdc.GetLeadFineTime(2, 0), 10);
+  BOOST_REQUIRE_EQUAL(tdc.GetLeadCoarseTime(2, 0), 5);
+  BOOST_REQUIRE_EQUAL(tdc.GetLeadEpoch(2, 0), 7);
+  BOOST_REQUIRE_EQUAL(tdc.GetTrailFineTime(2, 0), 10);
+  BOOST_REQUIRE_EQUAL(tdc.GetTrailCoarseTime(2, 0), 6);
+
+  const int events = 100000;
+  TStopwatch timer;
+  timer.Start();
+  for (int i = 0; i < events; i++) {
+    tdc.Clear();
+    tdc.ProcessEvent(words);
+  }
+  timer.Stop();
+  BOOST_TEST_MESSAGE("clear and unpack of " << events << " events: " << timer.RealTime() << " s");
+
+  tdc.Clear();
+  for (int i = 0; i < 4; i++) {
+    BOOST_REQUIRE_EQUAL(tdc.GetLeadMult(i), 0);
+    BOOST_REQUIRE_EQUAL(tdc.GetTrailMult(i), 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( latticeTDCCorrectionTableMatchesHistograms )
+{
+  const char* correctionFile = "latticeTDCCorrectionTest.root";
+  TFile* file = new TFile(correctionFile, "RECREATE");
+  for (int channel = 0; channel < 4; channel++) {
+    TH1F* correction = new TH1F(Form("correction%d", channel), "", 1024, 0, 1024);
+    for (int bin = 1; bin <= 1024; bin++) {
+      correction->SetBinContent(bin, bin * 4.37 + channel * 0.1);
+    }
+  }
+  file->Write();
+  file->Close();
+  delete file;
+
+  Unpacker_Lattice_TDC tdc("LATTICE_TDC", "e000", "8000", 4, 0, 0, "TDC", false, false, correctionFile);
+
+  // rising edges on channel 2 with fine times 1 and 1022, falling edge with fine time 517
+  UInt_t words[4] = {0x60000001, 0x80801805, 0x80bfe805, 0x80a05006};
+  tdc.SetEntireEventSize(4);
+  tdc.ProcessEvent(words);
+
+  file = new TFile(correctionFile, "READ");
+  TH1F* correction = (TH1F*)file->Get("correction2");
+  BOOST_REQUIRE(correction);
+  BOOST_REQUIRE_EQUAL(tdc.GetLeadMult(2), 2);
+  BOOST_REQUIRE_EQUAL(tdc.GetLeadFineTime(2, 0), (int)correction->GetBinContent(1 + 1));
+  BOOST_REQUIRE_EQUAL(tdc.GetLeadFineTime(2, 1), (int)correction->GetBinContent(1022 + 1));
+  BOOST_REQUIRE_EQUAL(tdc.GetTrailMult(2), 1);
+  BOOST_REQUIRE_EQUAL(tdc.GetTrailFineTime(2, 0), (int)correction->GetBinContent(517 + 1));
+  file->Close();
+  delete file;
+
+  boost::filesystem::remove(correctionFile);
+}
+
+BOOST_AUTO_TEST_CASE( tdcDecoderModesMatchScalar )
+{
+  // random words with the epoch and time headers mixed in, odd size to
+  // exercise the scalar tail after the vectorized blocks
+  TRandom3 random(7);
+  std::vector<UInt_t> words(4099);
+  for (size_t i = 0; i < words.size(); i++) {
+    UInt_t header = (random.Integer(4) == 0) ? 3 : 4;
+    if (random.Integer(16) == 0) header = random.Integer(8);
+    words[i] = (header << 29) | (random.Integer(0x10000) << 13) | random.Integer(0x2000);
+  }
+
+  const int repetitions = 1000;
+  for (int invert = 0; invert < 2; invert++) {
+    std::vector<TDCRecord> reference;
+    Int_t referenceEpoch = -100000;
+    TDCDecoder::Decode(TDCDecoder::kScalar, words.data(), words.size(), invert, referenceEpoch, reference);
+    BOOST_REQUIRE(!reference.empty());
+
+    for (int mode = TDCDecoder::kScalar; mode <= TDCDecoder::kAVX2; mode++) {
+      if (!TDCDecoder::IsSupported((TDCDecoder::Mode) mode)) continue;
+      std::vector<TDCRecord> records;
+      Int_t epoch = -100000;
+      TDCDecoder::Decode((TDCDecoder::Mode) mode, words.data(), words.size(), invert, epoch, records);
+      BOOST_REQUIRE_EQUAL(epoch, referenceEpoch);
+      BOOST_REQUIRE_EQUAL(records.size(), reference.size());
+      for (size_t i = 0; i < records.size(); i++) {
+        BOOST_REQUIRE_EQUAL(records[i].channel, reference[i].channel);
+        BOOST_REQUIRE_EQUAL(records[i].edge, reference[i].edge);
+        BOOST_REQUIRE_EQUAL(records[i].fine, reference[i].fine);
+        BOOST_REQUIRE_EQUAL(records[i].coarse, reference[i].coarse);
+        BOOST_REQUIRE_EQUAL(records[i].epoch, reference[i].epoch);
+      }
+
+      TStopwatch timer;
+      timer.Start();
+      for (int i = 0; i < repetitions; i++) {
+        records.clear();
+        TDCDecoder::Decode((TDCDecoder::Mode) mode, words.data(), words.size(), invert, epoch, records);
+      }
+      timer.Stop();
+      BOOST_TEST_MESSAGE("decoder mode " << mode << (invert ? " (swapped)" : "") << ": " << repetitions * words.size() << " words in " << timer.RealTime() << " s");
+    }
+  }
+}
+
+/// Keeps the contents of every unpacked event, in the order they are passed
+struct RecordingSink: public EventSink {
+  std::vector<std::vector<int> > events;
+
+  void Process(Event* evt) {
+    std::vector<int> contents;
+    contents.push_back(evt->GetTotalNTDCHits());
+    contents.push_back(evt->GetErrorBits());
+    for (int i = 0; i < evt->GetTotalNTDCHits(); i++) {
+      TDCHit* hit = (TDCHit*) evt->GetTDCHitsArray()->At(i);
+      contents.push_back(hit->GetChannel());
+      contents.push_back(hit->GetLeadsNum());
+      for (int j = 0; j < hit->GetLeadsNum(); j++) {
+        contents.push_back(hit->GetLeadFine(j));
+        contents.push_back(hit->GetLeadCoarse(j));
+        contents.push_back(hit->GetLeadEpoch(j));
+      }
+      contents.push_back(hit->GetTrailsNum());
+      for (int j = 0; j < hit->GetTrailsNum(); j++) {
+        contents.push_back(hit->GetTrailFine(j));
+        contents.push_back(hit->GetTrailCoarse(j));
+        contents.push_back(hit->GetTrailEpoch(j));
+      }
+    }
+    events.push_back(contents);
+  }
+};
+
+BOOST_FIXTURE_TEST_CASE( parallelUnpackingMatchesSerial, Fixture )
+{
+  const char* hldFile = "unitTestData/JPetUnpackerTest/xx14099113231.hld";
+  const char* cfgFile = "unitTestData/JPetUnpackerTest/conf_trb3.xml";
+  const int kAllEvents = 1000000;
+
+  RecordingSink serial;
+  Unpacker2 serialUnpacker(hldFile, cfgFile, kAllEvents, 1, &serial, false);
+  BOOST_REQUIRE(serial.events.size() > 0);
+
+  for (int threads = 2; threads <= 4; threads++) {
+    RecordingSink parallel;
+    Unpacker2 parallelUnpacker(hldFile, cfgFile, kAllEvents, threads, &parallel, false);
+    BOOST_REQUIRE_EQUAL(parallel.events.size(), serial.events.size());
+    for (size_t i = 0; i < serial.events.size(); i++) {
+      BOOST_REQUIRE_MESSAGE(parallel.events[i] == serial.events[i],
+                            "event " << i << " differs with " << threads << " threads");
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
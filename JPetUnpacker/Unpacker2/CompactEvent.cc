@@ -0,0 +1,49 @@
+#include "CompactEvent.h"
+#include "EventIII.h"
+#include "LeadTrailPairing.h"
+#include "TDCHitExtended.h"
+
+using namespace std;
+
+ClassImp(CompactEvent);
+
+CompactEvent::CompactEvent() {
+}
+
+void CompactEvent::AddChannel(Int_t channel) {
+  channels.push_back(channel);
+  offsets.push_back(times.size());
+}
+
+void CompactEvent::AddEdge(Double_t time, bool isRising) {
+  times.push_back(time);
+  rising.push_back(isRising ? 1 : 0);
+}
+
+void CompactEvent::AddTimeLine(TDCHitExtended* hit) {
+  AddChannel(hit->GetChannel());
+  for (int j = 0; j < hit->GetTimeLineSize(); j++) {
+    AddEdge(hit->GetAbsoluteTimeLine(j), hit->GetRisingEdge(j));
+  }
+}
+
+Int_t CompactEvent::GetEdgesNum(Int_t i) const {
+  UInt_t end = (i + 1 < (Int_t) offsets.size()) ? offsets[i + 1] : times.size();
+  return end - offsets[i];
+}
+
+void CompactEvent::FillEventIII(EventIII* evt) const {
+  for (Int_t i = 0; i < GetChannelsNum(); i++) {
+    LeadTrailPairing pairing(evt->AddTDCChannel(channels[i]));
+    for (Int_t j = 0; j < GetEdgesNum(i); j++) {
+      pairing.AddEdge(GetTime(i, j), IsRisingEdge(i, j));
+    }
+  }
+}
+
+void CompactEvent::Clear(Option_t* /* option */) {
+  channels.clear();
+  offsets.clear();
+  times.clear();
+  rising.clear();
+}
@@ -0,0 +1,52 @@
+#ifndef CompactEvent_h
+#define CompactEvent_h
+
+#include <TObject.h>
+#include <vector>
+
+class EventIII;
+class TDCHitExtended;
+
+// Time lines of all the TDC channels of one event stored in flat arrays.
+// The edges of channel i are at positions offsets[i] ... offsets[i + 1] - 1
+// (or the end of the arrays for the last channel) of times and rising.
+// It replaces the fixed size arrays of TDCHitExtended and TDCChannel in the
+// files written by the unpacker: only the recorded edges are stored.
+class CompactEvent : public TObject {
+
+private:
+  std::vector<Int_t> channels;
+  std::vector<UInt_t> offsets;
+  std::vector<Double_t> times;
+  std::vector<UChar_t> rising;
+
+public:
+
+  CompactEvent();
+  virtual ~CompactEvent() {}
+
+  // starts the time line of a new channel, the following edges belong to it
+  void AddChannel(Int_t channel);
+  void AddEdge(Double_t time, bool isRising);
+  // adds a channel with the whole time line of the hit
+  void AddTimeLine(TDCHitExtended* hit);
+
+  Int_t GetChannelsNum() const { return channels.size(); }
+  Int_t GetChannel(Int_t i) const { return channels[i]; }
+  Int_t GetEdgesNum(Int_t i) const;
+  Int_t GetTotalEdgesNum() const { return times.size(); }
+  Double_t GetTime(Int_t i, Int_t j) const { return times[offsets[i] + j]; }
+  bool IsRisingEdge(Int_t i, Int_t j) const { return rising[offsets[i] + j] != 0; }
+
+  // builds the lead-trail pairs of every channel with LeadTrailPairing,
+  // as JPetPostUnpackerFilter::calculate_hits does from the time lines
+  void FillEventIII(EventIII* evt) const;
+
+  // keeps the allocated memory for the next event
+  void Clear(Option_t* option = "");
+
+  ClassDef(CompactEvent,1);
+
+};
+
+#endif
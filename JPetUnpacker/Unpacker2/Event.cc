@@ -21,18 +21,19 @@ Event::Event() {
   errorBits = 0;
 }
 
+// The hits are recycled between the events: ConstructedAt() constructs
+// a new hit only the first time a slot is used, afterwards it returns the
+// hit already reset by Clear().
 TDCHit* Event::AddTDCHit(int channel) {
   //cerr<<"Event: adding TDC hit on channel "<<channel<<endl;
-  TClonesArray& thits = *TDCHits;
-  TDCHit* hit = new (thits[totalNTDCHits++]) TDCHit();
+  TDCHit* hit = (TDCHit*) TDCHits->ConstructedAt(totalNTDCHits++);
   hit->SetChannel(channel);
   return hit;
 }
 
 TDCHitExtended* Event::AddTDCHitExtended(int channel) {
   //cerr<<"Event: adding TDC hit on channel "<<channel<<endl;
-  TClonesArray& thits = *TDCHits;
-  TDCHitExtended* hit = new (thits[totalNTDCHits++]) TDCHitExtended();
+  TDCHitExtended* hit = (TDCHitExtended*) TDCHits->ConstructedAt(totalNTDCHits++);
   hit->SetChannel(channel);
   return hit;
 }
@@ -46,7 +47,7 @@ TDCHitExtended* Event::AddTDCHitExtended(int channel) {
 }*/
 
 void Event::Clear(void) {  
-  TDCHits->Delete();
+  TDCHits->Clear("C");
 //  ADCHits->Delete();
   
   totalNTDCHits = 0;
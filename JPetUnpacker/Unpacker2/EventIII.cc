@@ -14,14 +14,14 @@ EventIII::EventIII() {
 }
 
 TDCChannel* EventIII::AddTDCChannel(int channel) {
-  TClonesArray& thits = *TDCChannels;
-  TDCChannel* ch = new (thits[totalNTDCChannels++]) TDCChannel();
+  // recycled between the events, see Event::AddTDCHit()
+  TDCChannel* ch = (TDCChannel*) TDCChannels->ConstructedAt(totalNTDCChannels++);
   ch->SetChannel(channel);
   return ch;
 }
 
 
 void EventIII::Clear(void) {  
-  TDCChannels->Delete();
+  TDCChannels->Clear("C");
 	totalNTDCChannels = 0;
 }
@@ -0,0 +1,19 @@
+#ifndef EventSink_h
+#define EventSink_h
+
+class Event;
+
+// Receives the unpacked events in the order of the hld file, so that they
+// can be processed further in memory instead of being read back from the
+// raw root file.
+class EventSink {
+
+public:
+  
+  virtual ~EventSink() {}
+  
+  virtual void Process(Event* evt) = 0;
+
+};
+
+#endif
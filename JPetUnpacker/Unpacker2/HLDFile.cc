@@ -0,0 +1,133 @@
+#include "HLDFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <iostream>
+#include "UnpackingModule.h"
+
+using namespace std;
+
+HLDFile::HLDFile() {
+  fd = -1;
+  fileSize = 0;
+
+  mapped = 0;
+
+  buffer = 0;
+  bufferCapacity = 0;
+  bufferStart = 0;
+  bufferLength = 0;
+}
+
+HLDFile::~HLDFile() {
+  Close();
+}
+
+bool HLDFile::Open(string f) {
+  Close();
+
+  fd = open(f.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if(VERBOSE) cerr<<"HLDFile: ERROR: failed to open "<<f<<endl;
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    if(VERBOSE) cerr<<"HLDFile: ERROR: failed to stat "<<f<<endl;
+    Close();
+    return false;
+  }
+  fileSize = (size_t) st.st_size;
+
+  if (fileSize > 0) {
+    void* m = mmap(0, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (m != MAP_FAILED) {
+      mapped = (char*) m;
+      madvise(mapped, fileSize, MADV_SEQUENTIAL);
+    }
+    else {
+      if(VERBOSE) cerr<<"HLDFile: WARNING: mmap failed, falling back to chunked reads"<<endl;
+    }
+  }
+
+  return true;
+}
+
+void HLDFile::Close() {
+  if (mapped != 0) {
+    munmap(mapped, fileSize);
+    mapped = 0;
+  }
+  if (buffer != 0) {
+    free(buffer);
+    buffer = 0;
+  }
+  bufferCapacity = 0;
+  bufferStart = 0;
+  bufferLength = 0;
+
+  if (fd >= 0) {
+    close(fd);
+    fd = -1;
+  }
+  fileSize = 0;
+}
+
+const char* HLDFile::Get(size_t offset, size_t length) {
+  if (fd < 0 || offset + length > fileSize) {
+    return 0;
+  }
+
+  if (mapped != 0) {
+    return mapped + offset;
+  }
+
+  if (offset < bufferStart || offset + length > bufferStart + bufferLength) {
+    if (!FillBuffer(offset, length)) {
+      return 0;
+    }
+  }
+  return buffer + (offset - bufferStart);
+}
+
+// Reads a chunk of at least kChunkSize bytes starting at offset rounded
+// down to kChunkAlignment, so that consecutive Get() calls are served
+// from memory.
+bool HLDFile::FillBuffer(size_t offset, size_t length) {
+  size_t start = offset - (offset % kChunkAlignment);
+  size_t needed = (offset - start) + length;
+  size_t toRead = (needed > kChunkSize) ? needed : kChunkSize;
+  if (start + toRead > fileSize) {
+    toRead = fileSize - start;
+  }
+
+  if (toRead > bufferCapacity) {
+    if (buffer != 0) {
+      free(buffer);
+      buffer = 0;
+    }
+    if (posix_memalign((void**) &buffer, kChunkAlignment, toRead) != 0) {
+      buffer = 0;
+      bufferCapacity = 0;
+      return false;
+    }
+    bufferCapacity = toRead;
+  }
+
+  size_t done = 0;
+  while (done < toRead) {
+    ssize_t n = pread(fd, buffer + done, toRead - done, start + done);
+    if (n <= 0) {
+      break;
+    }
+    done += n;
+  }
+
+  bufferStart = start;
+  bufferLength = done;
+
+  return done >= needed;
+}
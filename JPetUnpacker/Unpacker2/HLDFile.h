@@ -0,0 +1,52 @@
+#ifndef HLDFile_h
+#define HLDFile_h
+
+#include <cstddef>
+#include <string>
+
+// Read-only view of an HLD file.
+// The file is memory-mapped if possible, otherwise it is read in large
+// aligned chunks. Get() returns a pointer straight into the mapped (or
+// buffered) data, so no per-subevent copies or allocations are needed.
+// The returned pointer is valid until the next call to Get() or Close().
+// A memory-mapped file never moves, so its Get() may be called from
+// several threads at once and the pointers stay valid until Close().
+class HLDFile {
+
+private:
+  int fd;
+  size_t fileSize;
+
+  char* mapped;
+
+  char* buffer;
+  size_t bufferCapacity;
+  size_t bufferStart;
+  size_t bufferLength;
+
+  bool FillBuffer(size_t offset, size_t length);
+
+  HLDFile(const HLDFile&);
+  HLDFile& operator=(const HLDFile&);
+
+public:
+
+  static const size_t kChunkSize = 64 * 1024 * 1024;
+  static const size_t kChunkAlignment = 4096;
+
+  HLDFile();
+  ~HLDFile();
+
+  bool Open(std::string f);
+  void Close();
+
+  bool IsOpen() const { return fd >= 0; }
+  bool IsMapped() const { return mapped != 0; }
+
+  size_t GetSize() const { return fileSize; }
+
+  const char* Get(size_t offset, size_t length);
+
+};
+
+#endif
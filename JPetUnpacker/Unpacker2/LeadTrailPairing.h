@@ -0,0 +1,36 @@
+#ifndef LeadTrailPairing_h
+#define LeadTrailPairing_h
+
+#include "TDCChannel.h"
+
+// Builds the hits of one channel from its time line: every leading edge
+// starts a hit which is closed by the next trailing edge. The edges
+// between a lead and its trail are skipped.
+class LeadTrailPairing {
+
+public:
+
+  explicit LeadTrailPairing(TDCChannel* channel) :
+    channel(channel), actualLead(-100000), firstLeadFound(false) {}
+
+  // the edges have to be given in the order of the time line
+  void AddEdge(double time, bool isRising) {
+    if (isRising == true && firstLeadFound == false) {
+      actualLead = time;
+      firstLeadFound = true;
+    }
+    else if (isRising == false && firstLeadFound == true) {
+      channel->AddHit(actualLead, time);
+      firstLeadFound = false;
+    }
+  }
+
+private:
+
+  TDCChannel* channel;
+  double actualLead;
+  bool firstLeadFound;
+
+};
+
+#endif
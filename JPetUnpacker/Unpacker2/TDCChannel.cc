@@ -23,6 +23,26 @@ TDCChannel::TDCChannel() {
 
 TDCChannel::~TDCChannel() {}
 
+// Brings a recycled channel back to the state after construction,
+// only the used part of the arrays needs to be reset.
+void TDCChannel::Clear(Option_t* /* option */) {
+	channel = -1;
+
+	leadTime1 = -100000;
+	trailTime1 = -100000;
+	tot1 = -100000;
+	referenceDiff1 = -100000;
+
+	for (int i = 0; i < hitsNum && i < MAX_FULL_HITS; i++) {
+		leadTimes[i] = -100000;
+		trailTimes[i] = -100000;
+		tots[i] = -100000;
+		referenceDiffs[i] = -100000;
+	}
+
+	hitsNum = 0;
+}
+
 void TDCChannel::AddHit(double lead, double trail, double ref) {
 	if (hitsNum < MAX_FULL_HITS - 1) {
 		if (hitsNum == 0) {
@@ -45,6 +45,8 @@ public:
 	int GetMult() { return hitsNum; }
 	double GetTOT(int mult) { return tots[mult]; }
 
+	void Clear(Option_t* option = "");
+
 
 
   ClassDef(TDCChannel,1);
@@ -0,0 +1,139 @@
+#include "TDCDecoder.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TDCDECODER_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const UInt_t kTimeHeader = 4;
+const UInt_t kEpochHeader = 3;
+
+// Each Classify function byte-swaps (if needed) up to 8 words into out and
+// returns a mask with bit i set for a time word and bit i + 8 set for an
+// epoch word at position i.
+
+unsigned int ClassifyScalar(const UInt_t* in, size_t n, bool invertBytes, UInt_t* out) {
+  unsigned int mask = 0;
+  for (size_t i = 0; i < n; i++) {
+    UInt_t w = in[i];
+    if (invertBytes == true) {
+      w = ((w & 0x000000ff) << 24) | ((w & 0x0000ff00) << 8) | ((w & 0x00ff0000) >> 8) | ((w & 0xff000000) >> 24);
+    }
+    out[i] = w;
+
+    UInt_t header = w >> 29;
+    if (header == kTimeHeader)
+      mask |= 1 << i;
+    else if (header == kEpochHeader)
+      mask |= 1 << (i + 8);
+  }
+  return mask;
+}
+
+#ifdef TDCDECODER_X86
+
+__attribute__((target("sse4.1")))
+unsigned int ClassifySSE4(const UInt_t* in, bool invertBytes, UInt_t* out) {
+  const __m128i swap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+  const __m128i timeHeader = _mm_set1_epi32(kTimeHeader);
+  const __m128i epochHeader = _mm_set1_epi32(kEpochHeader);
+
+  unsigned int mask = 0;
+  for (int half = 0; half < 2; half++) {
+    __m128i w = _mm_loadu_si128((const __m128i*) (in + 4 * half));
+    if (invertBytes == true)
+      w = _mm_shuffle_epi8(w, swap);
+    _mm_storeu_si128((__m128i*) (out + 4 * half), w);
+
+    __m128i header = _mm_srli_epi32(w, 29);
+    unsigned int time = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(header, timeHeader)));
+    unsigned int epoch = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(header, epochHeader)));
+    mask |= (time << (4 * half)) | (epoch << (8 + 4 * half));
+  }
+  return mask;
+}
+
+__attribute__((target("avx2")))
+unsigned int ClassifyAVX2(const UInt_t* in, bool invertBytes, UInt_t* out) {
+  const __m256i swap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+					3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+  const __m256i timeHeader = _mm256_set1_epi32(kTimeHeader);
+  const __m256i epochHeader = _mm256_set1_epi32(kEpochHeader);
+
+  __m256i w = _mm256_loadu_si256((const __m256i*) in);
+  if (invertBytes == true)
+    w = _mm256_shuffle_epi8(w, swap);
+  _mm256_storeu_si256((__m256i*) out, w);
+
+  __m256i header = _mm256_srli_epi32(w, 29);
+  unsigned int time = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(header, timeHeader)));
+  unsigned int epoch = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(header, epochHeader)));
+  return time | (epoch << 8);
+}
+
+#endif
+
+TDCDecoder::Mode DetectBestMode() {
+#ifdef TDCDECODER_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return TDCDecoder::kAVX2;
+  if (__builtin_cpu_supports("sse4.1"))
+    return TDCDecoder::kSSE4;
+#endif
+  return TDCDecoder::kScalar;
+}
+
+}
+
+TDCDecoder::Mode TDCDecoder::GetBestMode() {
+  static const Mode best = DetectBestMode();
+  return best;
+}
+
+bool TDCDecoder::IsSupported(Mode mode) {
+  return mode <= GetBestMode();
+}
+
+void TDCDecoder::Decode(Mode mode, const UInt_t* data, size_t size, bool invertBytes, Int_t& epoch, vector<TDCRecord>& records) {
+  if (IsSupported(mode) == false)
+    mode = GetBestMode();
+
+  UInt_t words[8];
+  size_t i = 0;
+  while (i < size) {
+    size_t n = (size - i < 8) ? (size - i) : 8;
+
+    unsigned int mask = 0;
+#ifdef TDCDECODER_X86
+    if (n == 8 && mode == kAVX2)
+      mask = ClassifyAVX2(data + i, invertBytes, words);
+    else if (n == 8 && mode == kSSE4)
+      mask = ClassifySSE4(data + i, invertBytes, words);
+    else
+#endif
+      mask = ClassifyScalar(data + i, n, invertBytes, words);
+
+    for (size_t j = 0; mask != 0 && j < n; j++) {
+      UInt_t w = words[j];
+      if (mask & (1 << (j + 8))) {
+	epoch = w & 0xfffffff;
+      }
+      else if (mask & (1 << j)) {
+	TDCRecord record;
+	record.channel = (w >> 22) & 0x7f;
+	record.edge = (w >> 11) & 0x1;
+	record.fine = (w >> 12) & 0x3ff;
+	record.coarse = w & 0x7ff;
+	record.epoch = epoch;
+	records.push_back(record);
+      }
+    }
+
+    i += n;
+  }
+}
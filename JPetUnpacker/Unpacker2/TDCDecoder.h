@@ -0,0 +1,38 @@
+#ifndef TDCDecoder_h
+#define TDCDecoder_h
+
+#include <Rtypes.h>
+#include <vector>
+
+// One time measurement decoded from a TRB3 TDC data word,
+// together with the epoch counter valid at that point of the block.
+struct TDCRecord {
+  UShort_t channel;
+  UShort_t edge;
+  UShort_t fine;
+  UShort_t coarse;
+  Int_t epoch;
+};
+
+// Batch decoder of the TDC data words.
+// The block is byte-swapped (if needed) and classified 8 words at a time
+// with SSE4 or AVX2 instructions when the cpu supports them, the scalar
+// implementation is the reference the vectorized ones have to match.
+class TDCDecoder {
+
+public:
+
+  enum Mode { kScalar = 0, kSSE4 = 1, kAVX2 = 2 };
+
+  // the fastest mode supported by the cpu, detected once
+  static Mode GetBestMode();
+  static bool IsSupported(Mode mode);
+
+  // Decodes size words starting at data and appends the time words to
+  // records. The epoch counter is updated by the epoch words and carried
+  // over between the calls.
+  static void Decode(Mode mode, const UInt_t* data, size_t size, bool invertBytes, Int_t& epoch, std::vector<TDCRecord>& records);
+
+};
+
+#endif
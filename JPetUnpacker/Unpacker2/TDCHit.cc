@@ -25,6 +25,26 @@ TDCHit::TDCHit() {
 TDCHit::~TDCHit() {
 }
 
+// Brings a recycled hit back to the state after construction,
+// only the used part of the arrays needs to be reset.
+void TDCHit::Clear(Option_t* /* option */) {
+  channel = -1;
+
+  for (int i = 0; i < leadsNum && i < MAX_HITS; i++) {
+    leadFineTimes[i] = -100000;
+    leadCoarseTimes[i] = -100000;
+    leadEpochs[i] = -100000;
+  }
+  for (int i = 0; i < trailsNum && i < MAX_HITS; i++) {
+    trailFineTimes[i] = -100000;
+    trailCoarseTimes[i] = -100000;
+    trailEpochs[i] = -100000;
+  }
+
+  leadsNum = 0;
+  trailsNum = 0;
+}
+
 void TDCHit::AddLeadTime(int fine, int coarse, int epoch) {
 	leadFineTimes[leadsNum] = fine;
 	leadCoarseTimes[leadsNum] = coarse;
@@ -30,6 +30,8 @@ public:
 	void AddLeadTime(int fine, int coarse, int epoch);
 	void AddTrailTime(int fine, int coarse, int epoch);
 
+	void Clear(Option_t* option = "");
+
 	int GetChannel() { return channel; }
 
 	int GetLeadsNum() { return leadsNum; }
@@ -5,23 +5,11 @@ using namespace std;
 
 ClassImp(TDCHitExtended);
 
+// the lead and trail arrays of MAX_HITS entries are set by TDCHit()
 TDCHitExtended::TDCHitExtended() {
-  channel = -1;
-
-  leadsNum = 0;
-  trailsNum = 0;
-
   timeLineSize = 0;
     
   for (int i = 0; i < MAX_HITS * 2; i++) {
-    leadFineTimes[i] = -100000;
-    leadCoarseTimes[i] = -100000;
-    leadEpochs[i] = -100000;
-
-    trailFineTimes[i] = -100000;
-    trailCoarseTimes[i] = -100000;
-    trailEpochs[i] = -100000;
-
     fineTimeLine[i] = -100000;
     coarseTimeLine[i] = -100000;
     epochTimeLine[i] = -100000;
@@ -34,6 +22,21 @@ TDCHitExtended::TDCHitExtended() {
 TDCHitExtended::~TDCHitExtended() {
 }
 
+void TDCHitExtended::Clear(Option_t* option) {
+  TDCHit::Clear(option);
+
+  for (int i = 0; i < timeLineSize && i < MAX_HITS * 2; i++) {
+    fineTimeLine[i] = -100000;
+    coarseTimeLine[i] = -100000;
+    epochTimeLine[i] = -100000;
+    shortTimeLine[i] = -100000;
+    absoluteTimeLine[i] = -100000;
+    riseTimeLine[i] = -100000;
+  }
+
+  timeLineSize = 0;
+}
+
 void TDCHitExtended::ShiftEverythingUpByOne(int start) {
 	for (int i = timeLineSize; i >= start; i--) {
 		fineTimeLine[i+1] = fineTimeLine[i];
@@ -41,6 +41,8 @@ public:
 
 	void PrintOut();
 
+	void Clear(Option_t* option = "");
+
   ClassDef(TDCHitExtended,1);
 };
 
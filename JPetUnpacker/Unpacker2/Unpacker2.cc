@@ -17,15 +17,22 @@
 //#include "Unpacker_Ecal_ADC.h"
 #include "Unpacker_TRB3.h"
 #include "Unpacker_Lattice_TDC.h"
+#include "HLDFile.h"
+#include <TStopwatch.h>
+#include <TThread.h>
 
 
 using namespace std;
 
 //ClassImp(Unpacker2);
 
-Unpacker2::Unpacker2(const char* hldFile, const char* configFile, int numberOfEvents) {
+Unpacker2::Unpacker2(const char* hldFile, const char* configFile, int numberOfEvents, int numberOfThreads, EventSink* eventSink, bool rawFile) {
   
   eventsToAnalyze = numberOfEvents;
+  sink = eventSink;
+  writeRawFile = (sink == 0) ? true : rawFile;
+  threads = (numberOfThreads > 0) ? numberOfThreads : 1;
+  configFileName = string(configFile);
   debugMode = false;
   
   invertBytes = false;
@@ -65,6 +72,55 @@ void Unpacker2::ParseConfigFile(string f, string s) {
   }
   file->close();
 
+  CreateUnpackers(s, unpackers, debugMode);
+  BuildDispatchTable();
+}
+
+// Registers the hub addresses and the addresses of the internal unpackers
+// in the address table and indexes the modules by its slots. The table is
+// built once, after all the unpackers are created, and the parallel
+// workers only read it.
+void Unpacker2::BuildDispatchTable() {
+  addressTable = AddressTable();
+  
+  map<string, UnpackingModule*>::iterator iter;
+  for(iter = unpackers.begin(); iter != unpackers.end(); iter++) {
+    UInt_t address = 0;
+    if (UnpackingModule::StringToAddress(iter->first, address)) {
+      addressTable.Register(address);
+    }
+    else {
+      if(VERBOSE) cerr<<"ERROR: Hub address "<<iter->first<<" is not a 16-bit hex number"<<endl;
+    }
+    iter->second->RegisterAddresses(addressTable);
+  }
+  
+  FillSlots(unpackers, hubSlots);
+}
+
+// Indexes the modules created from the config file by the slots of their
+// hub addresses, so that the subevents are routed without formatting their
+// hub address into a string.
+void Unpacker2::FillSlots(map<string, UnpackingModule*>& modules, vector<UnpackingModule*>& slots) const {
+  slots.assign(addressTable.GetNumberOfSlots(), NULL);
+  
+  map<string, UnpackingModule*>::iterator iter;
+  for(iter = modules.begin(); iter != modules.end(); iter++) {
+    UInt_t address = 0;
+    if (UnpackingModule::StringToAddress(iter->first, address)) {
+      UShort_t slot = addressTable.GetSlot(address);
+      if (slot < slots.size())
+	slots[slot] = iter->second;
+    }
+    iter->second->SetAddressTable(&addressTable);
+  }
+}
+
+// Creates the unpacking modules described in the xml config file and
+// stores them in target under their hub addresses, the DEBUG option of the
+// file is returned in debug. It is called once for the main unpacker set
+// and once for every parallel unpacking worker.
+void Unpacker2::CreateUnpackers(string s, map<string, UnpackingModule*>& target, bool& debug) const {
   
   // parsing xml config file
   tinyxml2::XMLDocument doc;
@@ -79,14 +135,14 @@ void Unpacker2::ParseConfigFile(string f, string s) {
   // get the config options from the config file
   if(doc.FirstChildElement("READOUT")->FirstChildElement("DEBUG") != 0) {
     if (string(doc.FirstChildElement("READOUT")->FirstChildElement("DEBUG")->GetText()) == "ON")
-      debugMode = true;
+      debug = true;
   }
   else {
     if(VERBOSE) cerr<<"ERROR: Incorrect config file structure"<<endl;
     exit(0);
   }     
   
-  if (debugMode == true)
+  if (debug == true)
     if(VERBOSE) cerr<<"DEBUG mode on"<<endl;
   
   // get the first data source entry in the config file
@@ -237,7 +293,7 @@ void Unpacker2::ParseConfigFile(string f, string s) {
     //else if (type == "TRB3_S") {
     if (type == "TRB3_S") {
 
-      m = new Unpacker_TRB3(type, address, hubAddress, 0, 0, 0, "", invertBytes, debugMode);
+      m = new Unpacker_TRB3(type, address, hubAddress, 0, 0, 0, "", invertBytes, debug);
       m->SetReferenceChannel(referenceChannel);
 
       // create additional unpackers for internal modules 
@@ -255,22 +311,22 @@ void Unpacker2::ParseConfigFile(string f, string s) {
 	measurementType = string(node->ToElement()->FirstChildElement("MEASUREMENT_TYPE")->GetText());
 
 	if (type == "LATTICE_TDC") {
-	  m->AddUnpacker(address, new Unpacker_Lattice_TDC(type, address, hubAddress, channels, offset, resolution, measurementType, invertBytes, debugMode, correctionFile));
+	  m->AddUnpacker(address, new Unpacker_Lattice_TDC(type, address, hubAddress, channels, offset, resolution, measurementType, invertBytes, debug, correctionFile));
 	}
 	else {
-	  m->AddUnpacker(address, new UnpackingModule(type, address, hubAddress, channels, offset, resolution, measurementType, invertBytes, debugMode));
+	  m->AddUnpacker(address, new UnpackingModule(type, address, hubAddress, channels, offset, resolution, measurementType, invertBytes, debug));
 	}
 	
 	node = node->ToElement()->NextSibling();
       }      
     }
     else  { // default type
-	m = new UnpackingModule(type, address, hubAddress, 0, 0, 0, "", invertBytes, debugMode);
+	m = new UnpackingModule(type, address, hubAddress, 0, 0, 0, "", invertBytes, debug);
 	if(VERBOSE) cerr<<"  -- Creating UnpakingModule for unassigned type"<<endl;
     }
     
     // add the module to the list
-    AddUnpacker(hubAddress, m);
+    target[hubAddress] = m;
     
     // take and check if next one entry exists
     node = element->NextSibling();
@@ -282,165 +338,394 @@ void Unpacker2::ParseConfigFile(string f, string s) {
   }
 }
 
+// Deletes the modules created by CreateUnpackers together with their
+// internal unpackers.
+void Unpacker2::DeleteUnpackers(map<string, UnpackingModule*>& modules) {
+  map<string, UnpackingModule*>::iterator iter;
+  for (iter = modules.begin(); iter != modules.end(); iter++) {
+    map<string, UnpackingModule*>::iterator internal;
+    for (internal = iter->second->GetInternalUnpackersIterBegin(); internal != iter->second->GetInternalUnpackersIterEnd(); internal++) {
+      delete internal->second;
+    }
+    delete iter->second;
+  }
+  modules.clear();
+}
+
+// Passes the data between the subevent headers of one event to the
+// unpacking worker thread that owns it.
+struct UnpackingWorker {
+  Unpacker2* owner;
+  HLDFile* file;
+  const vector<size_t>* eventPositions;
+  map<string, UnpackingModule*> unpackers;
+  vector<UnpackingModule*> hubSlots;
+  vector<Event*> events[2];
+  size_t first[2];
+  size_t last[2];
+  int set;
+  TThread* thread;
+};
+
+static void* UnpackingWorkerProxy(void* arg) {
+  UnpackingWorker* worker = (UnpackingWorker*) arg;
+  worker->owner->UnpackRange(worker);
+  return 0;
+}
+
 void Unpacker2::DistributeEvents(string f) {
-  ifstream* file = new ifstream(f.c_str());
+  HLDFile file;
   
-  if (file->is_open()) {
+  if (file.Open(f)) {
 
-    // skip the file header
-    file->ignore(32);
+    if(VERBOSE) cerr<<"Unpacker2.cc: Reading "<<f<<(file.IsMapped() ? " through mmap" : " in chunks")<<endl;
+
+    fileSize = file.GetSize();
     
     int analyzedEvents = 0;
     
     Event* event = 0;
     
-    // open a new file
-    string newFileName = f + ".raw.root";;
-    TFile* newFile = new TFile(newFileName.c_str(), "RECREATE");
-    TTree* newTree = new TTree("T", "Tree");
-    Int_t split = 2;
-    Int_t bsize = 64000;
-    newTree->Branch("event", "Event", &event, bsize, split);
+    // open a new file, unless the events are only passed to the sink
+    TFile* newFile = 0;
+    TTree* newTree = 0;
+    if (writeRawFile == true) {
+      string newFileName = f + ".raw.root";;
+      newFile = new TFile(newFileName.c_str(), "RECREATE");
+      newTree = new TTree("T", "Tree");
+      Int_t split = 2;
+      Int_t bsize = 64000;
+      newTree->Branch("event", "Event", &event, bsize, split);
+    }
     
     if(VERBOSE) cerr<<"Starting event loop"<<endl;
     
-    event = new Event();
+    TStopwatch timer;
+    timer.Start();
 
-    size_t eventSize = 0;
-    
-    // iterate through all the events in the file
-    while(true) {
+    // skip the file header
+    const size_t start = 32;
+    size_t position = start;
+
+    if (threads > 1 && file.IsMapped()) {
+      position = DistributeEventsInParallel(file, position, newTree, event, analyzedEvents);
+    }
+    else {
+      if (threads > 1) {
+	cerr<<"Unpacker2: WARNING: parallel unpacking needs a memory-mapped file, using one thread"<<endl;
+      }
+
+      event = new Event();
+
+      // iterate through all the events in the file
+      while(true) {
+	bool isEmpty = false;
+	size_t next = ReadEvent(file, position, event, &hubSlots, isEmpty);
+	if (next == 0) { break; }
+	position = next;
+
+	if (isEmpty)
+	  continue;
+
+	Output(newTree, event);
       
-      if(debugMode == true)
-	if(VERBOSE) cerr<<"Unpacker2.cc: Position in file at "<<file->tellg()<<endl;
-    
-      // read out the header of the event into hdr structure
-      pHdr = (UInt_t*) &hdr;
-      file->read((char *) (pHdr), getHdrSize());
+	if(analyzedEvents % 10000 == 0) {
+	  cerr<<analyzedEvents<<endl;
+	}
       
-      eventSize = (size_t) getFullSize();
-            
-      if(debugMode == true)
-	if(VERBOSE) cerr<<"Unpacker2.cc: Starting new event analysis, going over subevents"<<endl;
-
-      if (eventSize == 32)
-	continue;
+	analyzedEvents++;
       
+	event->Clear();
       
-      while(true) {
-	subPHdr = (UInt_t*) &subHdr;
-	file->read((char *) (subPHdr), getSubHdrSize());
-	
-	// read out the entire data of the event
-	UInt_t* pData = new UInt_t[getDataSize()];
-	file->read((char*) (pData), getDataSize());
-	
-	if(debugMode == true) {
-	  if(VERBOSE){
-	    cerr<<"Unpacker2.cc: Subevent data size: "<<getDataSize()<<" starting with ";
-	    printf("%08X\n", (*pData));
-	    cerr<<"Unpacker2.cc: Subevent details: "<<((SubEventHdr*)subPHdr)->decoding<<" "<<((SubEventHdr*)subPHdr)->hubAddress<<" "<<((SubEventHdr*)subPHdr)->trgNr<<endl;
-	  }
-	}
-	
-	// call the unpacking module
-	UnpackingModule* u = GetUnpacker(getHubAddress());
-	if (u != NULL && (*pData) != 0) {
-	  if(debugMode == true)
-	   if(VERBOSE)  cerr<<"Unpacker2.cc: Processing event "<<analyzedEvents<<" on "<<getHubAddress()<<endl;
-	  GetUnpacker(getHubAddress())->SetEntireEventSize(getDataSize());
-	  GetUnpacker(getHubAddress())->ProcessEvent(pData, event);
-	  
-	  // gather decoded hits and fill them into event
-	
-	  GetUnpacker(getHubAddress())->GetTDCHits();
-//	  GetUnpacker(getHubAddress())->GetADCHits();
-	
-	}
-	else if((*pData) == 0) {
-	 if(VERBOSE) cerr<<"WARNING: First data word empty, skipping event nr "<<analyzedEvents<<endl;
+	// check the end of loop conditions (end of file)
+	if((position + 500) > fileSize) { break; }
+	if(position >= fileSize) { break; }
+	if(analyzedEvents == eventsToAnalyze) { break; }
+      }
+    }
+
+    timer.Stop();
+    PrintThroughput(analyzedEvents, position - start, timer.RealTime());
+
+    if (newFile != 0) {
+      newFile->Write();
+    
+      delete newTree;
+    }
+  }
+  else { if(VERBOSE) cerr<<"ERROR:failed to open data file"<<endl; }
+  
+  file.Close();
+
+  //*** END OF READING BINARY DATA
+}
+
+// Indexes the event boundaries from the event and subevent headers, then
+// hands out batches of consecutive events to the worker threads. Each
+// worker owns its own set of unpacking modules, indexed through the
+// address table shared by all of them. The decoded events are
+// filled into the tree in the original order, while the workers already
+// decode the next round into their second event buffer.
+// Returns the position in the file after the last indexed event.
+size_t Unpacker2::DistributeEventsInParallel(HLDFile& file, size_t position, TTree* tree, Event*& event, int& analyzedEvents) {
+  vector<size_t> eventPositions;
+  while(true) {
+    bool isEmpty = false;
+    size_t next = ReadEvent(file, position, 0, 0, isEmpty);
+    if (next == 0) { break; }
+    if (!isEmpty) {
+      eventPositions.push_back(position);
+    }
+    position = next;
+
+    if (isEmpty)
+      continue;
+
+    if((position + 500) > fileSize) { break; }
+    if(position >= fileSize) { break; }
+    if((int) eventPositions.size() == eventsToAnalyze) { break; }
+  }
+
+  if(VERBOSE) cerr<<"Unpacker2.cc: Indexed "<<eventPositions.size()<<" events, unpacking with "<<threads<<" threads"<<endl;
+
+  TThread::Initialize();
+
+  vector<UnpackingWorker> workers(threads);
+  for (int w = 0; w < threads; w++) {
+    workers[w].owner = this;
+    workers[w].file = &file;
+    workers[w].eventPositions = &eventPositions;
+    bool debug = debugMode;
+    CreateUnpackers(configFileName, workers[w].unpackers, debug);
+    FillSlots(workers[w].unpackers, workers[w].hubSlots);
+    for (int set = 0; set < 2; set++) {
+      for (int i = 0; i < kEventsPerBatch; i++) {
+	workers[w].events[set].push_back(new Event());
+      }
+      workers[w].first[set] = 0;
+      workers[w].last[set] = 0;
+    }
+    workers[w].set = 0;
+    workers[w].thread = 0;
+  }
+
+  size_t eventsPerRound = (size_t) threads * kEventsPerBatch;
+  size_t rounds = (eventPositions.size() + eventsPerRound - 1) / eventsPerRound;
+
+  for (size_t round = 0; round <= rounds; round++) {
+    // wait for the round being decoded
+    for (int w = 0; w < threads; w++) {
+      if (workers[w].thread != 0) {
+	workers[w].thread->Join();
+	delete workers[w].thread;
+	workers[w].thread = 0;
+      }
+    }
+
+    // start decoding the next round
+    if (round < rounds) {
+      for (int w = 0; w < threads; w++) {
+	int set = round % 2;
+	size_t first = round * eventsPerRound + w * kEventsPerBatch;
+	size_t last = first + kEventsPerBatch;
+	if (first > eventPositions.size()) { first = eventPositions.size(); }
+	if (last > eventPositions.size()) { last = eventPositions.size(); }
+	workers[w].set = set;
+	workers[w].first[set] = first;
+	workers[w].last[set] = last;
+	if (first < last) {
+	  workers[w].thread = new TThread("Unpacker2Worker", UnpackingWorkerProxy, (void*) &workers[w]);
+	  workers[w].thread->Run();
 	}
-	else if(u == NULL) {
-	  if(VERBOSE) cerr<<"ERROR: Unpacker not found for address: "<<getHubAddress()<<endl;
-	  exit(1);
+      }
+    }
+
+    // reorder stage: fill the previous round in the original order
+    if (round > 0) {
+      int set = (round - 1) % 2;
+      for (int w = 0; w < threads; w++) {
+	for (size_t i = workers[w].first[set]; i < workers[w].last[set]; i++) {
+	  event = workers[w].events[set][i - workers[w].first[set]];
+	  Output(tree, event);
+      
+	  if(analyzedEvents % 10000 == 0) {
+	    cerr<<analyzedEvents<<endl;
+	  }
+	  analyzedEvents++;
+
+	  event->Clear();
 	}
+      }
+    }
+  }
 
-	if(debugMode == true)
-	  if(VERBOSE) cerr<<"Unpacker2.cc: Ignoring "<<(getPaddedSize() - getDataSize())<<" bytes and reducing eventSize by "<<getDataSize(); 
-	
-	delete pData;
-	
-	// remove the padding bytes
-	file->ignore(getPaddedSize() - getDataSize());
-	
-	eventSize -= getDataSize();
-	
-	if(debugMode == true)
-	  if(VERBOSE) cerr<<" leaving eventSize of "<<eventSize<<endl;
-	
-	if(eventSize <= 48 && fullSetup == false) { break; }
-	
-	eventSize -= getPaddedSize() - getDataSize();
-	
-	if((eventSize <= 64) && fullSetup == true) { break; }
+  for (int w = 0; w < threads; w++) {
+    for (int set = 0; set < 2; set++) {
+      for (size_t i = 0; i < workers[w].events[set].size(); i++) {
+	delete workers[w].events[set][i];
+      }
+    }
+    DeleteUnpackers(workers[w].unpackers);
+  }
+  event = 0;
+
+  return position;
+}
+
+// Passes the unpacked event to the raw tree and/or the event sink.
+void Unpacker2::Output(TTree* tree, Event* evt) {
+  if (tree != 0)
+    tree->Fill();
+  if (sink != 0)
+    sink->Process(evt);
+}
+
+void Unpacker2::UnpackRange(UnpackingWorker* worker) {
+  int set = worker->set;
+  for (size_t i = worker->first[set]; i < worker->last[set]; i++) {
+    bool isEmpty = false;
+    ReadEvent(*(worker->file), (*(worker->eventPositions))[i], worker->events[set][i - worker->first[set]], &(worker->hubSlots), isEmpty);
+  }
+}
 
-	if((eventSize <= 176) && fullSetup == true) { break; }
+// Walks through the subevents of the event starting at the given position.
+// If modules (indexed by the slots of their hub addresses) are given, the
+// subevent data is passed to the matching unpacking module and the decoded
+// hits are stored in evt; otherwise only the event boundaries are followed.
+// Returns the position of the next event or 0 if no header could be read.
+size_t Unpacker2::ReadEvent(HLDFile& file, size_t position, Event* evt, const vector<UnpackingModule*>* modules, bool& isEmpty) {
+  if(debugMode == true)
+    if(VERBOSE) cerr<<"Unpacker2.cc: Position in file at "<<position<<endl;
+
+  // point the header of the event straight into the file data
+  const EventHdr* eventHdr = (const EventHdr*) file.Get(position, getHdrSize());
+  if (eventHdr == 0) { return 0; }
+  position += getHdrSize();
+  
+  size_t eventSize = (size_t) eventHdr->fullSize;
+
+  if(debugMode == true)
+    if(VERBOSE) cerr<<"Unpacker2.cc: Starting new event analysis, going over subevents"<<endl;
+
+  isEmpty = (eventSize == 32);
+  if (isEmpty) { return position; }
+
+  while(true) {
+    const SubEventHdr* subEventHdr = (const SubEventHdr*) file.Get(position, getSubHdrSize());
+    if (subEventHdr == 0) { return file.GetSize(); }
+    size_t dataSize = GetDataSize(subEventHdr);
+    
+    // the entire data of the subevent, without copying
+    // (fetched together with its header so that both pointers stay valid)
+    const char* subEvent = file.Get(position, getSubHdrSize() + dataSize);
+    if (subEvent == 0) {
+      if(VERBOSE) cerr<<"ERROR: Subevent exceeds the end of file at position "<<position<<endl;
+      return file.GetSize();
+    }
+    subEventHdr = (const SubEventHdr*) subEvent;
+    UInt_t* pData = (UInt_t*) (subEvent + getSubHdrSize());
+    position += getSubHdrSize() + dataSize;
+    
+    if(debugMode == true) {
+      if(VERBOSE){
+	cerr<<"Unpacker2.cc: Subevent data size: "<<dataSize<<" starting with ";
+	printf("%08X\n", (*pData));
+	cerr<<"Unpacker2.cc: Subevent details: "<<subEventHdr->decoding<<" "<<subEventHdr->hubAddress<<" "<<subEventHdr->trgNr<<endl;
       }
-      
-      newTree->Fill();
-      
-      if(analyzedEvents % 10000 == 0) {
-				cerr<<analyzedEvents<<endl;
+    }
+    
+    if (modules != 0) {
+      // call the unpacking module
+      UShort_t slot = addressTable.GetSlot(GetHubAddressValue(subEventHdr));
+      UnpackingModule* u = (slot < modules->size()) ? (*modules)[slot] : NULL;
+      if (u != NULL && (*pData) != 0) {
+	if(debugMode == true)
+	  if(VERBOSE) cerr<<"Unpacker2.cc: Processing event on "<<GetHubAddress(subEventHdr)<<endl;
+	u->SetEntireEventSize(dataSize);
+	u->ProcessEvent(pData, evt);
+	
+	// gather decoded hits and fill them into event
+	u->GetTDCHits();
+//	u->GetADCHits();
       }
-      
-      analyzedEvents++;
-      
-      event->Clear();
-      
-      if(debugMode == true) {
-	if(VERBOSE) cerr<<"Unpacker2.cc: Ignoring padding of the event "<<(align8(eventSize) - eventSize)<<endl;
-	if(VERBOSE) cerr<<"Unpacker2.cc: File pointer at "<<file->tellg()<<" of "<<fileSize<<" bytes"<<endl;
+      else if((*pData) == 0) {
+	if(VERBOSE) cerr<<"WARNING: First data word empty, skipping event at position "<<position<<endl;
       }
-      
-      if (fullSetup == false) {
-	file->ignore(align8(eventSize) - eventSize);
+      else if(u == NULL) {
+	if(VERBOSE) cerr<<"ERROR: Unpacker not found for address: "<<GetHubAddress(subEventHdr)<<endl;
+	exit(1);
       }
-      // check the end of loop conditions (end of file)
-      if((fileSize - ((int)file->tellg())) < 500) { break; }
-      if((file->eof() == true) || ((int)file->tellg() == fileSize)) { break; }
-      if(analyzedEvents == eventsToAnalyze) { break; }
     }
 
-    newFile->Write();
+    size_t paddedSize = align8(dataSize);
+
+    if(debugMode == true)
+      if(VERBOSE) cerr<<"Unpacker2.cc: Ignoring "<<(paddedSize - dataSize)<<" bytes and reducing eventSize by "<<dataSize; 
+    
+    // remove the padding bytes
+    position += paddedSize - dataSize;
+    
+    eventSize -= dataSize;
+    
+    if(debugMode == true)
+      if(VERBOSE) cerr<<" leaving eventSize of "<<eventSize<<endl;
+    
+    if(eventSize <= 48 && fullSetup == false) { break; }
     
-    delete newTree;
+    eventSize -= paddedSize - dataSize;
+    
+    if((eventSize <= 64) && fullSetup == true) { break; }
+
+    if((eventSize <= 176) && fullSetup == true) { break; }
+  }
+
+  if(debugMode == true) {
+    if(VERBOSE) cerr<<"Unpacker2.cc: Ignoring padding of the event "<<(align8(eventSize) - eventSize)<<endl;
   }
-  else { if(VERBOSE) cerr<<"ERROR:failed to open data file"<<endl; }
   
-  file->close();
+  if (fullSetup == false) {
+    position += align8(eventSize) - eventSize;
+  }
 
-  //*** END OF READING BINARY DATA
+  return position;
+}
+
+// Reports the unpacking rate, bytesRead is the amount of data consumed
+// since the start of the unpacking, not the position in the file.
+void Unpacker2::PrintThroughput(int events, size_t bytesRead, double seconds) {
+  double megabytes = bytesRead / (1024. * 1024.);
+  cerr<<"Unpacker2: unpacked "<<events<<" events ("<<megabytes<<" MB) in "<<seconds<<" s";
+  if (seconds > 0) {
+    cerr<<", "<<(megabytes / seconds)<<" MB/s, "<<(events / seconds)<<" events/s";
+  }
+  cerr<<endl;
 }
 
 size_t Unpacker2::getDataSize() {
+  return GetDataSize((SubEventHdr*)subPHdr);
+}
+
+std::string Unpacker2::getHubAddress() {
+  return GetHubAddress((SubEventHdr*)subPHdr);
+}
+
+size_t Unpacker2::GetDataSize(const SubEventHdr* h) {
   if (invertBytes == false) {
-    return (size_t) (((SubEventHdr*)subPHdr)->size - 16);
+    return (size_t) (h->size - 16);
   }
   else {
-    return (size_t) (ReverseHex(((SubEventHdr*)subPHdr)->size) - 16);
+    return (size_t) (ReverseHex(h->size) - 16);
   }
-  
-  return -1;
 }
 
-std::string Unpacker2::getHubAddress() {
+std::string Unpacker2::GetHubAddress(const SubEventHdr* h) {
   string s = "0000";
   stringstream sstream;
   if (invertBytes == false) {
-    sstream<<hex<<((SubEventHdr*)subPHdr)->hubAddress;  
+    sstream<<hex<<h->hubAddress;  
   }
   else {
-    sstream<<hex<<ReverseHex((UInt_t)((SubEventHdr*)subPHdr)->hubAddress);  
+    sstream<<hex<<ReverseHex((UInt_t)h->hubAddress);  
   }
   
   s = s.replace(4 - sstream.str().length(), sstream.str().length(), sstream.str());
@@ -448,6 +733,15 @@ std::string Unpacker2::getHubAddress() {
   return s;
 }
 
+UInt_t Unpacker2::GetHubAddressValue(const SubEventHdr* h) {
+  if (invertBytes == false) {
+    return h->hubAddress;
+  }
+  else {
+    return (UInt_t) ReverseHex((UInt_t)h->hubAddress);
+  }
+}
+
 size_t Unpacker2::ReverseHex(size_t n) {
   size_t a, b, c, d, e;
   a = n & 0x000000ff;
@@ -7,7 +7,12 @@
 #include <TObjectTable.h>
 #include <string>
 #include "UnpackingModule.h"
+#include "EventSink.h"
 #include <map>
+#include <vector>
+
+class HLDFile;
+struct UnpackingWorker;
 
 class Unpacker2 : public TObject {
   
@@ -15,6 +20,12 @@ private:
   
   map<std::string, UnpackingModule*> unpackers;
   
+  // slots of the hub and internal addresses, shared by all the workers
+  AddressTable addressTable;
+  
+  // unpackers indexed by the slot of the hub address of the subevent
+  vector<UnpackingModule*> hubSlots;
+  
   int eventsToAnalyze;
   
   size_t reverseHex(size_t n);
@@ -24,18 +35,46 @@ private:
   
   bool debugMode;
   
-  int fileSize;
+  size_t fileSize;
+
+  int threads;
+  std::string configFileName;
+
+  EventSink* sink;
+  bool writeRawFile;
+
+  void Output(TTree* tree, Event* evt);
+
+  void PrintThroughput(int events, size_t bytesRead, double seconds);
+
+  void FillSlots(map<std::string, UnpackingModule*>& modules, vector<UnpackingModule*>& slots) const;
+
+  size_t DistributeEventsInParallel(HLDFile& file, size_t position, TTree* tree, Event*& event, int& analyzedEvents);
 
 public:
   
-  Unpacker2(const char* hldFile, const char* configFile, int numberOfEvents);
+  // number of consecutive events decoded by one worker thread at a time
+  static const int kEventsPerBatch = 128;
+
+  // If an event sink is given, every unpacked event is passed to it and
+  // the .raw.root file is written only if rawFile is set.
+  Unpacker2(const char* hldFile, const char* configFile, int numberOfEvents, int numberOfThreads = 1, EventSink* eventSink = 0, bool rawFile = true);
   ~Unpacker2() {}
   
   void ParseConfigFile(std::string f, std::string s);
+  void CreateUnpackers(std::string s, map<std::string, UnpackingModule*>& target, bool& debug) const;
+  static void DeleteUnpackers(map<std::string, UnpackingModule*>& modules);
   void DistributeEvents(std::string f);
+  void UnpackRange(UnpackingWorker* worker);
   
+  // BuildDispatchTable() has to be called after the last AddUnpacker()
   void AddUnpacker(std::string s, UnpackingModule* u) { unpackers[s] = u; }
+  void BuildDispatchTable();
   UnpackingModule* GetUnpacker(std::string s) { return unpackers[s]; }
+  UnpackingModule* GetUnpacker(UInt_t address) const {
+    UShort_t slot = addressTable.GetSlot(address);
+    return (slot < hubSlots.size()) ? hubSlots[slot] : NULL;
+  }
   
   struct EventHdr {
     UInt_t fullSize;
@@ -55,6 +94,8 @@ public:
     UInt_t trgNr;
   } subHdr;
   
+  size_t ReadEvent(HLDFile& file, size_t position, Event* evt, const vector<UnpackingModule*>* modules, bool& isEmpty);
+  
   UInt_t* pHdr;
   UInt_t* subPHdr;
   
@@ -63,6 +104,9 @@ public:
   UInt_t getFullSize()   const { return ((EventHdr*)pHdr)->fullSize; }
   size_t getDataSize();
   std::string getHubAddress();
+  size_t GetDataSize(const SubEventHdr* h);
+  std::string GetHubAddress(const SubEventHdr* h);
+  UInt_t GetHubAddressValue(const SubEventHdr* h);
   size_t getDataLen()    const { return ((getFullSize() - getHdrSize()) + 3) / 4; }
   size_t align8(const size_t i) const { return 8 * size_t((i - 1) / 8 + 1); }
   size_t getPaddedSize() { return align8(getDataSize()); }
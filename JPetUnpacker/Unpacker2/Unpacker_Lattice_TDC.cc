@@ -1,5 +1,7 @@
 #include "Unpacker_Lattice_TDC.h"
 #include <iostream>
+#include <cstring>
+#include <mutex>
 
 using namespace std;
 
@@ -12,32 +14,27 @@ Unpacker_Lattice_TDC::Unpacker_Lattice_TDC(string bT, string bA, string hA, int
   errorBits = 0;
 
 
-  leadMult = new int[channelNumber];
-	leadFineTimes = new int*[channelNumber]; 
-	leadCoarseTimes = new int*[channelNumber];
-	leadEpochs = new int*[channelNumber];
+  size_t arraySize = channelNumber * MAX_HITS;
+  hitTimes = new int[6 * arraySize];
+	leadFineTimes = hitTimes;
+	leadCoarseTimes = hitTimes + arraySize;
+	leadEpochs = hitTimes + 2 * arraySize;
+	trailFineTimes = hitTimes + 3 * arraySize;
+	trailCoarseTimes = hitTimes + 4 * arraySize;
+	trailEpochs = hitTimes + 5 * arraySize;
+  memset(hitTimes, 0, 6 * arraySize * sizeof(int));
   
-  trailMult = new int[channelNumber];
-	trailFineTimes = new int*[channelNumber]; 
-	trailCoarseTimes = new int*[channelNumber];
-	trailEpochs = new int*[channelNumber];
- 
-  for(int i = 0; i < channelNumber; i++) {
-		leadMult[i] = 0;
-		leadFineTimes[i] = new int[MAX_HITS]; 
-		leadCoarseTimes[i] = new int[MAX_HITS];
-		leadEpochs[i] = new int[MAX_HITS];
-		
-		trailMult[i] = 0;
-		trailFineTimes[i] = new int[MAX_HITS]; 
-		trailCoarseTimes[i] = new int[MAX_HITS];
-		trailEpochs[i] = new int[MAX_HITS];
-  }
+  mults = new int[2 * channelNumber];
+  leadMult = mults;
+  trailMult = mults + channelNumber;
+  memset(mults, 0, 2 * channelNumber * sizeof(int));
+  
+  decodeMode = TDCDecoder::GetBestMode();
+  records.reserve(2 * arraySize);
   
 	actualEpoch = -100000;
 
-  corrections = new TH1F*[cN];
-  TFile* file = new TFile();
+  corrections = 0;
   ifstream my_file(cF.c_str());
   
   if (cF == "raw") {
@@ -49,78 +46,69 @@ Unpacker_Lattice_TDC::Unpacker_Lattice_TDC(string bT, string bA, string hA, int
     
     if ((cF == "none") || (cF.find(".root") == string::npos)) {
       if(VERBOSE) cerr<<"Lattice_TDC: WARNING: Linear correction applied"<<endl;
-      file = new TFile("./linearCorrection.root", "READ");
+      corrections = LoadCorrections("./linearCorrection.root", o, cN);
     }
     else if (!my_file.good()) {
       if(VERBOSE) cerr<<"Lattice_TDC: WARNING: Linear correction applied - file not found"<<endl; 
-      file = new TFile("linearCorrection.root", "READ");
+      corrections = LoadCorrections("linearCorrection.root", o, cN);
     }
     else {
       if(VERBOSE) cerr<<"Lattice_TDC: WARNING: Calculated corrections applied"<<endl; 
-      file = new TFile(cF.c_str(), "READ");
-    }
-    
-    TDirectory* dir = gDirectory->GetDirectory("Rint:/");
-    
-    for (int i = 0; i < cN; i++){
-      TH1F* tmp;
-      tmp = (TH1F*)file->Get(Form("correction%d", o + i));
-      corrections[i] = (TH1F*)(tmp->Clone(Form("correction%d", o + i)));
-      corrections[i]->SetDirectory(dir);
+      corrections = LoadCorrections(cF, o, cN);
     }
-    file->Close();
   }
   
   if(VERBOSE) cerr<<"Lattice_TDC: Creating Unpacker_Lattice_TDC for board type: "<<bT<<" board address "<<bA<<" hub address "<<hA<<" number of channels "<<channelNumber<<endl;
 }
 
 Unpacker_Lattice_TDC::~Unpacker_Lattice_TDC() {
-  for(int i = 0; i < channelNumber; i++) {
-    delete [] corrections[i];
+  delete [] mults;
+  delete [] hitTimes;
+}
 
-		delete [] leadFineTimes[i];
-		delete [] leadCoarseTimes[i];
-		delete [] leadEpochs[i];
-		
-		delete [] trailFineTimes[i];
-		delete [] trailCoarseTimes[i];
-		delete [] trailEpochs[i];
+// Reads the correction histograms of the given channels and flattens
+// them into a table of kFineTimeBins values per channel, such that
+// table[channel * kFineTimeBins + fine] == correction->GetBinContent(fine + 1).
+// The tables are cached by file and channel range and kept until the end
+// of the program, so the modules created for every unpacking thread share
+// a single read-only copy. The modules of several files can be created at
+// the same time, so the cache and the reading of the files are serialized.
+const float* Unpacker_Lattice_TDC::LoadCorrections(string fileName, int offset, int channels) {
+  static map<string, float*> loaded;
+  static mutex loadedMutex;
+  lock_guard<mutex> lock(loadedMutex);
+  
+  stringstream key;
+  key<<fileName<<":"<<offset<<":"<<channels;
+  map<string, float*>::iterator it = loaded.find(key.str());
+  if (it != loaded.end())
+    return it->second;
+  
+  float* table = new float[channels * kFineTimeBins];
+  memset(table, 0, channels * kFineTimeBins * sizeof(float));
+  
+  TFile* file = new TFile(fileName.c_str(), "READ");
+  for (int i = 0; i < channels; i++) {
+    TH1F* tmp = (TH1F*)file->Get(Form("correction%d", offset + i));
+    if (tmp == 0) {
+      if(VERBOSE) cerr<<"Lattice_TDC: ERROR: correction"<<(offset + i)<<" not found in "<<fileName<<endl;
+      continue;
+    }
+    for (int fine = 0; fine < kFineTimeBins; fine++) {
+      table[i * kFineTimeBins + fine] = tmp->GetBinContent(fine + 1);
+    }
   }
+  file->Close();
+  delete file;
   
-  delete [] leadMult;
-  delete [] trailMult;
-
-	delete [] leadFineTimes;
-	delete [] leadCoarseTimes;
-	delete [] leadEpochs;
-
-	delete [] trailFineTimes;
-	delete [] trailCoarseTimes;
-	delete [] trailEpochs;
-
-  delete [] corrections;
+  loaded[key.str()] = table;
+  return table;
 }
 
+// Only the multiplicities are reset, the hit times above them are
+// overwritten by the next event.
 void Unpacker_Lattice_TDC::Clear() {
-  for(int i = 0; i < channelNumber; i++) {
-		delete [] leadFineTimes[i];
-		delete [] leadCoarseTimes[i];
-		delete [] leadEpochs[i];
-		
-		delete [] trailFineTimes[i];
-		delete [] trailCoarseTimes[i];
-		delete [] trailEpochs[i];
-    
-		leadMult[i] = 0;
-		leadFineTimes[i] = new int[MAX_HITS]; 
-		leadCoarseTimes[i] = new int[MAX_HITS];
-		leadEpochs[i] = new int[MAX_HITS];
-		
-		trailMult[i] = 0;
-		trailFineTimes[i] = new int[MAX_HITS]; 
-		trailCoarseTimes[i] = new int[MAX_HITS];
-		trailEpochs[i] = new int[MAX_HITS];
-  }
+  memset(mults, 0, 2 * channelNumber * sizeof(int));
 
 	actualEpoch = -100000;
   
@@ -133,113 +121,44 @@ void Unpacker_Lattice_TDC::ProcessEvent(UInt_t* data) {
 //  if(debugMode == true)
 //    cerr<<"Lattice_TDC: received "<<dataSize<<" bytes to unpack"<<endl;
   
-  while(dataSize > 0) {
-    
-    UInt_t data_i = 0;
-    if(GetInvertBytes() == true) {
-      data_i = ReverseHex((*data));
-    }
-    else {
-      data_i = (*data);
-    }
-    
-    int header = (data_i >> 29);
-    int channel;
-    int coarse;
-    int fine;
-    int epoch;
+  // byte-swap and classify the whole block first, the epoch counter
+  // is carried over into the records of the following time words
+  records.clear();
+  TDCDecoder::Decode(decodeMode, data, dataSize, GetInvertBytes(), actualEpoch, records);
+  
+  for (size_t i = 0; i < records.size(); i++) {
+    const TDCRecord& r = records[i];
+    int channel = r.channel;
+    int fine = r.fine;
     
-/*    if ((data_i >> 29) == 1) {
-      errorBits = data_i & 0xffff;
-    }
-    else {*/
+    if (fine == 0x3ff || channel >= channelNumber)
+      continue;
     
-      switch (header) {
-
-/*	case 1:
-		errorBits = data_i & 0xffff;
-		if(debugMode == true) {
-	    printf("%08X\n", data_i);
-			cerr<<"Lattice_TDC: TDC Header found"<<endl;
-		}
-		break;*/
-	
-	case 3: // epoch ctr
-		epoch = data_i & 0xfffffff;
-//		if(debugMode == true) {
-//	    printf("%08X\n", data_i);
-//			cerr<<"Lattice_TDC: EpochCounter found with value "<<epoch<<" assigned as actualEpoch"<<endl;
-//		}
-		actualEpoch = epoch;
-		break;
-		
-
-	case 4:// time data
-	  channel = (data_i >> 22) & 0x7f;
-	  coarse = (data_i & 0x7ff);
-	  fine = (data_i >> 12) & 0x3ff;
-	  
-	  /*if (useCorrections == true) {
-	    time = (coarse * 5000. - (corrections[channel]->GetBinContent(fine))) / 10.;
-	    fineTimes[channel][leadMult[channel]] = corrections[channel]->GetBinContent(fine) / 10.;
-	  }
-	  else {
-	    time = (coarse*5.-((5.*fine)/469.))*100.;
-	    fineTimes[channel][leadMult[channel]] = fine;
-	  }*/
-
-	  if (((data_i >> 11) & 0x1) == 1) { // rising edge
-//	    if(debugMode == true) {
-//	      printf("%08X\n", data_i);
-//	      cerr<<"Lattice_TDC: LeadTime found on channel "<<channel<<" with fine "<<fine<<" coarse "<<coarse<<endl; 
-//				cerr<<"matched with actualEpoch counter with value "<<actualEpoch<<endl;	      
-//	    }
-
-			if (fine != 0x3ff) {
-				if (useCorrections == true)
-					leadFineTimes[channel][leadMult[channel]] = (corrections[channel]->GetBinContent(fine + 1));
-				else		
-					leadFineTimes[channel][leadMult[channel]] = fine * 10.0;
-
-				leadCoarseTimes[channel][leadMult[channel]] = coarse;
-				leadEpochs[channel][leadMult[channel]] = actualEpoch;
-			  leadMult[channel]++;
-			}
-	  }
-	  else { // falling edge	    
-//			if(debugMode == true) {
-//	      printf("%08X\n", data_i);
-//	      cerr<<"Lattice_TDC: TrailTime found on channel "<<channel<<" with fine "<<fine<<" coarse "<<coarse<<endl; 
-//				cerr<<"matched with actualEpoch counter with value "<<actualEpoch<<endl;
-//	    }
-
-			if (fine != 0x3ff) {
-				if (useCorrections == true)
-					trailFineTimes[channel][trailMult[channel]] = (corrections[channel]->GetBinContent(fine + 1));
-				else		
-					trailFineTimes[channel][trailMult[channel]] = fine * 10.0;
-				trailCoarseTimes[channel][trailMult[channel]] = coarse;
-				trailEpochs[channel][trailMult[channel]] = actualEpoch;
-			  trailMult[channel]++;
-			}
-	  }
-	  break;
-
-/*	case 2: // debug word
-		if(debugMode == true) {
-	    printf("%08X\n", data_i);
-			cerr<<"Lattice_TDC: Debug word found"<<endl;
-		}
-		break;*/
-	  
-	default:
-	  break;
+    if (r.edge == 1) { // rising edge
+      if (leadMult[channel] < MAX_HITS) {
+	int index = channel * MAX_HITS + leadMult[channel];
+	if (useCorrections == true)
+	  leadFineTimes[index] = corrections[channel * kFineTimeBins + fine];
+	else		
+	  leadFineTimes[index] = fine * 10.0;
 	
-     
+	leadCoarseTimes[index] = r.coarse;
+	leadEpochs[index] = r.epoch;
+	leadMult[channel]++;
+      }
+    }
+    else { // falling edge
+      if (trailMult[channel] < MAX_HITS) {
+	int index = channel * MAX_HITS + trailMult[channel];
+	if (useCorrections == true)
+	  trailFineTimes[index] = corrections[channel * kFineTimeBins + fine];
+	else		
+	  trailFineTimes[index] = fine * 10.0;
+	trailCoarseTimes[index] = r.coarse;
+	trailEpochs[index] = r.epoch;
+	trailMult[channel]++;
+      }
     }
-    
-    data++;
-    dataSize--;
   }
 }
 
@@ -3,6 +3,7 @@
 
 #include "UnpackingModule.h"
 #include "Event.h"
+#include "TDCDecoder.h"
 //#include "Hit.h"
 #include <TH1F.h>
 #include <TFile.h>
@@ -10,28 +11,45 @@
 class Unpacker_Lattice_TDC : public UnpackingModule {
   
 private:
+	// all the hit times of the module are kept in one block allocated in
+	// the constructor: six arrays of channelNumber * MAX_HITS values,
+	// the hit j of channel i is stored at index i * MAX_HITS + j
+	int* hitTimes;
+	int* leadFineTimes;
+	int* leadCoarseTimes;
+	int* leadEpochs;
+	int* trailFineTimes;
+	int* trailCoarseTimes;
+	int* trailEpochs;
+
+	// lead multiplicities followed by trail multiplicities,
+	// the only values reset between the events
+	int* mults;
 	int* leadMult;
-	int** leadFineTimes;
-	int** leadCoarseTimes;
-	int** leadEpochs;
-  
 	int* trailMult;
-	int** trailFineTimes;
-	int** trailCoarseTimes;
-	int** trailEpochs;
 
   int channelNumber;
   int offset;
   
-  TH1F** corrections;
+  // fine time corrections of all the channels, kFineTimeBins values
+  // per channel; the table is shared by all the modules reading the same
+  // correction file and is never modified after loading
+  const float* corrections;
   bool useCorrections;
 
+  static const float* LoadCorrections(string fileName, int offset, int channels);
+
   int actualEpoch;
   
+  TDCDecoder::Mode decodeMode;
+  vector<TDCRecord> records;
+  
   UInt_t errorBits;
   
 public:
   
+  static const int kFineTimeBins = 1024;
+  
   Unpacker_Lattice_TDC() { }
   Unpacker_Lattice_TDC(string bT, string bA, string hA, int cN, int o, int r, string mR, bool dec, bool dbg, string cF);
   ~Unpacker_Lattice_TDC();
@@ -42,17 +60,20 @@ public:
   void SayHi() { cerr<<"Lattice_TDC: Hi from Lattice_TDC"<<endl; }
   
   int GetLeadMult(int channel) { return leadMult[channel]; }
-  int GetLeadFineTime(int channel, int mult) { return leadFineTimes[channel][mult]; }
-  int GetLeadCoarseTime(int channel, int mult) { return leadCoarseTimes[channel][mult]; }
-  int GetLeadEpoch(int channel, int mult) { return leadEpochs[channel][mult]; }
+  int GetLeadFineTime(int channel, int mult) { return leadFineTimes[channel * MAX_HITS + mult]; }
+  int GetLeadCoarseTime(int channel, int mult) { return leadCoarseTimes[channel * MAX_HITS + mult]; }
+  int GetLeadEpoch(int channel, int mult) { return leadEpochs[channel * MAX_HITS + mult]; }
 
   int GetTrailMult(int channel) { return trailMult[channel]; }
-  int GetTrailFineTime(int channel, int mult) { return trailFineTimes[channel][mult]; }
-  int GetTrailCoarseTime(int channel, int mult) { return trailCoarseTimes[channel][mult]; }
-  int GetTrailEpoch(int channel, int mult) { return trailEpochs[channel][mult]; }
+  int GetTrailFineTime(int channel, int mult) { return trailFineTimes[channel * MAX_HITS + mult]; }
+  int GetTrailCoarseTime(int channel, int mult) { return trailCoarseTimes[channel * MAX_HITS + mult]; }
+  int GetTrailEpoch(int channel, int mult) { return trailEpochs[channel * MAX_HITS + mult]; }
 
   UInt_t GetErrorBits() { return errorBits; }
   
+  void SetDecodeMode(TDCDecoder::Mode mode) { decodeMode = mode; }
+  TDCDecoder::Mode GetDecodeMode() { return decodeMode; }
+  
   void Clear();
   
   //  ClassDef(Unpacker_Lattice_TDC, 1);
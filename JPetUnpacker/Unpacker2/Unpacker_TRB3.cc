@@ -65,12 +65,12 @@ void Unpacker_TRB3::ProcessEvent(UInt_t* data, Event* evt) {
       
       size_t internalSize = data_i >> 16;     
       
-      UnpackingModule* u = GetUnpacker(UIntToString(tdcNumber));
+      UnpackingModule* u = GetUnpacker(tdcNumber);
       if (u != NULL) {
 	if(debugMode == true)
 		if(VERBOSE) cerr<<"Unpacker_TRB3.cc: Calling Lattice_TDC for module "<<UIntToString(tdcNumber)<<" passing "<<internalSize<<" bytes"<<endl;
-	GetUnpacker(UIntToString(tdcNumber))->SetEntireEventSize(internalSize + 1);
-	GetUnpacker(UIntToString(tdcNumber))->ProcessEvent(data);
+	u->SetEntireEventSize(internalSize + 1);
+	u->ProcessEvent(data);
       }
       else {
 	if(debugMode == true)
@@ -1,7 +1,11 @@
 #include "UnpackingModule.h"
+#include <cstdlib>
 
 //ClassImp(UnpackingModule);
 
+const UInt_t AddressTable::kSize;
+const UShort_t AddressTable::kNoSlot;
+
 UnpackingModule::UnpackingModule(string bT, string bA, string hA, int cN, int o, int r, string mR, bool dec, bool dbg) {
   boardType = bT;
   boardAddress = bA;
@@ -13,6 +17,41 @@ UnpackingModule::UnpackingModule(string bT, string bA, string hA, int cN, int o,
   invertBytes = dec;
   
   debugMode = dbg;
+  
+  addressTable = 0;
+}
+
+// Adds the addresses of the internal unpackers to the shared table.
+void UnpackingModule::RegisterAddresses(AddressTable& table) const {
+  map<std::string, UnpackingModule*>::const_iterator iter;
+  for (iter = internalUnpackers.begin(); iter != internalUnpackers.end(); iter++) {
+    UInt_t address = 0;
+    if (StringToAddress(iter->first, address)) {
+      table.Register(address);
+    }
+    else {
+      if(VERBOSE) cerr<<"UnpackingModule: WARNING: address "<<iter->first<<" is not a 16-bit hex number, it is reachable only by name"<<endl;
+    }
+    iter->second->RegisterAddresses(table);
+  }
+}
+
+// Indexes the internal unpackers by the slots of the shared table, which
+// must already hold their addresses.
+void UnpackingModule::SetAddressTable(const AddressTable* table) {
+  addressTable = table;
+  slotUnpackers.assign(table->GetNumberOfSlots(), NULL);
+  
+  map<std::string, UnpackingModule*>::iterator iter;
+  for (iter = internalUnpackers.begin(); iter != internalUnpackers.end(); iter++) {
+    UInt_t address = 0;
+    if (StringToAddress(iter->first, address)) {
+      UShort_t slot = table->GetSlot(address);
+      if (slot < slotUnpackers.size())
+	slotUnpackers[slot] = iter->second;
+    }
+    iter->second->SetAddressTable(table);
+  }
 }
 
 void UnpackingModule::ProcessEvent(UInt_t* /* data */) { }
@@ -52,3 +91,18 @@ string UnpackingModule::UIntToString(UInt_t t) {
   
   return s;  
 }
+
+// Parses the hex address used in the config file (e.g. "e000") into its
+// numerical value. Returns false if it does not fit into 16 bits.
+bool UnpackingModule::StringToAddress(string s, UInt_t& address) {
+  if (s.empty() || s.length() > 4)
+    return false;
+  
+  char* end = 0;
+  unsigned long value = strtoul(s.c_str(), &end, 16);
+  if (*end != '\0' || value >= AddressTable::kSize)
+    return false;
+  
+  address = (UInt_t) value;
+  return true;
+}
@@ -7,11 +7,38 @@
 #include <iostream>
 #include <string>
 #include <map>
+#include <vector>
 #include "Event.h"
 #include <sstream>
 
 using namespace std;
 
+// Maps the 16-bit trbnet addresses of the modules in the config file to
+// consecutive slot numbers. It is filled once after all the unpackers are
+// registered and only read afterwards, so a single table serves all the
+// modules and all the unpacking workers. Each of them keeps just a short
+// vector of its own unpackers indexed by slot.
+class AddressTable {
+
+private:
+  vector<UShort_t> slots;
+  UShort_t numberOfSlots;
+
+public:
+
+  static const UInt_t kSize = 0x10000;
+  static const UShort_t kNoSlot = 0xffff;
+
+  AddressTable() : slots(kSize, kNoSlot), numberOfSlots(0) {}
+
+  void Register(UInt_t address) {
+    if (address < kSize && slots[address] == kNoSlot && numberOfSlots < kNoSlot)
+      slots[address] = numberOfSlots++;
+  }
+  UShort_t GetSlot(UInt_t address) const { return (address < kSize) ? slots[address] : kNoSlot; }
+  size_t GetNumberOfSlots() const { return numberOfSlots; }
+};
+
 class UnpackingModule : public TObject {
 
 private:
@@ -27,20 +54,33 @@ private:
   bool invertBytes;
   
   map<std::string, UnpackingModule*> internalUnpackers;
+  
+  // shared table of the trbnet addresses and the internal unpackers
+  // indexed by its slots, set by SetAddressTable()
+  const AddressTable* addressTable;
+  vector<UnpackingModule*> slotUnpackers;
  
 public:
   
-  UnpackingModule() {}
+  UnpackingModule() : addressTable(0) {}
   UnpackingModule(string bT, string bA, string hA, int cN, int o, int r, string mR, bool dec, bool dbg);
-  ~UnpackingModule() {}
+  virtual ~UnpackingModule() {}
   
   void AddUnpacker(std::string s, UnpackingModule* u) { internalUnpackers[s] = u; }
+  void RegisterAddresses(AddressTable& table) const;
+  void SetAddressTable(const AddressTable* table);
   UnpackingModule* GetUnpacker(std::string s) { 
     if (internalUnpackers.count(s) == 1)
       return internalUnpackers[s];
     else
       return NULL;
   }
+  UnpackingModule* GetUnpacker(UInt_t address) const {
+    if (addressTable == 0)
+      return NULL;
+    UShort_t slot = addressTable->GetSlot(address);
+    return (slot < slotUnpackers.size()) ? slotUnpackers[slot] : NULL;
+  }
   
   void SetBoardType(string t) { boardType = t; }
   void SetBoardAddress(string t) { boardAddress = t; }
@@ -72,6 +112,7 @@ public:
   virtual void Clear();
  
   string UIntToString(UInt_t t);
+  static bool StringToAddress(string s, UInt_t& address);
   
   map<std::string, UnpackingModule*>::iterator GetInternalUnpackersIterBegin() { return internalUnpackers.begin(); }
   map<std::string, UnpackingModule*>::iterator GetInternalUnpackersIterEnd() { return internalUnpackers.end(); }
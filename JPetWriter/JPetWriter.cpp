@@ -14,27 +14,81 @@
  */
 
 #include "JPetWriter.h"
+#include <TClass.h>
+#include <TCondition.h>
+#include <TMutex.h>
+#include <TThread.h>
 #include "../JPetUserInfoStructure/JPetUserInfoStructure.h"
+#include "../JPetEventQueue/JPetEventQueue.h"
 
 
+JPetWriter::Settings::Settings():
+  fAsync(false),
+  fCompressionAlgorithm(0),
+  fCompressionLevel(1),
+  fBasketSize(32000),
+  fAutoSave(10000),
+  fQueueSize(1000)
+{
+}
+
 JPetWriter::JPetWriter(const char* p_fileName) :
   fFileName(p_fileName),			// string z nazwą pliku
   fFile(0),	// plik
   fIsBranchCreated(false),
-  fTree(0)
+  fTree(0),
+  fFillObject(0),
+  fThread(0),
+  fQueueMutex(0),
+  fNotEmpty(0),
+  fNotFull(0),
+  fDrained(0),
+  fBusy(false),
+  fStopping(false),
+  fOutputQueue(0)
+{
+  openFile();
+}
+
+JPetWriter::JPetWriter(const char* p_fileName, const Settings& settings) :
+  fFileName(p_fileName),
+  fFile(0),
+  fIsBranchCreated(false),
+  fTree(0),
+  fFillObject(0),
+  fSettings(settings),
+  fThread(0),
+  fQueueMutex(0),
+  fNotEmpty(0),
+  fNotFull(0),
+  fDrained(0),
+  fBusy(false),
+  fStopping(false),
+  fOutputQueue(0)
+{
+  openFile();
+}
+
+JPetWriter::JPetWriter(JPetEventQueue* outputQueue) :
+  fFile(0),
+  fIsBranchCreated(false),
+  fTree(0),
+  fFillObject(0),
+  fThread(0),
+  fQueueMutex(0),
+  fNotEmpty(0),
+  fNotFull(0),
+  fDrained(0),
+  fBusy(false),
+  fStopping(false),
+  fOutputQueue(outputQueue)
 {
-  fFile = new TFile(fFileName.c_str(), "RECREATE");
-  if (!isOpen()) {
-    ERROR("Could not open file to write.");
-  } else {
-    fTree = new TTree("tree", "tree");
-    fTree->SetAutoSave(10000);
-  }
 }
 
 JPetWriter::~JPetWriter()
 {
   DEBUG("destructor of JPetWriter");
+  stopThread();
   if (isOpen()) {
     fTree->AutoSave("SaveSelf");
     if (fFile) {
@@ -46,8 +100,65 @@ JPetWriter::~JPetWriter()
   DEBUG("exiting destructor of JPetWriter");
 }
 
+void JPetWriter::openFile()
+{
+  fFile = new TFile(fFileName.c_str(), "RECREATE");
+  if (!isOpen()) {
+    ERROR("Could not open file to write.");
+  } else {
+    // the branches take the compression settings of the file when they are created
+    fFile->SetCompressionAlgorithm(fSettings.fCompressionAlgorithm);
+    fFile->SetCompressionLevel(fSettings.fCompressionLevel);
+    fTree = new TTree("tree", "tree");
+    fTree->SetAutoSave(fSettings.fAutoSave);
+    if (fSettings.fAsync) {
+      startThread();
+    }
+  }
+}
+
+void JPetWriter::createBranch(const char* name, void* object)
+{
+  DEBUG("Branch");
+  assert(fTree);
+  fFillObject = object;
+  // the address of the pointer to the object, of the class given by name
+  fTree->Branch(name, name, (void*) &fFillObject, fSettings.fBasketSize);
+  fIsBranchCreated = true;
+}
+
+bool JPetWriter::copyEntry(const TObject& obj)
+{
+  if (fOutputQueue) {
+    forward(obj.Clone());
+    if (!fFile) return true;
+  }
+  if ( !fFile || !fFile->IsOpen() ) {
+    ERROR("Could not write to file. Have you closed it already?");
+    return false;
+  }
+  TObject* object = const_cast<TObject*>(&obj);
+  if (fThread) {
+    object = obj.Clone();
+  } else {
+    fFile->cd();
+  }
+  // the branch needs the address of the whole object, not of its TObject part
+  void* address = object->IsA()->DynamicCast(TObject::Class(), object, kFALSE);
+  if (!fIsBranchCreated) {
+    createBranch(object->GetName(), address);
+  }
+  if (fThread) {
+    return enqueue(object, address);
+  }
+  fFillObject = address;
+  fTree->Fill();
+  return true;
+}
+
 void JPetWriter::closeFile()
 {
+  stopThread();
   if (isOpen() ) {
     fTree->AutoSave("SaveSelf");
     delete fFile;
@@ -59,7 +170,108 @@ void JPetWriter::closeFile()
 
 void JPetWriter::writeHeader(TObject* header)
 {
+  if (!fTree) {
+    // nothing is written to disk, the header has no tree to belong to
+    delete header;
+    return;
+  }
+  flush();
   // @todo as the second argument should be passed some enum to indicate position of header
   fTree->GetUserInfo()->AddAt(header, JPetUserInfoStructure::kHeader);
 }
 
+void JPetWriter::startThread()
+{
+  TThread::Initialize();
+  fQueueMutex = new TMutex();
+  fNotEmpty = new TCondition(fQueueMutex);
+  fNotFull = new TCondition(fQueueMutex);
+  fDrained = new TCondition(fQueueMutex);
+  fBusy = false;
+  fStopping = false;
+  fThread = new TThread("JPetWriter", processQueueProxy, (void*) this);
+  fThread->Run();
+}
+
+/// Fills the remaining objects and stops the I/O thread
+void JPetWriter::stopThread()
+{
+  if (!fThread) return;
+  fQueueMutex->Lock();
+  fStopping = true;
+  fNotEmpty->Signal();
+  fQueueMutex->UnLock();
+  fThread->Join();
+  delete fThread;
+  fThread = 0;
+
+  delete fDrained;
+  delete fNotFull;
+  delete fNotEmpty;
+  delete fQueueMutex;
+  fDrained = fNotFull = fNotEmpty = 0;
+  fQueueMutex = 0;
+}
+
+void JPetWriter::flush()
+{
+  if (!fThread) return;
+  fQueueMutex->Lock();
+  while (!fQueue.empty() || fBusy) {
+    fDrained->Wait();
+  }
+  fQueueMutex->UnLock();
+}
+
+bool JPetWriter::enqueue(TObject* object, void* address)
+{
+  fQueueMutex->Lock();
+  while (fQueue.size() >= fSettings.fQueueSize) {
+    fNotFull->Wait();
+  }
+  fQueue.push_back(QueueItem(object, address));
+  fNotEmpty->Signal();
+  fQueueMutex->UnLock();
+  return true;
+}
+
+void JPetWriter::processQueue()
+{
+  fQueueMutex->Lock();
+  while (true) {
+    while (fQueue.empty() && !fStopping) {
+      fNotEmpty->Wait();
+    }
+    if (fQueue.empty()) break;
+
+    QueueItem item = fQueue.front();
+    fQueue.pop_front();
+    fBusy = true;
+    fNotFull->Signal();
+    fQueueMutex->UnLock();
+
+    fFillObject = item.second;
+    fTree->Fill();
+    delete item.first;
+
+    fQueueMutex->Lock();
+    fBusy = false;
+    if (fQueue.empty()) {
+      fDrained->Broadcast();
+    }
+  }
+  fQueueMutex->UnLock();
+}
+
+/// Passes the copy of a written object to the next task of the chain
+void JPetWriter::forward(TObject* copy)
+{
+  assert(fOutputQueue);
+  fOutputQueue->push(copy);
+}
+
+void* JPetWriter::processQueueProxy(void* writer)
+{
+  static_cast<JPetWriter*>(writer)->processQueue();
+  return 0;
+}
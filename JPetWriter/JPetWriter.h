@@ -18,6 +18,8 @@
 
 #include <vector>
 #include <string>
+#include <deque>
+#include <utility>
 #include <TFile.h>
 #include <TList.h>
 #include <TTree.h>
@@ -43,50 +45,124 @@ class boost::noncopyable;
 #include "../JPetFEB/JPetFEB.h"
 #include "../JPetTRB/JPetTRB.h"
 
+class TCondition;
+class TMutex;
+class TThread;
+class JPetEventQueue;
 
 /**
  * @brief A class responsible for writing any data to ROOT trees.
  *
  * All objects inheriting from JPetAnalysisModule should use this class in order to access and write to ROOT files.
+ * In the asynchronous mode write() only copies the object into a bounded queue and
+ * a separate I/O thread fills the tree, so the compression of the baskets and the
+ * disk flushes do not block the analysis. The objects are filled in the order of
+ * the write() calls, hence the tree is the same as in the synchronous mode.
+ * With an output queue every written object is also copied to the next task of
+ * a streaming chain (see JPetEventQueue), a writer created without a file name
+ * only passes the objects to the queue.
  */
 class JPetWriter : private boost::noncopyable
 {
 public:
+  /**
+   * @brief Output settings, the defaults are those of the synchronous writer.
+   */
+  struct Settings {
+    Settings();
+    bool fAsync; ///< fill the tree in a separate I/O thread
+    int fCompressionAlgorithm; ///< ROOT compression algorithm, 0 means the global setting
+    int fCompressionLevel; ///< 0 (no compression) - 9
+    int fBasketSize; ///< buffer size of the branch in bytes
+    long long fAutoSave; ///< number of entries (or bytes if negative) between the AutoSaves of the tree
+    unsigned int fQueueSize; ///< maximal number of objects waiting for the I/O thread
+  };
+
   JPetWriter(const char* p_fileName);
+  JPetWriter(const char* p_fileName, const Settings& settings);
+  explicit JPetWriter(JPetEventQueue* outputQueue);
   virtual ~JPetWriter(void);
 
   template <class T>
   bool write(const T& obj);
+  /// Writes an object whose class is known only at run time, e.g. one read from another tree
+  bool copyEntry(const TObject& obj);
   virtual bool isOpen() const {
     if (fFile) return (fFile->IsOpen() && !fFile->IsZombie());
     else return false;
   }
+  /// Takes the ownership of the header
   void writeHeader(TObject* header);
   void closeFile();
 
   int writeObject(const TObject* obj, const char* name) {
+    if (!fFile) return 0;
+    flush();
     return fFile->WriteTObject(obj, name);
   }
 
+  /// Waits until all the queued objects are filled into the tree
+  void flush();
+  inline const Settings& getSettings() const { return fSettings; }
+  /// The queue gets a copy of every object written from now on, it is not owned by the writer
+  inline void setOutputQueue(JPetEventQueue* queue) { fOutputQueue = queue; }
+  inline JPetEventQueue* getOutputQueue() const { return fOutputQueue; }
 
 protected:
+  typedef std::pair<TObject*, void*> QueueItem; ///< object to delete and address of the object to fill
+
+  void openFile();
+  void createBranch(const char* name, void* object);
+  bool enqueue(TObject* object, void* address);
+  void forward(TObject* copy);
+  void startThread();
+  void stopThread();
+  void processQueue();
+  static void* processQueueProxy(void* writer);
+
   std::string fFileName;
   TFile* fFile;
   bool fIsBranchCreated;
   TTree* fTree;
+  void* fFillObject; ///< the branch address points here
 
   TList fTList;
+
+  Settings fSettings;
+  std::deque<QueueItem> fQueue;
+  TThread* fThread;
+  TMutex* fQueueMutex;
+  TCondition* fNotEmpty;
+  TCondition* fNotFull;
+  TCondition* fDrained;
+  bool fBusy;
+  bool fStopping;
+  JPetEventQueue* fOutputQueue;
 };
 
 template <class T>
 bool JPetWriter::write(const T& obj)
 {
   DEBUG("JPetWriter");
-  if ( !fFile->IsOpen() ) {
+  if (fOutputQueue) {
+    forward(new T(obj));
+    if (!fFile) return true;
+  }
+  if ( !fFile || !fFile->IsOpen() ) {
     ERROR("Could not write to file. Have you closed it already?");
     return false;
   }
   assert(fFile);
+
+  if (fThread) {
+    // the I/O thread owns the tree, it gets its own copy of the object
+    T* copy = new T(obj);
+    if (!fIsBranchCreated) {
+      createBranch(copy->GetName(), copy);
+    }
+    return enqueue(copy, copy);
+  }
+
   DEBUG("cd");
   fFile->cd(/*fFileName.c_str()*/); // -> http://root.cern.ch/drupal/content/current-directory
 
@@ -94,13 +170,11 @@ bool JPetWriter::write(const T& obj)
   T* filler = const_cast<T*>(&obj);
   assert(filler);
   if (!fIsBranchCreated) {
-    DEBUG("Branch");
-    assert(fTree);
-    fTree->Branch(filler->GetName(), filler->GetName(), &filler);
-    fIsBranchCreated = true;
+    createBranch(filler->GetName(), filler);
   }
 
   DEBUG("fTree->Fill()");
+  fFillObject = filler;
   fTree->Fill();
   return true;
 }
@@ -13,6 +13,7 @@
 #include "../JPetLOR/JPetLOR.h"
 #include "../JPetWriter/JPetWriter.h"
 #include "../JPetReader/JPetReader.h"
+#include "../JPetEventQueue/JPetEventQueue.h"
 
 
 //  JPetWriter(const char *p_fileName);
@@ -218,4 +219,74 @@ BOOST_AUTO_TEST_CASE( saving_different_objects8 )
           boost::filesystem::remove(fileTest);
 } 
 
+BOOST_AUTO_TEST_CASE( asyncWriterProducesTheSameTree )
+{
+  const std::string syncFile = "asyncWriterTest_sync.root";
+  const std::string asyncFile = "asyncWriterTest_async.root";
+  const int kHugeNumberOfObjects = 10000;
+
+  JPetWriter::Settings settings;
+  settings.fCompressionLevel = 5;
+  settings.fBasketSize = 16000;
+  settings.fAutoSave = 1000;
+  settings.fQueueSize = 10;
+
+  JPetWriter syncWriter(syncFile.c_str(), settings);
+  settings.fAsync = true;
+  JPetWriter asyncWriter(asyncFile.c_str(), settings);
+  for (int i = 0; i < kHugeNumberOfObjects; i++) {
+    TNamed obj("TNamed", Form("Title of this testObj%d", i));
+    BOOST_REQUIRE(syncWriter.write(obj));
+    BOOST_REQUIRE(asyncWriter.write(obj));
+  }
+  TNamed header("header", "header");
+  syncWriter.writeObject(&header, "header");
+  asyncWriter.writeObject(&header, "header");
+  syncWriter.closeFile();
+  asyncWriter.closeFile();
+
+  JPetReader syncReader(syncFile.c_str());
+  JPetReader asyncReader(asyncFile.c_str());
+  BOOST_REQUIRE_EQUAL(syncReader.getNbOfAllEvents(), kHugeNumberOfObjects);
+  BOOST_REQUIRE_EQUAL(asyncReader.getNbOfAllEvents(), kHugeNumberOfObjects);
+  for (int i = 0; i < kHugeNumberOfObjects; i++) {
+    TNamed* syncObj = (TNamed*)syncReader.readEvent(i);
+    TNamed* asyncObj = (TNamed*)asyncReader.readEvent(i);
+    BOOST_REQUIRE(syncObj);
+    BOOST_REQUIRE(asyncObj);
+    BOOST_REQUIRE(std::string(asyncObj->GetName()) == std::string(syncObj->GetName()));
+    BOOST_REQUIRE(std::string(asyncObj->GetTitle()) == std::string(syncObj->GetTitle()));
+  }
+  BOOST_REQUIRE(asyncReader.getObjectFromFile("header"));
+  syncReader.closeFile();
+  asyncReader.closeFile();
+  boost::filesystem::remove(syncFile);
+  boost::filesystem::remove(asyncFile);
+}
+
+BOOST_AUTO_TEST_CASE( writerPassesTheObjectsToTheQueue )
+{
+  JPetEventQueue queue(100);
+  JPetWriter writer(&queue);
+  BOOST_REQUIRE(!writer.isOpen());
+  for (int i = 0; i < 10; i++) {
+    TNamed obj("TNamed", Form("Title of this testObj%d", i));
+    BOOST_REQUIRE(writer.write(obj));
+  }
+  writer.writeHeader(new TNamed("header", "header"));
+  TNamed stats("stats", "stats");
+  BOOST_REQUIRE_EQUAL(writer.writeObject(&stats, "stats"), 0);
+  writer.closeFile();
+  queue.close();
+
+  BOOST_REQUIRE_EQUAL(queue.getNbOfPushed(), 10);
+  for (int i = 0; i < 10; i++) {
+    TNamed* obj = static_cast<TNamed*>(queue.pop());
+    BOOST_REQUIRE(obj);
+    BOOST_REQUIRE(std::string(obj->GetTitle()) == std::string(Form("Title of this testObj%d", i)));
+    delete obj;
+  }
+  BOOST_REQUIRE(!queue.pop());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
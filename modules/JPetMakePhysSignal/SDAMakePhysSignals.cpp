@@ -36,3 +36,9 @@ void SDAMakePhysSignals::setWriter(JPetWriter* writer) {
 	fWriter = writer;
 }
 void SDAMakePhysSignals::terminate(){}
+JPetTask::ParallelMode SDAMakePhysSignals::getParallelMode() const {
+	return kStateless;
+}
+JPetTask* SDAMakePhysSignals::cloneForThread() const {
+	return new SDAMakePhysSignals(GetName(), GetTitle());
+}
@@ -31,6 +31,8 @@ public:
   virtual void init(const JPetTaskInterface::Options&)override;
   virtual void terminate()override;
   virtual void setWriter(JPetWriter* writer)override;  
+  virtual ParallelMode getParallelMode() const override;
+  virtual JPetTask* cloneForThread() const override;
 private:
     JPetWriter* fWriter;
 };
@@ -14,11 +14,23 @@
  */
 
 #include "SDAMatchHits.h"
+#include <algorithm>
+#include <limits>
 using namespace std;
-SDAMatchHits::SDAMatchHits(const char* name, const char* description)
+
+constexpr double SDAMatchHits::kDefaultCoincidenceWindow;
+
+SDAMatchHits::SDAMatchHits(const char* name, const char* description,
+                           double coincidenceWindow, double timeWindowLength)
 : JPetTask(name, description),
+fWriter(0),
+fCoincidenceWindow(coincidenceWindow),
+fTimeWindowLength(timeWindowLength),
 fMatched(0),
-fCurrentEventNumber(0)
+fUnmatched(0),
+fCurrentEventNumber(0),
+fHasTimeWindow(false),
+fTimeWindowIndex(0)
 {
 }
 
@@ -28,96 +40,121 @@ SDAMatchHits::~SDAMatchHits()
 
 void SDAMatchHits::init(const JPetTaskInterface::Options& /* opts */)
 {
-	fMatched = 0; 
-	fCurrentEventNumber=0;
+	fMatched = 0;
+	fUnmatched = 0;
+	fCurrentEventNumber = 0;
+	fHasTimeWindow = false;
+	fTimeWindowIndex = 0;
+	clearBuffers();
 }
 
 void SDAMatchHits::exec(){
 	if(auto currSignal = dynamic_cast<const JPetPhysSignal*const>(getEvent())){
-		if (fSignalsArray.empty()) {
-			fSignalsArray.push_back(*currSignal);
-		} else {
-			if (fSignalsArray[0].getTimeWindowIndex() == currSignal->getTimeWindowIndex()) {
-				fSignalsArray.push_back(*currSignal);
+		auto index = currSignal->getTimeWindowIndex();
+		if (fHasTimeWindow && index != fTimeWindowIndex) {
+			if (fTimeWindowLength > 0.) {
+				// all the signals earlier than the new time window are already buffered
+				matchHits(fTimeWindowLength * index);
 			} else {
-				saveHits(createHits(fSignalsArray)); //create Hits from previously saved signals
-				fSignalsArray.clear();
-				fSignalsArray.push_back(*currSignal);
+				matchHits(numeric_limits<double>::infinity());
+				clearBuffers();
 			}
 		}
+		fHasTimeWindow = true;
+		fTimeWindowIndex = index;
+		addSignal(*currSignal);
 		fCurrentEventNumber++;
 	}
 }
 
-
 void SDAMatchHits::terminate()
 {
+	matchHits(numeric_limits<double>::infinity());
+	clearBuffers();
 	int fEventNb = fCurrentEventNumber;
-	INFO(Form("Matching complete \nAmount of fMatched hits: %d out of initial %d signals" , fMatched, fEventNb) );
+	INFO(Form("Matching complete \nAmount of fMatched hits: %d out of initial %d signals, %d signals without a pair" , fMatched, fEventNb, fUnmatched) );
 }
 
-vector<JPetHit> SDAMatchHits::createHits(vector<JPetPhysSignal>& signals){
-	vector<JPetHit> hits;
-	
-	// group the signals by barrel slot ID
-	map<int, vector<JPetPhysSignal>> signalsBySlot;
-	for(auto const & signal : signals){
-		int barrelSlotID = signal.getRecoSignal().getBarrelSlot().getID();
-		signalsBySlot[barrelSlotID].push_back(signal);
-	}
-	
-	// discard entries for PMTs with smalller number of signals than two for each barrel slot
-	// since they cannot be merged into JPetHit and later for JPetLOR
-	for(auto it = signalsBySlot.begin();it != signalsBySlot.end(); ++it){
-		if( it->second.size() < 2 ){
-			signalsBySlot.erase( it );
-		}
+/**
+ * The signal is copied once, into the buffer of its barrel slot and side,
+ * because the event given to exec() is overwritten by the next one.
+ * The signals of one slot come almost in time order, so the place
+ * of the new one is searched from the back.
+ */
+void SDAMatchHits::addSignal(const JPetPhysSignal& signal)
+{
+	int barrelSlotID = signal.getRecoSignal().getBarrelSlot().getID();
+	SlotBuffers& slot = fSlots[barrelSlotID];
+	SignalBuffer& buffer = (signal.getPM().getSide() == JPetPM::SideA) ? slot.fSideA : slot.fSideB;
+	double time = fTimeWindowLength * signal.getTimeWindowIndex() + signal.getTime();
+	auto position = buffer.end();
+	while (position != buffer.begin() && (position - 1)->fTime > time) {
+		--position;
 	}
-	
-	// iterate over barrel slots which had a sufficient number
-	// of signals to match a hit
-	for(auto it = signalsBySlot.begin();it != signalsBySlot.end(); ++it){  
-		vector<JPetHit> hitsFromSingleSlot = matchHitsWithinSlot(it->second);
-		// append the hits found for one specific barrel slot to all hits from this time window
-		hits.insert(hits.end(), hitsFromSingleSlot.begin(), hitsFromSingleSlot.end());
+	buffer.insert(position, BufferedSignal{time, signal});
+}
+
+void SDAMatchHits::matchHits(double horizon)
+{
+	for (auto& slot : fSlots) {
+		matchHitsWithinSlot(slot.second, horizon);
 	}
-	return hits;
 }
 
-std::vector<JPetHit> SDAMatchHits::matchHitsWithinSlot(std::vector<JPetPhysSignal> signals){
-	vector<JPetHit> hits;
-	
-	for(size_t i=0;i<signals.size()-1;++i){
-		for(size_t j=i+1;j<signals.size();++j){
-			JPetPhysSignal & sig1 = signals.at(i);
-			JPetPhysSignal & sig2 = signals.at(j);
-			if( sig1.getPM().getSide() == sig2.getPM().getSide() ){
-				// @ todo: add more strict rules for deciding whether two signals constitute a hit
-				continue;
-			}else{
-				// ha wave a hit
-				JPetHit hit;
-				if (sig1.getPM().getSide() == JPetPM::SideA){
-					hit.setSignalA(sig1);
-					hit.setSignalB(sig2);
-				}else{
-					hit.setSignalA(sig2);
-					hit.setSignalB(sig1);
-				}
-				hit.setBarrelSlot(sig1.getPM().getBarrelSlot());
-				hit.setScintillator(sig1.getPM().getScin());
-				hits.push_back(hit);
-			}
+/**
+ * Sweeps the time-sorted A and B buffers of one slot. The earliest of the two
+ * first signals is paired with the first signal of the other side if they are
+ * within the coincidence window, otherwise it cannot be paired anymore and is
+ * dropped. A signal is decided on only if no signal coming later, i.e. later
+ * than the horizon, can fall into its coincidence window.
+ */
+void SDAMatchHits::matchHitsWithinSlot(SlotBuffers& slot, double horizon)
+{
+	SignalBuffer& sideA = slot.fSideA;
+	SignalBuffer& sideB = slot.fSideB;
+	while (!sideA.empty() || !sideB.empty()) {
+		bool isAFirst = sideB.empty() || (!sideA.empty() && sideA.front().fTime <= sideB.front().fTime);
+		SignalBuffer& first = isAFirst ? sideA : sideB;
+		SignalBuffer& second = isAFirst ? sideB : sideA;
+		if (first.front().fTime + fCoincidenceWindow >= horizon) {
+			break;
+		}
+		if (!second.empty() && second.front().fTime - first.front().fTime <= fCoincidenceWindow) {
+			saveHit(sideA.front(), sideB.front());
+			sideA.pop_front();
+			sideB.pop_front();
+		} else {
+			fUnmatched++;
+			first.pop_front();
 		}
 	}
-	return hits;
 }
+
+void SDAMatchHits::clearBuffers()
+{
+	for (auto& slot : fSlots) {
+		fUnmatched += slot.second.fSideA.size() + slot.second.fSideB.size();
+		slot.second.fSideA.clear();
+		slot.second.fSideB.clear();
+	}
+}
+
 void SDAMatchHits::setWriter(JPetWriter* writer) {
 	fWriter = writer;
 }
-void SDAMatchHits::saveHits(std::vector<JPetHit> hits){
+
+void SDAMatchHits::saveHit(BufferedSignal& signalA, BufferedSignal& signalB){
 	assert(fWriter);
-	fMatched += hits.size();
-	for (auto hit : hits)
-		fWriter->write(hit);
+	JPetHit hit;
+	hit.setSignalA(signalA.fSignal);
+	hit.setSignalB(signalB.fSignal);
+	// the coincidences of the hits are searched by this time in SDAMatchLORs,
+	// the signals may come from the neighbouring time windows, so the buffered
+	// times counted from the beginning of the data are used
+	unsigned int index = min(signalA.fSignal.getTimeWindowIndex(), signalB.fSignal.getTimeWindowIndex());
+	hit.setTime((signalA.fTime + signalB.fTime) / 2. - fTimeWindowLength * index);
+	hit.setBarrelSlot(signalA.fSignal.getPM().getBarrelSlot());
+	hit.setScintillator(signalA.fSignal.getPM().getScin());
+	fWriter->write(hit);
+	fMatched++;
 }
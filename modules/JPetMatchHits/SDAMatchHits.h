@@ -19,29 +19,64 @@
 #ifndef _JPETANALYSISMODULE_SDAMATCHHITS_H_
 #define _JPETANALYSISMODULE_SDAMATCHHITS_H_
 
+#include <deque>
 #include <map>
 #include <TCanvas.h>
 #include "../../JPetTask/JPetTask.h"
 #include "../../JPetHit/JPetHit.h"
 #include "../../JPetPhysSignal/JPetPhysSignal.h"
 #include "../../JPetWriter/JPetWriter.h"
+
+/**
+ * The signals are kept per barrel slot and side, sorted by time, and the
+ * A and B signals closer than the coincidence window are paired into hits
+ * in one sweep. Every signal is used in at most one hit.
+ * With a time window length > 0 the time of a signal is counted from the
+ * beginning of the data (time window index * length + time), so that signals
+ * from the neighbouring time windows of continuous data are matched too.
+ * With a length of 0 every time window is matched independently.
+ * The time of a hit is counted from the beginning of the time window of its
+ * earlier signal, see JPetHit::getTimeWindowIndex().
+ */
 class SDAMatchHits: public JPetTask{
 public:
-  SDAMatchHits(const char* name, const char* description);
+  static constexpr double kDefaultCoincidenceWindow = 5000.; ///< [ps]
+
+  SDAMatchHits(const char* name, const char* description,
+               double coincidenceWindow = kDefaultCoincidenceWindow,
+               double timeWindowLength = 0.);
   virtual ~SDAMatchHits();
   virtual void exec()override;
   virtual void init(const JPetTaskInterface::Options&)override;
   virtual void terminate()override;
   virtual void setWriter(JPetWriter* writer)override;
  private:
-  std::vector<JPetHit> createHits(std::vector<JPetPhysSignal>& signals);
-  void saveHits(std::vector<JPetHit> hits);
-  std::vector<JPetHit> matchHitsWithinSlot(std::vector<JPetPhysSignal>);
+  struct BufferedSignal {
+    double fTime;
+    JPetPhysSignal fSignal;
+  };
+  typedef std::deque<BufferedSignal> SignalBuffer;
+  struct SlotBuffers {
+    SignalBuffer fSideA;
+    SignalBuffer fSideB;
+  };
+
+  void addSignal(const JPetPhysSignal& signal);
+  /// Pairs the signals which cannot get a partner earlier than the horizon anymore
+  void matchHits(double horizon);
+  void matchHitsWithinSlot(SlotBuffers& slot, double horizon);
+  void saveHit(BufferedSignal& signalA, BufferedSignal& signalB);
+  void clearBuffers();
+
   JPetWriter* fWriter;
+  double fCoincidenceWindow;
+  double fTimeWindowLength;
   int fMatched;
-  int fTSlot;
+  int fUnmatched;
   int fCurrentEventNumber;
-  std::vector<JPetPhysSignal> fSignalsArray;
+  bool fHasTimeWindow;
+  unsigned int fTimeWindowIndex;
+  std::map<int, SlotBuffers> fSlots;
 };
 
 #endif
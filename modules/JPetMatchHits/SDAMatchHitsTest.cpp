@@ -0,0 +1,108 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SDAMatchHitsTest
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include "SDAMatchHits.h"
+#include "../../JPetEventQueue/JPetEventQueue.h"
+#include "../../JPetParamBank/JPetParamBank.h"
+
+namespace
+{
+const double kTimeWindowLength = 100000.; ///< [ps]
+
+struct Fixture {
+  Fixture() {
+    bank.addBarrelSlot(JPetBarrelSlot(1, true, "slot", 0.f, 1));
+    bank.addScintillator(JPetScin(1, 0.f, 0.f, 0.f, 0.f));
+    JPetPM& pmA = bank.addPM(JPetPM(JPetPM::SideA, 1, 0, 0, std::make_pair(0.f, 0.f)));
+    JPetPM& pmB = bank.addPM(JPetPM(JPetPM::SideB, 2, 0, 0, std::make_pair(0.f, 0.f)));
+    pmA.setBarrelSlot(bank.getBarrelSlot(1));
+    pmA.setScin(bank.getScintillator(1));
+    pmB.setBarrelSlot(bank.getBarrelSlot(1));
+    pmB.setScin(bank.getScintillator(1));
+    JPetParamBank::setActive(&bank);
+
+    // the A signal at the end of the first window and the B signal at the beginning
+    // of the second one are 2000 ps apart in continuous data
+    addSignal(1, 0, 99000.f);
+    addSignal(2, 1, 1000.f);
+    addSignal(1, 1, 50000.f);
+    addSignal(2, 1, 52000.f);
+    // further apart than the coincidence window
+    addSignal(1, 1, 60000.f);
+    addSignal(2, 1, 70000.f);
+  }
+
+  ~Fixture() {
+    JPetParamBank::setActive(0);
+  }
+
+  void addSignal(int pmID, unsigned int timeWindowIndex, float time) {
+    JPetRecoSignal recoSignal;
+    recoSignal.setPM(bank.getPM(pmID));
+    recoSignal.setBarrelSlot(bank.getBarrelSlot(1));
+    JPetPhysSignal signal;
+    signal.setRecoSignal(recoSignal);
+    signal.setPM(bank.getPM(pmID));
+    signal.setBarrelSlot(bank.getBarrelSlot(1));
+    signal.setTimeWindowIndex(timeWindowIndex);
+    signal.setTime(time);
+    signals.push_back(signal);
+  }
+
+  /// Returns the hits written by the task, in order
+  std::vector<JPetHit> matchHits(double timeWindowLength) {
+    JPetEventQueue queue(100);
+    JPetWriter writer(&queue);
+    SDAMatchHits task("SDAMatchHits", "", SDAMatchHits::kDefaultCoincidenceWindow, timeWindowLength);
+    task.setWriter(&writer);
+    task.init(JPetTaskInterface::Options());
+    for (auto& signal : signals) {
+      task.setEvent(&signal);
+      task.exec();
+    }
+    task.terminate();
+    queue.close();
+
+    std::vector<JPetHit> hits;
+    while (TObject* object = queue.pop()) {
+      hits.push_back(*static_cast<JPetHit*>(object));
+      delete object;
+    }
+    return hits;
+  }
+
+  JPetParamBank bank;
+  std::vector<JPetPhysSignal> signals;
+};
+}
+
+BOOST_AUTO_TEST_SUITE(FirstSuite)
+
+BOOST_FIXTURE_TEST_CASE( timeWindowsAreMatchedIndependently, Fixture )
+{
+  std::vector<JPetHit> hits = matchHits(0.);
+  BOOST_REQUIRE_EQUAL(hits.size(), 1u);
+  BOOST_REQUIRE_EQUAL(hits[0].getSignalA().getTime(), 50000.f);
+  BOOST_REQUIRE_EQUAL(hits[0].getSignalB().getTime(), 52000.f);
+  BOOST_REQUIRE_EQUAL(hits[0].getTime(), 51000.f);
+}
+
+BOOST_FIXTURE_TEST_CASE( signalsOfNeighbouringTimeWindowsAreMatched, Fixture )
+{
+  std::vector<JPetHit> hits = matchHits(kTimeWindowLength);
+  BOOST_REQUIRE_EQUAL(hits.size(), 2u);
+  BOOST_REQUIRE_EQUAL(hits[0].getSignalA().getTimeWindowIndex(), 0u);
+  BOOST_REQUIRE_EQUAL(hits[0].getSignalA().getTime(), 99000.f);
+  BOOST_REQUIRE_EQUAL(hits[0].getSignalB().getTimeWindowIndex(), 1u);
+  BOOST_REQUIRE_EQUAL(hits[0].getSignalB().getTime(), 1000.f);
+  // counted from the beginning of the window of the earlier signal
+  BOOST_REQUIRE_EQUAL(hits[0].getTimeWindowIndex(), 0u);
+  BOOST_REQUIRE_EQUAL(hits[0].getTime(), 100000.f);
+  BOOST_REQUIRE_EQUAL(hits[1].getSignalA().getTime(), 50000.f);
+  BOOST_REQUIRE_EQUAL(hits[1].getSignalB().getTime(), 52000.f);
+  BOOST_REQUIRE_EQUAL(hits[1].getTimeWindowIndex(), 1u);
+  BOOST_REQUIRE_EQUAL(hits[1].getTime(), 51000.f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -14,11 +14,28 @@
  */
 
 #include "SDAMatchLORs.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <TH1F.h>
 using namespace std;
-SDAMatchLORs::SDAMatchLORs(const char* name, const char* description) : 
+
+constexpr double SDAMatchLORs::kDefaultCoincidenceWindow;
+
+SDAMatchLORs::SDAMatchLORs(const char* name, const char* description,
+                           double coincidenceWindow, double minAngle) :
   JPetTask(name, description),
+  fWriter(0),
+  fCoincidenceWindow(coincidenceWindow),
+  fMinAngle(minAngle),
+  fAcceptanceSize(0),
+  fMultiplicities(kMaxMultiplicity + 1, 0),
   fMatched(0),
-  fCurrentEventNumber(0)
+  fCurrentEventNumber(0),
+  fTimeWindows(0),
+  fProcessingTime(0.),
+  fMultiplicityHisto(-1),
+  fWindowTimeHisto(-1)
 {
 }
 
@@ -27,22 +44,28 @@ SDAMatchLORs::~SDAMatchLORs(){}
 void SDAMatchLORs::init(const JPetTaskInterface::Options&)
 {
   fMatched=0;
-  fCurrentEventNumber=0;  
+  fCurrentEventNumber=0;
+  fTimeWindows=0;
+  fProcessingTime=0.;
+  fill(fMultiplicities.begin(), fMultiplicities.end(), 0);
+  fillAcceptance();
+  if (fStatistics) {
+    fStatistics->createHistogram(new TH1F("LOR_multiplicity", "Number of hits in a coincidence window",
+                                          kMaxMultiplicity, 0.5, kMaxMultiplicity + 0.5));
+    fStatistics->createHistogram(new TH1F("LOR_window_time", "Time of the LOR matching per time window [#mus]",
+                                          200, 0., 2000.));
+    fMultiplicityHisto = fStatistics->getHisto1DHandle("LOR_multiplicity");
+    fWindowTimeHisto = fStatistics->getHisto1DHandle("LOR_window_time");
+  }
 }
 
 void SDAMatchLORs::exec(){
 	if(auto currHit = dynamic_cast<const JPetHit*const>(getEvent())){
-		if (fHitsArray.empty()) {
-			fHitsArray.push_back(*currHit);
-		} else {
-			if (fHitsArray[0].getTimeWindowIndex() == currHit->getTimeWindowIndex()) {
-				fHitsArray.push_back(*currHit);
-			} else {
-				saveLORs(createLORs(fHitsArray)); //create LORs from Hits from the same Time Window
-				fHitsArray.clear();
-				fHitsArray.push_back(*currHit);
-			}
+		if (!fHitsArray.empty() && fHitsArray[0].getTimeWindowIndex() != currHit->getTimeWindowIndex()) {
+			createLORs(); //create LORs from Hits from the same Time Window
+			fHitsArray.clear();
 		}
+		fHitsArray.push_back(*currHit);
 		fCurrentEventNumber++;
 	}
 }
@@ -50,46 +73,141 @@ void SDAMatchLORs::exec(){
 
 void SDAMatchLORs::terminate()
 {
+  if (!fHitsArray.empty()) {
+    createLORs();
+    fHitsArray.clear();
+  }
   int fEventNb = fCurrentEventNumber;
   INFO(Form("Matching complete \nAmount of LORs mathed: %d out of %d hits" , fMatched, fEventNb) );
   double goodPercent = fMatched* 100.0 /fEventNb ;
   INFO(Form("%f %% of data was matched \n " , goodPercent) );
+  if (fTimeWindows > 0) {
+    INFO(Form("LOR matching took %.1f us per time window on average (%d time windows)",
+              fProcessingTime * 1e6 / fTimeWindows, fTimeWindows));
+  }
+  std::string multiplicities;
+  for (int k = 1; k <= kMaxMultiplicity; k++) {
+    multiplicities += Form(" %d%s:%lld", k, (k == kMaxMultiplicity) ? "+" : "", fMultiplicities[k]);
+  }
+  INFO("Coincidence multiplicities (hits:count):" + multiplicities);
 }
 
-vector<JPetLOR> SDAMatchLORs::createLORs(vector<JPetHit>& hits){
-  vector<JPetLOR> lors;
-  for (auto i = hits.begin(); i != hits.end(); ++i) {
-    for (auto j = i + 1; j != hits.end(); ++j ) {
-      JPetHit & hit1 = *i;
-      JPetHit & hit2 = *j;
-      // @ todo: add more strict rules for deciding whether two hits constitute a LOR
-      if (hit1.getScintillator() != hit2.getScintillator()) {
-	// found 2 hits in different scintillators -> an event!
-	
-	// create an event object
-	JPetLOR event;
-	// convention: "first hit" is the one with earlier time
-	if (hit1.getTime() < hit2.getTime()) {
-	  event.setFirstHit(hit1);
-	  event.setSecondHit(hit2);
-	} else {
-	  event.setFirstHit(hit2);
-	  event.setSecondHit(hit1);
-	}
-	lors.push_back(event);
+/**
+ * Precomputes which pairs of scintillators can form a LOR.
+ * Without an angular cut only the scintillator ids are compared and no table is needed.
+ */
+void SDAMatchLORs::fillAcceptance()
+{
+  fScinRows.clear();
+  fAcceptance.clear();
+  fAcceptanceSize = 0;
+  if (fMinAngle <= 0.) return;
+  const auto& scintillators = getParamBank().getScintillators();
+  if (scintillators.empty()) return;
+  // the map is ordered, so the last id is the largest one
+  const int maxID = scintillators.rbegin()->first;
+  if (maxID < 0) return;
+  fScinRows.assign(maxID + 1, -1);
+  vector<double> thetas;
+  vector<int> slots;
+  for (const auto& scin : scintillators) {
+    if (scin.first < 0 || !scin.second->hasBarrelSlot()) {
+      WARNING(Form("Scintillator %d has no barrel slot, its hits do not form LORs", scin.first));
+      continue;
+    }
+    const JPetBarrelSlot& slot = scin.second->getBarrelSlot();
+    fScinRows[scin.first] = thetas.size();
+    thetas.push_back(slot.getTheta());
+    slots.push_back(slot.getID());
+  }
+  fAcceptanceSize = thetas.size();
+  const size_t n = fAcceptanceSize;
+  fAcceptance.assign(n * n, 0);
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = 0; j < n; j++) {
+      double angle = fmod(fabs(thetas[i] - thetas[j]), 360.);
+      angle = min(angle, 360. - angle);
+      fAcceptance[i * n + j] = (slots[i] != slots[j] && angle >= fMinAngle);
+    }
+  }
+}
+
+/// -1 if the scintillator of the hit has no row in fAcceptance
+int SDAMatchLORs::getAcceptanceRow(const JPetHit& hit) const
+{
+  if (fScinRows.empty()) return -1;
+  const int id = hit.getScintillator().getID();
+  if (id < 0 || id >= (int)fScinRows.size()) return -1;
+  return fScinRows[id];
+}
+
+bool SDAMatchLORs::isAccepted(const JPetHit& hit1, const JPetHit& hit2, int row1, int row2) const
+{
+  // @ todo: add more strict rules for deciding whether two hits constitute a LOR
+  if (hit1.getScintillator() == hit2.getScintillator()) return false;
+  if (fMinAngle <= 0.) return true;
+  if (row1 < 0 || row2 < 0) return false;
+  return fAcceptance[row1 * fAcceptanceSize + row2];
+}
+
+void SDAMatchLORs::createLORs(){
+  auto start = chrono::steady_clock::now();
+  const size_t n = fHitsArray.size();
+  fTimeOrder.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    fTimeOrder[i] = i;
+  }
+  const vector<JPetHit>& hits = fHitsArray;
+  stable_sort(fTimeOrder.begin(), fTimeOrder.end(), [&hits](size_t a, size_t b) {
+    return hits[a].getTime() < hits[b].getTime();
+  });
+
+  size_t first = 0;
+  while (first < n) {
+    const double openingTime = hits[fTimeOrder[first]].getTime();
+    size_t last = first + 1;
+    while (last < n && hits[fTimeOrder[last]].getTime() - openingTime <= fCoincidenceWindow) {
+      last++;
+    }
+    const size_t multiplicity = last - first;
+    fMultiplicities[min(multiplicity, size_t(kMaxMultiplicity))]++;
+    if (fMultiplicityHisto >= 0) {
+      fStatistics->getHisto1D(fMultiplicityHisto).Fill(min(multiplicity, size_t(kMaxMultiplicity)));
+    }
+    // the row of every hit is looked up once per coincidence, not once per pair
+    fCoincidenceRows.resize(multiplicity);
+    for (size_t i = first; i < last; i++) {
+      fCoincidenceRows[i - first] = getAcceptanceRow(hits[fTimeOrder[i]]);
+    }
+    // the hits are in time order, so the first one of a pair is the earlier one
+    for (size_t i = first; i + 1 < last; i++) {
+      for (size_t j = i + 1; j < last; j++) {
+        const JPetHit& hit1 = hits[fTimeOrder[i]];
+        const JPetHit& hit2 = hits[fTimeOrder[j]];
+        if (isAccepted(hit1, hit2, fCoincidenceRows[i - first], fCoincidenceRows[j - first])) {
+          saveLOR(hit1, hit2);
+        }
       }
     }
+    first = last;
+  }
+
+  double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  fProcessingTime += elapsed;
+  fTimeWindows++;
+  if (fWindowTimeHisto >= 0) {
+    fStatistics->getHisto1D(fWindowTimeHisto).Fill(elapsed * 1e6);
   }
-  return lors;
 }
 
 
-void SDAMatchLORs::saveLORs(std::vector<JPetLOR> lors){
+void SDAMatchLORs::saveLOR(const JPetHit& firstHit, const JPetHit& secondHit){
   assert(fWriter);
-  fMatched += lors.size();
-  for (auto&lor : lors) {
-    fWriter->write(lor);
-  }
+  JPetLOR lor;
+  lor.setHits(firstHit, secondHit);
+  lor.setTimeDiff(secondHit.getTime() - firstHit.getTime());
+  fWriter->write(lor);
+  fMatched++;
 }
 void SDAMatchLORs::setWriter(JPetWriter* writer) {
 	fWriter = writer;
@@ -18,31 +18,61 @@
 #ifndef _JPETANALYSISMODULE_SDAMATCHLORS_H_
 #define _JPETANALYSISMODULE_SDAMATCHLORS_H_
 
+#include <vector>
 #include <TCanvas.h>
 #include "../../JPetTask/JPetTask.h"
 #include "../../JPetLOR/JPetLOR.h"
 #include "../../JPetHit/JPetHit.h"
 #include "../../JPetWriter/JPetWriter.h"
 
+/**
+ * Coincidence sorter: the hits of a time window are sorted by time once and
+ * swept with a coincidence window opened by the earliest hit not used yet.
+ * All the hits within the window form one coincidence (a multiple), and every
+ * accepted pair of its hits becomes a JPetLOR. A pair is accepted if the hits
+ * come from different scintillators whose barrel slots are at least the
+ * minimal angle apart; the acceptance of every pair of scintillators is
+ * computed once in init(). Scintillators without a barrel slot are never
+ * accepted with the angular cut.
+ */
 class SDAMatchLORs: public JPetTask
 {
 
 public:
 
-  SDAMatchLORs(const char* name, const char* description);
+  static constexpr double kDefaultCoincidenceWindow = 10000.; ///< [ps]
+  static const int kMaxMultiplicity = 10; ///< larger multiples are counted in the last bin
+
+  SDAMatchLORs(const char* name, const char* description,
+               double coincidenceWindow = kDefaultCoincidenceWindow,
+               double minAngle = 0.);
   virtual ~SDAMatchLORs();
   virtual void exec()override;
   virtual void init(const JPetTaskInterface::Options&)override;
   virtual void terminate()override;
   virtual void setWriter(JPetWriter* writer)override;
  private:
-  std::vector<JPetLOR> createLORs(std::vector<JPetHit>& hits);
-  void saveLORs(std::vector<JPetLOR> lors);
+  void createLORs();
+  void fillAcceptance();
+  int getAcceptanceRow(const JPetHit& hit) const;
+  bool isAccepted(const JPetHit& hit1, const JPetHit& hit2, int row1, int row2) const;
+  void saveLOR(const JPetHit& firstHit, const JPetHit& secondHit);
   JPetWriter* fWriter;
+  double fCoincidenceWindow; ///< [ps]
+  double fMinAngle; ///< minimal angle between the barrel slots of a LOR [deg]
   std::vector<JPetHit> fHitsArray;
-  int fTSlot;
+  std::vector<size_t> fTimeOrder; ///< indices of fHitsArray sorted by time
+  std::vector<int> fScinRows; ///< scintillator id -> row of fAcceptance, -1 if it has none
+  size_t fAcceptanceSize; ///< number of rows of fAcceptance
+  std::vector<char> fAcceptance;
+  std::vector<int> fCoincidenceRows; ///< rows of the hits of the current coincidence
+  std::vector<long long> fMultiplicities;
   int fMatched;
   int fCurrentEventNumber;
+  int fTimeWindows;
+  double fProcessingTime; ///< [s]
+  int fMultiplicityHisto; ///< handles in fStatistics
+  int fWindowTimeHisto;
 };
 
 #endif
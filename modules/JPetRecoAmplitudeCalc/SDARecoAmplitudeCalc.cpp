@@ -33,8 +33,8 @@ void SDARecoAmplitudeCalc::exec(){
 	if(auto signal = dynamic_cast<const JPetRecoSignal*const>(getEvent())){
 		double amplitude = JPetRecoSignalTools::calculateAmplitude(*signal);
 		if (amplitude == JPetRecoSignalTools::ERRORS::badAmplitude) {
-			WARNING( Form("Something went wrong when calculating charge for event: %d", fCurrentEventNumber) );
-			JPetRecoSignalTools::saveBadSignalIntoRootFile(*signal, fBadSignals, "badAmplitudes.root");
+			WARNING( Form("Something went wrong when calculating charge for event: %lld", getFirstEventNumber() + fCurrentEventNumber) );
+			JPetRecoSignalTools::saveBadSignalIntoRootFile(*signal, getFirstEventNumber() + fBadSignals, "badAmplitudes.root");
 			fBadSignals++;
 		}else{
 			auto signalWithAmplitude = *signal;
@@ -52,3 +52,14 @@ void SDARecoAmplitudeCalc::terminate(){
 	double goodPercent = (fEventNb-fBadSignals) * 100.0/fEventNb;
 	INFO(Form("Amplitude calculation complete \nAmount of bad signals: %d \n %f %% of data is good" , fBadSignals, goodPercent) );
 }
+JPetTask::ParallelMode SDARecoAmplitudeCalc::getParallelMode() const {
+	return kReducible;
+}
+JPetTask* SDARecoAmplitudeCalc::cloneForThread() const {
+	return new SDARecoAmplitudeCalc(GetName(), GetTitle());
+}
+void SDARecoAmplitudeCalc::reduce(const JPetTask& clone) {
+	const SDARecoAmplitudeCalc& other = static_cast<const SDARecoAmplitudeCalc&>(clone);
+	fBadSignals += other.fBadSignals;
+	fCurrentEventNumber += other.fCurrentEventNumber;
+}
@@ -30,6 +30,9 @@ public:
 	virtual void init(const JPetTaskInterface::Options&)override;
 	virtual void terminate()override;
 	virtual void setWriter(JPetWriter* writer)override;
+	virtual ParallelMode getParallelMode() const override;
+	virtual JPetTask* cloneForThread() const override;
+	virtual void reduce(const JPetTask& clone) override;
 private:
 	int fBadSignals;
 	int fCurrentEventNumber;
@@ -33,8 +33,8 @@ void SDARecoChargeCalc::exec(){
 	if(auto signal = dynamic_cast<const JPetRecoSignal*const>(getEvent())){
 		double charge = JPetRecoSignalTools::calculateAreaFromStartingIndex(*signal);
 		if (charge == JPetRecoSignalTools::ERRORS::badCharge) {
-			WARNING( Form("Something went wrong when calculating charge for event: %d", fCurrentEventNumber) );
-			JPetRecoSignalTools::saveBadSignalIntoRootFile(*signal, fBadSignals, "badCharges.root");
+			WARNING( Form("Something went wrong when calculating charge for event: %lld", getFirstEventNumber() + fCurrentEventNumber) );
+			JPetRecoSignalTools::saveBadSignalIntoRootFile(*signal, getFirstEventNumber() + fBadSignals, "badCharges.root");
 			fBadSignals++;
 		}else{
 			auto signalWithCharge = *signal;
@@ -53,4 +53,14 @@ void SDARecoChargeCalc::terminate(){
 void SDARecoChargeCalc::setWriter(JPetWriter* writer){
 	fWriter=writer;
 }
-
+JPetTask::ParallelMode SDARecoChargeCalc::getParallelMode() const {
+	return kReducible;
+}
+JPetTask* SDARecoChargeCalc::cloneForThread() const {
+	return new SDARecoChargeCalc(GetName(), GetTitle());
+}
+void SDARecoChargeCalc::reduce(const JPetTask& clone) {
+	const SDARecoChargeCalc& other = static_cast<const SDARecoChargeCalc&>(clone);
+	fBadSignals += other.fBadSignals;
+	fCurrentEventNumber += other.fCurrentEventNumber;
+}
@@ -28,8 +28,8 @@ void SDARecoOffsetsCalc::exec(){
 	if(auto signal = dynamic_cast<const JPetRecoSignal*const>(getEvent())){
 		fOffset = JPetRecoSignalTools::calculateOffset(*signal);
 		if ( fOffset == JPetRecoSignalTools::ERRORS::badOffset ) {
-			WARNING( Form("Problem with calculating fOffset for event: %d", fCurrentEventNumber) );
-			JPetRecoSignalTools::saveBadSignalIntoRootFile(*signal, fBadSignals, "badOffsets.root");
+			WARNING( Form("Problem with calculating fOffset for event: %lld", getFirstEventNumber() + fCurrentEventNumber) );
+			JPetRecoSignalTools::saveBadSignalIntoRootFile(*signal, getFirstEventNumber() + fBadSignals, "badOffsets.root");
 			fBadSignals++;
 		}else{
 			auto signalWithOffset = *signal;
@@ -49,3 +49,14 @@ void SDARecoOffsetsCalc::terminate()
 void SDARecoOffsetsCalc::setWriter(JPetWriter* writer) {
 	fWriter = writer;
 }
+JPetTask::ParallelMode SDARecoOffsetsCalc::getParallelMode() const {
+	return kReducible;
+}
+JPetTask* SDARecoOffsetsCalc::cloneForThread() const {
+	return new SDARecoOffsetsCalc(GetName(), GetTitle());
+}
+void SDARecoOffsetsCalc::reduce(const JPetTask& clone) {
+	const SDARecoOffsetsCalc& other = static_cast<const SDARecoOffsetsCalc&>(clone);
+	fBadSignals += other.fBadSignals;
+	fCurrentEventNumber += other.fCurrentEventNumber;
+}
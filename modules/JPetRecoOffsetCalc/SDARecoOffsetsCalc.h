@@ -30,6 +30,9 @@ public:
 	virtual void exec()override;
 	virtual void terminate()override;
 	virtual void setWriter(JPetWriter* writer)override;
+	virtual ParallelMode getParallelMode() const override;
+	virtual JPetTask* cloneForThread() const override;
+	virtual void reduce(const JPetTask& clone) override;
 private:
 	JPetWriter* fWriter;
 	int fCurrentEventNumber;
@@ -23,9 +23,12 @@
 #include <TLegend.h>
 #include <TLine.h>
 #include <TUnixSystem.h>
+#include <TThread.h>
 
 void JPetRecoSignalTools::saveBadSignalIntoRootFile(const JPetRecoSignal& signal, const int numberOfBadSignals, const std::string fileName)
 {
+  // the tasks processing the events in parallel share the file
+  TThread::Lock();
   TCanvas* c1 = new TCanvas();
   TGraph* badSignal = JPetRecoSignalTools::plotJPetRecoSignal(signal);
   badSignal->Draw("AP");
@@ -46,6 +49,7 @@ void JPetRecoSignalTools::saveBadSignalIntoRootFile(const JPetRecoSignal& signal
   delete badSignal;
   delete c1;
   outFile->Close();
+  TThread::UnLock();
 }
 
 void JPetRecoSignalTools::savePNGOfBadSignal(const JPetRecoSignal& signal, int numberOfBadSignals)